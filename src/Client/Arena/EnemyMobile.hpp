@@ -9,6 +9,7 @@
 // includes
 #include "MobileActor.hpp"
 #include "Vector3.hpp"
+#include <ulib/Timer.hpp>
 
 // forward references
 class LocalModel;
@@ -26,13 +26,18 @@ void Game::Init()
 
    m_model.InitialUpdate(spPlayer);
 
+   std::vector<ObjectPtr> vecObjectsToAdd;
+
    // add opponent
    MobilePtr spEnemy(new Arena::EnemyMobile(m_model, Vector3d(15.0, 0.0, 10.0)));
-   m_model.GetObjectMap().AddObject(spEnemy);
+   vecObjectsToAdd.push_back(spEnemy);
 
    // add opponent
    MobilePtr spEnemy2(new Arena::EnemyMobile(m_model, Vector3d(10.0, 0.0, 15.0)));
-   m_model.GetObjectMap().AddObject(spEnemy2);
+   vecObjectsToAdd.push_back(spEnemy2);
+
+   // also adds the opponents to the model's movement
+   m_model.AddRemoveObject(vecObjectsToAdd, std::vector<ObjectId>());
 }
 
 void Game::OnTick()
@@ -41,7 +46,7 @@ void Game::OnTick()
       return;
 
    // do model tick
-   m_model.Tick(m_timeBase.Now());
+   m_model.Tick(m_model.GetTimeBase().Now());
 
    m_tickTimer.Restart();
 }
@@ -9,7 +9,6 @@
 // includes
 #include "LocalModel.hpp"
 #include <ulib/Timer.hpp>
-#include "TimeBase.hpp"
 #include "VirtualFileSystem.hpp"
 
 /// Arena is a test game that integrates all components in the project
@@ -42,9 +41,6 @@ private:
    /// tick timer
    Timer m_tickTimer;
 
-   /// time base
-   TimeBase m_timeBase;
-
    /// file system
    VirtualFileSystem m_fileSystem;
 };
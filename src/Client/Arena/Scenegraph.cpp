@@ -78,11 +78,11 @@ void Scenegraph::UpdatePlayer(const Player& player)
 void Scenegraph::InitMobiles()
 {
    const ObjectMap& objMap = m_viewModel.GetObjectMap();
-   ObjectMap::T_mapObjects::const_iterator iter = objMap.GetMap().begin();
-   ObjectMap::T_mapObjects::const_iterator stop = objMap.GetMap().end();
+   ObjectMap::const_iterator iter = objMap.begin();
+   ObjectMap::const_iterator stop = objMap.end();
 
    for (; iter != stop; ++iter)
-      AddMobile(std::dynamic_pointer_cast<Mobile>(iter->second));
+      AddMobile(std::dynamic_pointer_cast<Mobile>(*iter));
 }
 
 void Scenegraph::InitPlayer()
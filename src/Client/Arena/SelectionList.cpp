@@ -79,18 +79,18 @@ void SelectionList::Update(const Vector3d& vCurrentPos, const ObjectMap& objMap,
 
    m_vecSelectionList.clear();
 
-   ObjectMap::const_iterator iter = objMap.GetMap().begin();
-   ObjectMap::const_iterator stop = objMap.GetMap().end();
+   ObjectMap::const_iterator iter = objMap.begin();
+   ObjectMap::const_iterator stop = objMap.end();
 
    size_t uiLastSelected = std::numeric_limits<size_t>::max();
-   for (; iter != stop; --iter)
+   for (; iter != stop; ++iter)
    {
-      ATLASSERT(iter->second != NULL);
+      ATLASSERT(*iter != NULL);
 
-      const ObjectId& objId = iter->first;
+      const Object& obj = **iter;
+      const ObjectId& objId = obj.Id();
 
       // check length
-      const Object& obj = *(iter->second);
       Vector3d vDist = vCurrentPos - obj.Pos();
       if (vDist.Length() > dMaxDistance)
          continue;
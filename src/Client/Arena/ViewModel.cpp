@@ -94,7 +94,7 @@ void ViewModel::SetPlayerTransparency(double dTransparency)
 
 void ViewModel::UpdatePlayerMovement(const MovementInfo& movementInfo)
 {
-   GetPlayer()->UpdateMovementInfo(movementInfo);
+   GetLocalModel().UpdatePlayerMovement(movementInfo);
 
    // update view
    UpdatePlayerEvent().Call(*GetPlayer().get());
@@ -102,7 +102,8 @@ void ViewModel::UpdatePlayerMovement(const MovementInfo& movementInfo)
 
 void ViewModel::UpdatePlayerPos()
 {
-   GetPlayer()->Move();
+   // the model moves the player along with all other mobiles
+   GetLocalModel().UpdatePositions();
 
    // update view
    UpdatePlayerEvent().Call(*GetPlayer().get());
@@ -16,6 +16,7 @@
 #include "IPlayerViewModel.hpp"
 #include "PerspectiveCamera.hpp"
 #include "ISceneManager.hpp"
+#include <ulib/Timer.hpp>
 #include <SDL.h>
 
 /// view angle rotate speed using keyboard, in degrees/second
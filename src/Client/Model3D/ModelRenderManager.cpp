@@ -108,10 +108,10 @@ void ModelRenderManager::UpdateMobilesToRender(const ObjectMap& objectMap)
 
    for (; iter != stop; ++iter)
    {
-      ObjectRef objRef = objectMap.FindObject(iter->first);
-      ATLASSERT(objRef.m_sp != NULL);
+      const ObjectPtr& spObj = objectMap.Get(iter->first);
+      ATLASSERT(spObj != NULL);
 
-      MobilePtr spMobile = std::dynamic_pointer_cast<Mobile>(objRef.m_sp);
+      MobilePtr spMobile = std::dynamic_pointer_cast<Mobile>(spObj);
       ATLASSERT(spMobile != NULL);
 
       std::shared_ptr<ModelRenderInstance> spRenderInstance = iter->second;
@@ -0,0 +1,15 @@
+--
+-- MultiplayerOnlineGame - multiplayer game project
+-- Copyright (C) 2008-2014 Michael Fink
+--
+-- 0002: Object state table
+--
+
+-- object state; written by the server's persistence queue
+create table object_state (
+   'uuid' text primary key not null,
+   'name' text not null,
+   'pos' text not null,
+   'direction' integer not null,
+   'health' integer
+);
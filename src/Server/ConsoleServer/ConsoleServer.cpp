@@ -23,7 +23,7 @@ void ConsoleServer::Run(const ConsoleServerProgramOptions& opt)
 
    try
    {
-      m_upGameServer.reset(new GameServer(opt.Port()));
+      m_upGameServer.reset(new GameServer(opt.Port(), opt.NumIoThreads()));
 
       m_upGameServer->Run();
 
@@ -16,7 +16,8 @@ class ConsoleServerProgramOptions: public ProgramOptions
 public:
    /// ctor
    ConsoleServerProgramOptions()
-      :m_usPort(c_usDefaultServerPort)
+      :m_usPort(c_usDefaultServerPort),
+       m_uiNumIoThreads(0)
    {
       RegisterOutputHandler(&ProgramOptions::OutputConsole);
       RegisterHelpOption();
@@ -27,11 +28,19 @@ public:
       ProgramOptions::T_fnOptionHandlerSingleArg fn =
          std::bind(&ConsoleServerProgramOptions::ParsePort, this, std::placeholders::_1);
       RegisterOption(_T("p"), _T("port"), cszDescription, fn);
+
+      ProgramOptions::T_fnOptionHandlerSingleArg fnThreads =
+         std::bind(&ConsoleServerProgramOptions::ParseNumIoThreads, this, std::placeholders::_1);
+      RegisterOption(_T("t"), _T("threads"),
+         _T("Number of io threads for client sessions (default: one per processor core)"), fnThreads);
    }
 
    /// returns port
    unsigned short Port() const { return m_usPort; }
 
+   /// returns number of io threads; 0 means one per processor core
+   unsigned int NumIoThreads() const { return m_uiNumIoThreads; }
+
 private:
    /// parses port
    bool ParsePort(const CString& cszPort)
@@ -44,6 +53,18 @@ private:
       return true;
    }
 
+   /// parses number of io threads
+   bool ParseNumIoThreads(const CString& cszNumThreads)
+   {
+      unsigned long ulNumThreads = _tcstoul(cszNumThreads, NULL, 10);
+      if (ulNumThreads == 0 || ulNumThreads > 256)
+         return false;
+
+      m_uiNumIoThreads = static_cast<unsigned int>(ulNumThreads);
+      return true;
+   }
+
 private:
    unsigned short m_usPort; ///< port
+   unsigned int m_uiNumIoThreads; ///< number of io threads
 };
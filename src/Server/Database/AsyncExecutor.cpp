@@ -0,0 +1,52 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file AsyncExecutor.cpp Asynchronous database query executor
+//
+
+// includes
+#include "stdafx.h"
+#include "AsyncExecutor.hpp"
+
+using namespace Database;
+
+AsyncExecutor::AsyncExecutor(IDatabasePtr spWriteDatabase, const std::vector<IDatabasePtr>& vecReadDatabases)
+:m_upWriteConnection(new Connection(spWriteDatabase))
+{
+   for (size_t i=0, iMax=vecReadDatabases.size(); i<iMax; i++)
+      m_vecReadConnections.push_back(std::unique_ptr<Connection>(new Connection(vecReadDatabases[i])));
+}
+
+AsyncExecutor::~AsyncExecutor()
+{
+   // read connections are destroyed first; queries already queued there are still run
+   m_vecReadConnections.clear();
+   m_upWriteConnection.reset();
+}
+
+size_t AsyncExecutor::QueueSize() const
+{
+   size_t uiQueueSize = m_upWriteConnection->m_workerThread.QueueSize();
+
+   for (size_t i=0, iMax=m_vecReadConnections.size(); i<iMax; i++)
+      uiQueueSize += m_vecReadConnections[i]->m_workerThread.QueueSize();
+
+   return uiQueueSize;
+}
+
+AsyncExecutor::Connection& AsyncExecutor::SelectReadConnection()
+{
+   if (m_vecReadConnections.empty())
+      return *m_upWriteConnection;
+
+   size_t uiSelected = 0;
+   for (size_t i=1, iMax=m_vecReadConnections.size(); i<iMax; i++)
+   {
+      if (m_vecReadConnections[i]->m_workerThread.QueueSize() <
+          m_vecReadConnections[uiSelected]->m_workerThread.QueueSize())
+         uiSelected = i;
+   }
+
+   return *m_vecReadConnections[uiSelected];
+}
@@ -0,0 +1,111 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file AsyncExecutor.hpp Asynchronous database query executor
+//
+#pragma once
+
+// includes
+#include "DatabaseCommon.hpp"
+#include "IDatabaseInterface.hpp"
+#include "StatementCache.hpp"
+#include "ThreadPool.hpp"
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace Database
+{
+
+/// \brief executes database queries on worker threads
+/// \details The executor owns one connection for writing and a number of
+/// connections for reading. Each connection has its own worker thread and
+/// statement cache, so that a connection is only ever used by one thread.
+/// Write queries are executed one after another, in the order they were
+/// queued; read queries are distributed to the read connection with the
+/// fewest queued queries. Query functions get the statement cache of the
+/// connection they run on; the result of the query function (or an exception
+/// that it throws) is returned through a future.
+class DATABASE_DECLSPEC AsyncExecutor: public boost::noncopyable
+{
+public:
+   /// ctor; when no read connections are passed, read queries use the write connection
+   AsyncExecutor(IDatabasePtr spWriteDatabase, const std::vector<IDatabasePtr>& vecReadDatabases);
+
+   /// dtor; waits for all queued queries to finish
+   ~AsyncExecutor();
+
+   /// queues query that only reads from the database
+   template <typename T>
+   std::future<T> QueueRead(std::function<T(StatementCache&)> fnQuery)
+   {
+      return QueueQuery(SelectReadConnection(), fnQuery);
+   }
+
+   /// queues query that modifies the database
+   template <typename T>
+   std::future<T> QueueWrite(std::function<T(StatementCache&)> fnQuery)
+   {
+      return QueueQuery(*m_upWriteConnection, fnQuery);
+   }
+
+   /// returns number of queued queries that weren't started yet
+   size_t QueueSize() const;
+
+private:
+   /// database connection with worker thread
+   struct Connection
+   {
+      /// ctor
+      Connection(IDatabasePtr spDatabase)
+         :m_statementCache(spDatabase),
+          m_workerThread(1)
+      {
+      }
+
+      /// statement cache; only used on worker thread
+      StatementCache m_statementCache;
+
+      /// worker thread; declared last, so that it is joined before the cache is destroyed
+      ThreadPool m_workerThread;
+   };
+
+   /// returns read connection with the fewest queued queries
+   Connection& SelectReadConnection();
+
+   /// queues query on given connection
+   template <typename T>
+   static std::future<T> QueueQuery(Connection& connection, std::function<T(StatementCache&)> fnQuery)
+   {
+      StatementCache& statementCache = connection.m_statementCache;
+
+      // packaged_task can't be copied, but ThreadPool work functions must be
+      std::shared_ptr<std::packaged_task<T()>> spTask =
+         std::make_shared<std::packaged_task<T()>>([fnQuery, &statementCache]()
+      {
+         struct ResetStatements
+         {
+            ~ResetStatements() { m_statementCache.ResetAll(); }
+            StatementCache& m_statementCache;
+         } resetStatements = { statementCache };
+
+         return fnQuery(statementCache);
+      });
+
+      std::future<T> result = spTask->get_future();
+
+      connection.m_workerThread.QueueWork([spTask]() { (*spTask)(); });
+
+      return result;
+   }
+
+private:
+   /// write connection
+   std::unique_ptr<Connection> m_upWriteConnection;
+
+   /// read connections
+   std::vector<std::unique_ptr<Connection>> m_vecReadConnections;
+};
+
+} // namespace Database
@@ -26,6 +26,8 @@ Manager::Manager()
 
 Manager::~Manager()
 {
+   // finishes all queued queries
+   m_upAsyncExecutor.reset();
 }
 
 void Manager::CreateDatabase(const CString& cszFilename)
@@ -40,6 +42,8 @@ void Manager::CreateDatabase(const CString& cszFilename)
 
    SetupDatabase();
    UpdateDatabase();
+
+   StartAsyncExecutor(cszFilename);
 }
 
 void Manager::OpenExisting(const CString& cszFilename)
@@ -58,6 +62,8 @@ void Manager::OpenExisting(const CString& cszFilename)
    LOG_INFO(cszMessage, Log::Server::Database);
 
    UpdateDatabase();
+
+   StartAsyncExecutor(cszFilename);
 }
 
 IDatabaseProviderPtr Manager::GetDatabaseProvider()
@@ -78,6 +84,30 @@ IDatabaseProviderPtr Manager::GetDatabaseProvider()
    return spProvider;
 }
 
+void Manager::StartAsyncExecutor(const CString& cszFilename)
+{
+   ATLASSERT(m_spDatabase != NULL);
+
+   // with write-ahead logging, readers don't block the writer and vice versa
+   if (!m_spDatabase->ExecuteDirect(_T("pragma journal_mode=WAL")))
+      LOG_WARN(_T("couldn't switch database to write-ahead logging: ") + m_spDatabase->GetLastError(),
+         Log::Server::Database);
+
+   IDatabaseProviderPtr spProvider = Database::IDatabaseProvider::GetProvider();
+   if (spProvider == nullptr)
+      throw Exception(_T("couldn't get database provider"), __FILE__, __LINE__);
+
+   std::vector<IDatabasePtr> vecReadDatabases;
+   for (unsigned int ui=0; ui<c_uiNumReadConnections; ui++)
+      vecReadDatabases.push_back(spProvider->Open(cszFilename));
+
+   m_upAsyncExecutor.reset(new AsyncExecutor(m_spDatabase, vecReadDatabases));
+
+   CString cszMessage;
+   cszMessage.Format(_T("started async database executor with %u read connections"), c_uiNumReadConnections);
+   LOG_INFO(cszMessage, Log::Server::Database);
+}
+
 void Manager::SetupDatabase()
 {
    ATLASSERT(m_spDatabase != NULL);
@@ -9,7 +9,9 @@
 // includes
 #include "DatabaseCommon.hpp"
 #include "IDatabaseInterface.hpp"
+#include "AsyncExecutor.hpp"
 #include <vector>
+#include <memory>
 
 // forward references
 namespace Database
@@ -29,6 +31,9 @@ namespace Database
    /// filename format for update scripts
    const TCHAR c_pszDatabaseUpdateScriptFilenameFormat[] = _T("%04u_%s.sql");
 
+   /// number of connections used for read queries by the async executor
+   const unsigned int c_uiNumReadConnections = 2;
+
    /// manages database access
    class DATABASE_DECLSPEC Manager
    {
@@ -46,12 +51,21 @@ namespace Database
       void OpenExisting(const CString& cszFilename);
 
       /// returns database instance; non-const version
+      /// \note the database instance is also used by the async executor's
+      /// write thread; prefer GetAsyncExecutor() for queries
       IDatabasePtr GetDatabase() const
       {
          ATLASSERT(m_spDatabase != NULL);
          return m_spDatabase;
       }
 
+      /// returns async executor; available after the database was created or opened
+      AsyncExecutor& GetAsyncExecutor()
+      {
+         ATLASSERT(m_upAsyncExecutor != nullptr);
+         return *m_upAsyncExecutor;
+      }
+
    private:
       /// returns database provider
       IDatabaseProviderPtr GetDatabaseProvider();
@@ -62,6 +76,9 @@ namespace Database
       /// updates database to latest version
       void UpdateDatabase();
 
+      /// starts async executor, using the opened database for writing
+      void StartAsyncExecutor(const CString& cszFilename);
+
       /// sets up internal tables
       void SetupInternalTables();
 
@@ -80,6 +97,9 @@ namespace Database
    private:
       /// database object
       IDatabasePtr m_spDatabase;
+
+      /// async executor; declared last, so that it's destroyed first
+      std::unique_ptr<AsyncExecutor> m_upAsyncExecutor;
    };
 
 } // namespace Database
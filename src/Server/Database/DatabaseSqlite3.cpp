@@ -15,6 +15,9 @@
 
 using namespace Database::Sqlite3;
 
+/// time to wait for a lock held by another connection, in milliseconds
+const int c_iBusyTimeoutMilliseconds = 5000;
+
 // DatabaseProvider
 
 Database::IDatabasePtr DatabaseProvider::Create(LPCTSTR pszFilename)
@@ -39,6 +42,9 @@ void DatabaseProvider::Info(CString& cszProviderName, CString& cszVersion)
 DatabaseSqlite3::DatabaseSqlite3(LPCTSTR pszFilename)
 {
    ATLVERIFY(SQLITE_OK == sqlite3_open16(pszFilename, &m_pDb));
+
+   // other connections to the same database may be in use on other threads
+   ATLVERIFY(SQLITE_OK == sqlite3_busy_timeout(m_pDb, c_iBusyTimeoutMilliseconds));
 }
 
 DatabaseSqlite3::~DatabaseSqlite3()
@@ -123,6 +129,38 @@ void Command::SetParam(unsigned int uiIndex, int iValue)
    ATLVERIFY(SQLITE_OK == sqlite3_bind_int(m_pStmt, uiIndex+1, iValue));
 }
 
+void Command::SetParam(unsigned int uiIndex, long long llValue)
+{
+   // 0-based index
+   ATLASSERT(uiIndex < GetParamCount());
+
+   // converting index to 1-based here
+   ATLVERIFY(SQLITE_OK == sqlite3_bind_int64(m_pStmt, uiIndex+1, llValue));
+}
+
+void Command::SetParam(unsigned int uiIndex, double dValue)
+{
+   // 0-based index
+   ATLASSERT(uiIndex < GetParamCount());
+
+   // converting index to 1-based here
+   ATLVERIFY(SQLITE_OK == sqlite3_bind_double(m_pStmt, uiIndex+1, dValue));
+}
+
+void Command::SetParam(unsigned int uiIndex, const std::vector<unsigned char>& vecData)
+{
+   // 0-based index
+   ATLASSERT(uiIndex < GetParamCount());
+
+   // an empty vector has no data pointer, but must still be bound as blob, not as null
+   static const unsigned char c_emptyBlob = 0;
+   const void* pData = vecData.empty() ? &c_emptyBlob : &vecData[0];
+
+   // converting index to 1-based here
+   ATLVERIFY(SQLITE_OK == sqlite3_bind_blob(m_pStmt, uiIndex+1, pData,
+      static_cast<int>(vecData.size()), SQLITE_TRANSIENT));
+}
+
 bool Command::Execute(Database::IResultSetPtr& spResultSet)
 {
    int iRet = sqlite3_step(m_pStmt);
@@ -189,20 +227,83 @@ void ResultSet::GetValue(unsigned int uiIndex, int& iValue)
    iValue = sqlite3_column_int(GetStatement(), uiIndex);
 }
 
+void ResultSet::GetValue(unsigned int uiIndex, long long& llValue)
+{
+   ATLASSERT(GetStatement() != NULL);
+   ATLASSERT(uiIndex < GetColumnCount()); // already 0-based index
+
+   llValue = sqlite3_column_int64(GetStatement(), uiIndex);
+}
+
+void ResultSet::GetValue(unsigned int uiIndex, double& dValue)
+{
+   ATLASSERT(GetStatement() != NULL);
+   ATLASSERT(uiIndex < GetColumnCount()); // already 0-based index
+
+   dValue = sqlite3_column_double(GetStatement(), uiIndex);
+}
+
+void ResultSet::GetValue(unsigned int uiIndex, std::vector<unsigned char>& vecData)
+{
+   Database::BlobView blob = GetBlob(uiIndex);
+
+   vecData.assign(blob.m_pData, blob.m_pData + blob.m_uiSize);
+}
+
+Database::BlobView ResultSet::GetBlob(unsigned int uiIndex)
+{
+   ATLASSERT(GetStatement() != NULL);
+   ATLASSERT(uiIndex < GetColumnCount()); // already 0-based index
+
+   // must be called before sqlite3_column_bytes(), since the data pointer may be invalidated by it
+   const unsigned char* pData = static_cast<const unsigned char*>(sqlite3_column_blob(GetStatement(), uiIndex));
+   int iSize = sqlite3_column_bytes(GetStatement(), uiIndex);
+
+   return Database::BlobView(pData, pData == nullptr ? 0 : static_cast<size_t>(iSize));
+}
+
+Database::EColumnType ResultSet::GetColumnType(unsigned int uiIndex)
+{
+   ATLASSERT(GetStatement() != NULL);
+   ATLASSERT(uiIndex < GetColumnCount()); // already 0-based index
+
+   switch (sqlite3_column_type(GetStatement(), uiIndex))
+   {
+   case SQLITE_INTEGER: return Database::columnTypeInteger;
+   case SQLITE_FLOAT:   return Database::columnTypeFloat;
+   case SQLITE_TEXT:    return Database::columnTypeText;
+   case SQLITE_BLOB:    return Database::columnTypeBlob;
+   default:
+      ATLASSERT(false);
+      // fall-through
+   case SQLITE_NULL:    return Database::columnTypeNull;
+   }
+}
+
 bool ResultSet::MoveNext()
 {
    ATLASSERT(GetStatement() != NULL);
 
+   // stepping again would restart the statement
+   if (m_bAtEnd)
+      return false;
+
    int iRet = sqlite3_step(GetStatement());
 
    ATLASSERT(iRet != SQLITE_BUSY);
 
    // error
    if (iRet == SQLITE_MISUSE || iRet == SQLITE_ERROR)
+   {
+      m_bAtEnd = true;
       return false;
+   }
 
    if (iRet == SQLITE_DONE)
+   {
+      m_bAtEnd = true;
       return false;
+   }
 
    ATLASSERT(SQLITE_ROW == iRet);
 
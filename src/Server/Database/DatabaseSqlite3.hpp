@@ -68,6 +68,9 @@ public:
    virtual void SetParamNull(unsigned int uiIndex) override;
    virtual void SetParam(unsigned int uiIndex, const CString& cszText) override;
    virtual void SetParam(unsigned int uiIndex, int iValue) override;
+   virtual void SetParam(unsigned int uiIndex, long long llValue) override;
+   virtual void SetParam(unsigned int uiIndex, double dValue) override;
+   virtual void SetParam(unsigned int uiIndex, const std::vector<unsigned char>& vecData) override;
 
    virtual bool Execute(Database::IResultSetPtr& spResultSet) override;
 
@@ -95,7 +98,8 @@ class ResultSet: public Database::IResultSet
 public:
    /// ctor
    ResultSet(std::shared_ptr<Command> spCommand)
-      :m_spCommand(spCommand)
+      :m_spCommand(spCommand),
+       m_bAtEnd(false)
    {
    }
 
@@ -106,15 +110,27 @@ public:
 
    virtual void GetValue(unsigned int uiIndex, CString& cszText) override;
    virtual void GetValue(unsigned int uiIndex, int& iValue) override;
+   virtual void GetValue(unsigned int uiIndex, long long& llValue) override;
+   virtual void GetValue(unsigned int uiIndex, double& dValue) override;
+   virtual void GetValue(unsigned int uiIndex, std::vector<unsigned char>& vecData) override;
+
+   virtual Database::BlobView GetBlob(unsigned int uiIndex) override;
+
+   virtual Database::EColumnType GetColumnType(unsigned int uiIndex) override;
 
    virtual bool MoveNext() override;
 
+   virtual bool AtEnd() const override { return m_bAtEnd; }
+
    /// returns db statement instance
    sqlite3_stmt* GetStatement() const { return m_spCommand->GetStatement(); }
 
 private:
    /// command instance
    std::shared_ptr<Command> m_spCommand;
+
+   /// indicates if MoveNext() moved past the last result
+   bool m_bAtEnd;
 };
 
 } // namespace Sqlite3
@@ -8,6 +8,7 @@
 
 // includes
 #include <memory>
+#include <vector>
 
 /// \brief database access
 namespace Database
@@ -73,6 +74,35 @@ public:
 
 class IResultSet;
 
+/// column value type of a result row
+enum EColumnType
+{
+   columnTypeNull=0, ///< null value
+   columnTypeInteger,///< integer value
+   columnTypeFloat,  ///< floating point value
+   columnTypeText,   ///< text value
+   columnTypeBlob,   ///< blob value
+};
+
+/// \brief view on blob data of a result column
+/// \details the data is owned by the result set; it's only valid until the
+/// result set moves to the next row or the command is reset
+struct BlobView
+{
+   /// ctor
+   BlobView(const unsigned char* pData = nullptr, size_t uiSize = 0)
+      :m_pData(pData),
+       m_uiSize(uiSize)
+   {
+   }
+
+   /// pointer to blob data; may be nullptr for empty blobs
+   const unsigned char* m_pData;
+
+   /// size of blob data, in bytes
+   size_t m_uiSize;
+};
+
 /// smart pointer type for IResultSet
 typedef std::shared_ptr<IResultSet> IResultSetPtr;
 
@@ -96,6 +126,15 @@ public:
    /// sets integer parameter
    virtual void SetParam(unsigned int uiIndex, int iValue) = 0;
 
+   /// sets 64-bit integer parameter
+   virtual void SetParam(unsigned int uiIndex, long long llValue) = 0;
+
+   /// sets floating point parameter
+   virtual void SetParam(unsigned int uiIndex, double dValue) = 0;
+
+   /// sets blob parameter; the data is copied
+   virtual void SetParam(unsigned int uiIndex, const std::vector<unsigned char>& vecData) = 0;
+
    /// executes prepared statement
    virtual bool Execute(IResultSetPtr& spResultSet) = 0;
 
@@ -123,8 +162,46 @@ public:
    /// returns integer result value
    virtual void GetValue(unsigned int uiIndex, int& iValue) = 0;
 
+   /// returns 64-bit integer result value
+   virtual void GetValue(unsigned int uiIndex, long long& llValue) = 0;
+
+   /// returns floating point result value
+   virtual void GetValue(unsigned int uiIndex, double& dValue) = 0;
+
+   /// returns blob result value, as copy
+   virtual void GetValue(unsigned int uiIndex, std::vector<unsigned char>& vecData) = 0;
+
+   /// returns blob result value, without copying; see BlobView for validity
+   virtual BlobView GetBlob(unsigned int uiIndex) = 0;
+
+   /// returns type of result value in current row
+   virtual EColumnType GetColumnType(unsigned int uiIndex) = 0;
+
    /// moves to next result; returns false when no more results are available
    virtual bool MoveNext() = 0;
+
+   /// returns if MoveNext() moved past the last result
+   virtual bool AtEnd() const = 0;
+
+   /// \brief reads rows into array of structs
+   /// \details Starts with the current row; for every row, fnReadRow is
+   /// called with the result set and the struct to fill, and the result set
+   /// is moved to the next row. Returns the number of rows read; less than
+   /// uiMaxRows rows are read when the end of the results is reached.
+   /// \tparam T type of struct that stores a row
+   /// \tparam TFunc function type with signature void(IResultSet&, T&)
+   template <typename T, typename TFunc>
+   unsigned int FetchRows(T* pRows, unsigned int uiMaxRows, TFunc fnReadRow)
+   {
+      unsigned int uiNumRows = 0;
+      while (uiNumRows < uiMaxRows && !AtEnd())
+      {
+         fnReadRow(*this, pRows[uiNumRows++]);
+         MoveNext();
+      }
+
+      return uiNumRows;
+   }
 };
 
 } // namespace Database
@@ -0,0 +1,72 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file StatementCache.hpp Prepared statement cache
+//
+#pragma once
+
+// includes
+#include "IDatabaseInterface.hpp"
+#include <map>
+#include <boost/noncopyable.hpp>
+
+namespace Database
+{
+
+/// \brief cache for prepared statements of a database connection
+/// \details Statements are prepared once and then reused, keyed by their sql
+/// text. Since prepared statements belong to a connection, the cache may only
+/// be used by one thread at a time. A statement returned by Get() must not be
+/// used anymore when Get() is called again with the same sql text.
+class StatementCache: public boost::noncopyable
+{
+public:
+   /// ctor
+   explicit StatementCache(IDatabasePtr spDatabase)
+      :m_spDatabase(spDatabase)
+   {
+   }
+
+   /// returns prepared statement for given sql command; parameters of a
+   /// reused statement keep their last set values
+   ICommandPtr Get(LPCTSTR pszCommandText)
+   {
+      T_mapCommands::iterator iter = m_mapCommands.find(pszCommandText);
+      if (iter != m_mapCommands.end())
+      {
+         iter->second->Reset();
+         return iter->second;
+      }
+
+      ICommandPtr spCommand = m_spDatabase->OpenQuery(pszCommandText);
+      m_mapCommands.insert(std::make_pair(CString(pszCommandText), spCommand));
+
+      return spCommand;
+   }
+
+   /// resets all statements, so that they don't keep the database locked
+   void ResetAll()
+   {
+      for (T_mapCommands::iterator iter = m_mapCommands.begin(), stop = m_mapCommands.end(); iter != stop; ++iter)
+         iter->second->Reset();
+   }
+
+   /// returns number of cached statements
+   size_t Size() const { return m_mapCommands.size(); }
+
+   /// returns database connection
+   IDatabasePtr GetDatabase() const { return m_spDatabase; }
+
+private:
+   /// map type with sql text and prepared statement
+   typedef std::map<CString, ICommandPtr> T_mapCommands;
+
+   /// database connection
+   IDatabasePtr m_spDatabase;
+
+   /// prepared statements
+   T_mapCommands m_mapCommands;
+};
+
+} // namespace Database
@@ -13,15 +13,30 @@
 #include "SRPServerAuthModule.hpp"
 #include "StringTools.hpp"
 #include "IDatabaseInterface.hpp"
+#include "StatementCache.hpp"
 #include <functional>
 
 bool DatabaseAuthManager::IsAccountAvail(const CString& cszUsername)
 {
-   std::shared_ptr<Database::IDatabase> spDatabase = m_databaseManager.GetDatabase();
+   std::future<bool> result = m_databaseManager.GetAsyncExecutor().QueueRead<bool>(
+      std::bind(&DatabaseAuthManager::ReadIsAccountAvail, std::placeholders::_1, cszUsername));
 
+   return result.get();
+}
+
+Account DatabaseAuthManager::GetAccount(const CString& cszUsername)
+{
+   std::future<Account> result = m_databaseManager.GetAsyncExecutor().QueueRead<Account>(
+      std::bind(&DatabaseAuthManager::ReadAccount, std::placeholders::_1, cszUsername));
+
+   return result.get();
+}
+
+bool DatabaseAuthManager::ReadIsAccountAvail(Database::StatementCache& statementCache, const CString& cszUsername)
+{
    // select from database
    std::shared_ptr<Database::ICommand> spCommand =
-      spDatabase->OpenQuery(_T("select id from account where username=?"));
+      statementCache.Get(_T("select id from account where username=?"));
 
    ATLASSERT(1 == spCommand->GetParamCount());
 
@@ -42,13 +57,41 @@ bool DatabaseAuthManager::IsAccountAvail(const CString& cszUsername)
    return iId != 0;
 }
 
-Account DatabaseAuthManager::GetAccount(const CString& cszUsername)
+/// reads binary column; columns that still contain hex strings are converted
+static void ReadBinaryColumn(Database::IResultSet& resultSet, unsigned int uiIndex, std::vector<unsigned char>& vecData)
+{
+   if (resultSet.GetColumnType(uiIndex) == Database::columnTypeText)
+   {
+      CString cszHexText;
+      resultSet.GetValue(uiIndex, cszHexText);
+
+      vecData.clear();
+      StringTools::HexStringToBytes(cszHexText, vecData);
+   }
+   else
+      resultSet.GetValue(uiIndex, vecData);
+}
+
+Account DatabaseAuthManager::ReadAccount(Database::StatementCache& statementCache, const CString& cszUsername)
 {
-   std::shared_ptr<Database::IDatabase> spDatabase = m_databaseManager.GetDatabase();
+   ServerAuthInfo info = ReadServerAuthInfo(statementCache, cszUsername);
 
-   // insert into database
+   // create account object
+   Account a;
+   a.Username(cszUsername);
+   a.Password(StringTools::BytesToHexString(info.m_vecPasswordKey));
+   a.Salt(StringTools::BytesToHexString(info.m_vecSalt));
+   a.AccountId(info.m_iAccountId);
+
+   return a;
+}
+
+DatabaseAuthManager::ServerAuthInfo DatabaseAuthManager::ReadServerAuthInfo(
+   Database::StatementCache& statementCache, const CString& cszUsername)
+{
+   // select from database
    std::shared_ptr<Database::ICommand> spCommand =
-      spDatabase->OpenQuery(_T("select active, password, salt, id from account where username=?"));
+      statementCache.Get(_T("select active, password, salt, id from account where username=?"));
 
    ATLASSERT(1 == spCommand->GetParamCount());
    spCommand->SetParam(0, cszUsername);
@@ -65,26 +108,15 @@ Account DatabaseAuthManager::GetAccount(const CString& cszUsername)
    int iActive = 0;
    spResultSet->GetValue(0, iActive);
 
-   CString cszPassVerifier;
-   spResultSet->GetValue(1, cszPassVerifier);
-
-   CString cszSalt;
-   spResultSet->GetValue(2, cszSalt);
-
    if (iActive == 0)
       throw AuthException(AuthException::authInactiveUser, _T("account not active"), __FILE__, __LINE__);
 
-   int iAccountId = 0;
-   spResultSet->GetValue(3, iAccountId);
+   ServerAuthInfo info;
+   ReadBinaryColumn(*spResultSet, 1, info.m_vecPasswordKey);
+   ReadBinaryColumn(*spResultSet, 2, info.m_vecSalt);
+   spResultSet->GetValue(3, info.m_iAccountId);
 
-   // create account object
-   Account a;
-   a.Username(cszUsername);
-   a.Password(cszPassVerifier);
-   a.Salt(cszSalt);
-   a.AccountId(iAccountId);
-
-   return a;
+   return info;
 }
 
 std::shared_ptr<IServerAuthModule> DatabaseAuthManager::GetAuthenticationModule()
@@ -94,15 +126,18 @@ std::shared_ptr<IServerAuthModule> DatabaseAuthManager::GetAuthenticationModule(
       this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4);
 
    return std::shared_ptr<IServerAuthModule>(
-      new SRP::ServerAuthModule(fnGetServerAuthInfo));
+      new SRP::ServerAuthModule(fnGetServerAuthInfo, &m_authWorkerPool));
 }
 
 void DatabaseAuthManager::GetServerAuthInfo(const CString& cszUsername,
    std::vector<unsigned char>& vecPasswordKey, std::vector<unsigned char>& vecSalt, int& iAccountId)
 {
-   Account a = GetAccount(cszUsername);
+   std::future<ServerAuthInfo> result = m_databaseManager.GetAsyncExecutor().QueueRead<ServerAuthInfo>(
+      std::bind(&DatabaseAuthManager::ReadServerAuthInfo, std::placeholders::_1, cszUsername));
+
+   ServerAuthInfo info = result.get();
 
-   StringTools::HexStringToBytes(a.Password(), vecPasswordKey);
-   StringTools::HexStringToBytes(a.Salt(), vecSalt);
-   iAccountId = a.AccountId();
+   vecPasswordKey.swap(info.m_vecPasswordKey);
+   vecSalt.swap(info.m_vecSalt);
+   iAccountId = info.m_iAccountId;
 }
@@ -8,20 +8,26 @@
 
 // includes
 #include "IAuthManager.hpp"
+#include "ThreadPool.hpp"
 
 // forward references
 namespace Database
 {
 class Manager;
+class StatementCache;
 }
 
-/// authentication manager that uses database
+/// \brief authentication manager that uses database
+/// \details Authentication runs on a worker thread pool, so that logons don't
+/// block the session threads. Accounts are read using the database manager's
+/// async executor, with prepared statements that are reused for every logon.
 class DatabaseAuthManager: public IAuthManager
 {
 public:
    /// ctor
    DatabaseAuthManager(Database::Manager& databaseManager)
-      :m_databaseManager(databaseManager)
+      :m_databaseManager(databaseManager),
+       m_authWorkerPool(c_uiNumAuthWorkerThreads)
    {
    }
    /// dtor
@@ -39,13 +45,53 @@ private:
    /// returns authentication module for authentication manager
    virtual std::shared_ptr<IServerAuthModule> GetAuthenticationModule() override;
 
+   /// returns number of logons waiting to be processed
+   virtual size_t LogonQueueSize() const override
+   {
+      return m_authWorkerPool.QueueSize();
+   }
+
 private:
+   /// checks if account is available; runs on a database read connection
+   static bool ReadIsAccountAvail(Database::StatementCache& statementCache, const CString& cszUsername);
+
+   /// returns account info; runs on a database read connection
+   static Account ReadAccount(Database::StatementCache& statementCache, const CString& cszUsername);
+
+   /// server authentication info of an account
+   struct ServerAuthInfo
+   {
+      /// ctor
+      ServerAuthInfo()
+         :m_iAccountId(0)
+      {
+      }
+
+      /// password verifier
+      std::vector<unsigned char> m_vecPasswordKey;
+
+      /// password salt
+      std::vector<unsigned char> m_vecSalt;
+
+      /// account id
+      int m_iAccountId;
+   };
+
+   /// returns server authentication info, read from binary columns; runs on a database read connection
+   static ServerAuthInfo ReadServerAuthInfo(Database::StatementCache& statementCache, const CString& cszUsername);
+
    /// returns server authentication info
    void GetServerAuthInfo(const CString& cszUsername,
       std::vector<unsigned char>& vecPasswordKey, std::vector<unsigned char>& vecSalt,
       int& iAccountId);
 
 private:
+   /// number of worker threads to authenticate logons
+   static const unsigned int c_uiNumAuthWorkerThreads = 2;
+
    /// database manager
    Database::Manager& m_databaseManager;
+
+   /// worker pool to authenticate logons on
+   ThreadPool m_authWorkerPool;
 };
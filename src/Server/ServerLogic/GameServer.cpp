@@ -14,17 +14,21 @@
 #include "Filesystem.hpp"
 #include <ulib/Path.hpp>
 
-GameServer::GameServer(unsigned short usPort)
+GameServer::GameServer(unsigned short usPort, unsigned int uiNumIoThreads)
 :m_evtStop(false),
  m_evtStopped(false),
- m_sessionManager(m_authManager, m_worldModel, m_ioService.Get()),
- m_networkManager(m_sessionManager, m_ioService.Get(), usPort),
- m_actionQueue(m_ioService.Get(), m_worldModel),
- m_worldRunner(m_worldModel),
- m_worldModel(m_sessionManager, m_actionQueue)
+ m_ioServicePool(uiNumIoThreads, _T("Session Thread")),
+ m_sessionManager(m_authManager, m_worldModel, m_ioServicePool),
+ m_networkManager(m_sessionManager, m_metricsManager, m_ioService.Get(), usPort),
+ m_actionQueue(m_ioService.Get(), m_worldModel, &m_metricsManager),
+ m_worldRunner(m_worldModel, m_metricsManager),
+ m_worldModel(m_sessionManager, m_actionQueue, m_databaseManager, m_metricsManager)
 {
    InitDatabase();
 
+   m_metricsManager.Config(Metrics::DataBytesTx, storeTypeAccumulated);
+   m_metricsManager.Config(Metrics::MessagesTx, storeTypeAccumulated);
+
    // add static account
    Account a;
    a.Username(_T("michi"));
@@ -59,16 +63,22 @@ void GameServer::Run()
    m_worldRunner.Start();
    m_networkManager.Start();
 
-   // run io service in another thread
+   // run io services in other threads
    m_ioService.Run();
+   m_ioServicePool.Run();
+
+   CString cszText;
+   cszText.Format(_T("Running sessions on %u io threads"), static_cast<unsigned int>(m_ioServicePool.Size()));
+   LOG_INFO(cszText, Log::Server::General);
 
    // wait for stop signal
    m_evtStop.Wait();
 
-   // now stop all objects that use the IoServiceThread
+   // now stop all objects that use the IoServiceThread and the pool
    m_networkManager.Stop();
    m_worldRunner.Stop();
 
+   m_ioServicePool.Join();
    m_ioService.Join();
 
    m_evtStopped.Set();
@@ -81,6 +91,7 @@ void GameServer::Stop()
    m_worldRunner.Stop();
 
    m_ioService.Get().stop();
+   m_ioServicePool.Stop();
 
    m_evtStopped.Wait();
 }
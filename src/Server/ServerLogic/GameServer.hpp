@@ -10,9 +10,11 @@
 #include "ServerLogic.hpp"
 #include <ulib/thread/Event.hpp>
 #include "IoServiceThread.hpp"
+#include "IoServicePool.hpp"
 #include "DatabaseManager.hpp"
 #include "NetworkManager.hpp"
 #include "SessionManager.hpp"
+#include "MetricsManager.hpp"
 #include "StaticAccountAuthManager.hpp"
 #include "AsyncActionQueue.hpp"
 #include "WorldModel.hpp"
@@ -24,8 +26,8 @@
 class SERVERLOGIC_DECLSPEC GameServer
 {
 public:
-   /// ctor
-   GameServer(unsigned short usPort);
+   /// ctor; a number of io threads of 0 uses one thread per processor core
+   GameServer(unsigned short usPort, unsigned int uiNumIoThreads = 0);
    /// dtor
    virtual ~GameServer();
 
@@ -51,9 +53,12 @@ private:
 
    // game objects
 
-   /// ioservice thread
+   /// ioservice thread; used for socket listeners, timers and action queue
    IoServiceThread m_ioService;
 
+   /// pool of ioservice threads that sessions are distributed on
+   IoServicePool m_ioServicePool;
+
    /// database manager
    Database::Manager m_databaseManager;
 
@@ -63,6 +68,9 @@ private:
    /// session manager
    SessionManager m_sessionManager;
 
+   /// server metrics
+   MetricsManager m_metricsManager;
+
    /// network manager
    NetworkManager m_networkManager;
 
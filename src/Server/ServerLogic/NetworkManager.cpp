@@ -13,9 +13,10 @@
 /// client's server session cleanup interval, in seconds
 const unsigned int c_uiCleanupClientIntervalSec = 10;
 
-NetworkManager::NetworkManager(SessionManager& sessionManager,
+NetworkManager::NetworkManager(SessionManager& sessionManager, MetricsManager& metricsManager,
    boost::asio::io_service& ioService, unsigned short usPort)
 :m_sessionManager(sessionManager),
+ m_metricsManager(metricsManager),
  m_socketListenerIPv4(sessionManager, ioService, false, usPort),
  m_socketListenerIPv6(sessionManager, ioService, true, usPort),
  m_timerCleanupClients(ioService),
@@ -59,5 +60,7 @@ void NetworkManager::OnTimerCleanupClients(const boost::system::error_code& erro
    // do cleanup
    m_sessionManager.Cleanup();
 
+   m_sessionManager.CollectMetrics(m_metricsManager);
+
    RestartTimer();
 }
@@ -12,6 +12,7 @@
 
 // forward references
 class SessionManager;
+class MetricsManager;
 
 /// \brief network manager
 /// \details manages the network side of running the game server
@@ -19,7 +20,8 @@ class NetworkManager
 {
 public:
    /// ctor
-   NetworkManager(SessionManager& sessionManager, boost::asio::io_service& ioService, unsigned short usPort);
+   NetworkManager(SessionManager& sessionManager, MetricsManager& metricsManager,
+      boost::asio::io_service& ioService, unsigned short usPort);
 
    /// starts network manager
    void Start();
@@ -31,13 +33,16 @@ private:
    /// (re)starts timer to clean up clients
    void RestartTimer();
 
-   /// timer handler to clean up clients
+   /// timer handler to clean up clients and collect metrics
    void OnTimerCleanupClients(const boost::system::error_code& error);
 
 private:
    /// session manager
    SessionManager& m_sessionManager;
 
+   /// metrics manager
+   MetricsManager& m_metricsManager;
+
    /// IPv4 socket listener
    SocketListener m_socketListenerIPv4;
 
@@ -0,0 +1,215 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file PersistenceQueue.cpp Write-behind queue for world object state
+//
+
+// includes
+#include "StdAfx.h"
+#include "PersistenceQueue.hpp"
+#include "Mobile.hpp"
+#include "MovementInfo.hpp"
+#include "DatabaseManager.hpp"
+#include "StatementCache.hpp"
+#include "Transaction.hpp"
+#include <functional>
+#include <chrono>
+
+const double PersistenceQueue::c_dFlushInterval = 5.0;
+
+PersistenceQueue::PersistenceQueue(Database::Manager& databaseManager)
+:m_databaseManager(databaseManager)
+{
+}
+
+PersistenceQueue::~PersistenceQueue()
+{
+   // write all remaining states, and wait until they're written
+   CheckLastWrite(true);
+   Flush();
+   CheckLastWrite(true);
+}
+
+void PersistenceQueue::QueueObject(const ObjectPtr& spObj)
+{
+   Queue(GetObjectState(spObj));
+}
+
+void PersistenceQueue::QueueMovement(const ObjectPtr& spObj, const MovementInfo& info)
+{
+   ObjectState state = GetObjectState(spObj);
+   state.m_vPos = info.Position();
+   state.m_dDirection = info.Direction();
+
+   Queue(state);
+}
+
+void PersistenceQueue::Tick(const TimeIndex& timeIndex)
+{
+   if (timeIndex.Get() - m_lastFlush.Get() < c_dFlushInterval)
+      return;
+
+   m_lastFlush = timeIndex;
+
+   Flush();
+}
+
+void PersistenceQueue::Flush()
+{
+   RecursiveMutex::LockType lock(m_mtxQueue);
+
+   if (!CheckLastWrite(false))
+      return; // still writing; states stay queued until the next flush
+
+   if (m_mapQueuedStates.empty())
+      return;
+
+   m_vecWritingStates.reserve(m_mapQueuedStates.size());
+
+   std::map<ObjectId, ObjectState>::const_iterator iter = m_mapQueuedStates.begin(),
+      stop = m_mapQueuedStates.end();
+   for (; iter != stop; ++iter)
+      m_vecWritingStates.push_back(iter->second);
+
+   m_mapQueuedStates.clear();
+
+   m_futureLastWrite = m_databaseManager.GetAsyncExecutor().QueueWrite<void>(
+      std::bind(&PersistenceQueue::WriteObjectStates, std::placeholders::_1, m_vecWritingStates));
+}
+
+size_t PersistenceQueue::QueueSize() const
+{
+   RecursiveMutex::LockType lock(m_mtxQueue);
+   return m_mapQueuedStates.size();
+}
+
+PersistenceQueue::ObjectState PersistenceQueue::GetObjectState(const ObjectPtr& spObj)
+{
+   // the world tick writes the position of the object while it's locked
+   Lockable::LockType lock = spObj->Lock();
+
+   ObjectState state(spObj->Id());
+   state.m_cszName = spObj->Name();
+   state.m_vPos = spObj->Pos();
+
+   std::shared_ptr<Mobile> spMobile = std::dynamic_pointer_cast<Mobile>(spObj);
+   if (spMobile != nullptr)
+   {
+      state.m_dDirection = spMobile->GetMovementInfo().Direction();
+      state.m_iHealthPoints = static_cast<int>(spMobile->HealthPoints());
+   }
+
+   return state;
+}
+
+void PersistenceQueue::Queue(const ObjectState& state)
+{
+   bool bFlush = false;
+
+   {
+      RecursiveMutex::LockType lock(m_mtxQueue);
+
+      std::map<ObjectId, ObjectState>::iterator iter = m_mapQueuedStates.find(state.m_id);
+      if (iter != m_mapQueuedStates.end())
+         iter->second = state;
+      else
+         m_mapQueuedStates.insert(std::make_pair(state.m_id, state));
+
+      bFlush = m_mapQueuedStates.size() >= c_uiFlushThreshold;
+   }
+
+   if (bFlush)
+      Flush();
+}
+
+/// \details When writing failed, the states of the batch are queued again,
+/// unless a newer state of the same object was queued in the meantime.
+bool PersistenceQueue::CheckLastWrite(bool bWait)
+{
+   RecursiveMutex::LockType lock(m_mtxQueue);
+
+   if (!m_futureLastWrite.valid())
+      return true;
+
+   if (!bWait && m_futureLastWrite.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+      return false;
+
+   CString cszMessage;
+   try
+   {
+      m_futureLastWrite.get();
+   }
+   catch (const Exception& ex)
+   {
+      cszMessage = ex.Message();
+   }
+   catch (const std::exception& ex)
+   {
+      cszMessage = ex.what();
+   }
+   catch (...)
+   {
+      cszMessage = _T("unknown exception");
+   }
+
+   if (!cszMessage.IsEmpty())
+   {
+      CString cszText;
+      cszText.Format(_T("couldn't write %u object states, queueing them again: %s"),
+         static_cast<unsigned int>(m_vecWritingStates.size()), cszMessage.GetString());
+      LOG_ERROR(cszText, Log::Server::Database);
+
+      for (size_t i=0, iMax=m_vecWritingStates.size(); i<iMax; i++)
+         m_mapQueuedStates.insert(std::make_pair(m_vecWritingStates[i].m_id, m_vecWritingStates[i]));
+   }
+
+   m_vecWritingStates.clear();
+
+   return true;
+}
+
+void PersistenceQueue::WriteObjectStates(Database::StatementCache& statementCache,
+   const std::vector<ObjectState>& vecObjectStates)
+{
+   Database::IDatabasePtr spDatabase = statementCache.GetDatabase();
+
+   {
+      Database::Transaction transaction(spDatabase);
+
+      for (size_t i=0, iMax=vecObjectStates.size(); i<iMax; i++)
+      {
+         const ObjectState& state = vecObjectStates[i];
+
+         Database::ICommandPtr spCommand = statementCache.Get(
+            _T("insert or replace into object_state (uuid, name, pos, direction, health) values (?, ?, ?, ?, ?)"));
+
+         ATLASSERT(5 == spCommand->GetParamCount());
+
+         CString cszPos;
+         cszPos.Format(_T("%f,%f,%f"), state.m_vPos.X(), state.m_vPos.Y(), state.m_vPos.Z());
+
+         spCommand->SetParam(0, state.m_id.ToString());
+         spCommand->SetParam(1, state.m_cszName);
+         spCommand->SetParam(2, cszPos);
+         spCommand->SetParam(3, static_cast<int>(std::floor(state.m_dDirection + 0.5)));
+
+         if (state.m_iHealthPoints < 0)
+            spCommand->SetParamNull(4);
+         else
+            spCommand->SetParam(4, state.m_iHealthPoints);
+
+         // the transaction is rolled back, and the whole batch is queued again
+         Database::IResultSetPtr spResultSet;
+         if (!spCommand->Execute(spResultSet))
+            throw Exception(_T("couldn't write object state: ") + spDatabase->GetLastError(), __FILE__, __LINE__);
+      }
+
+      transaction.Commit();
+   }
+
+   // checkpoint after every batch, so that the write-ahead log stays small and
+   // the checkpoint cost doesn't pile up until an automatic checkpoint
+   if (!spDatabase->ExecuteDirect(_T("pragma wal_checkpoint(PASSIVE)")))
+      LOG_WARN(_T("couldn't checkpoint database: ") + spDatabase->GetLastError(), Log::Server::Database);
+}
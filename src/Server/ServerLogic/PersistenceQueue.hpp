@@ -0,0 +1,128 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file PersistenceQueue.hpp Write-behind queue for world object state
+//
+#pragma once
+
+// includes
+#include "ServerLogic.hpp"
+#include "Object.hpp"
+#include "TimeBase.hpp"
+#include <ulib/thread/RecursiveMutex.hpp>
+#include <map>
+#include <vector>
+#include <future>
+
+// forward references
+class MovementInfo;
+namespace Database
+{
+class Manager;
+class StatementCache;
+}
+
+/// \brief write-behind queue for persisting state of world objects
+/// \details State changes of objects are collected in memory, and a newer
+/// state of an object replaces an older one that wasn't written yet. The
+/// collected states are written in one transaction on the database write
+/// thread, either when the flush interval has passed or when the number of
+/// collected states reaches a threshold; after each batch the write-ahead log
+/// is checkpointed, so that the checkpoint cost stays small and doesn't occur
+/// at random commits. Queueing and flushing only moves object states around
+/// in memory, so it's cheap enough to be called from the world tick. Only one
+/// batch is written at a time; the result of a batch is checked with the next
+/// flush, and when writing failed, its states are queued again.
+class PersistenceQueue
+{
+public:
+   /// ctor
+   PersistenceQueue(Database::Manager& databaseManager);
+
+   /// dtor; writes all object states that are still queued
+   ~PersistenceQueue();
+
+   /// queues current state of object
+   void QueueObject(const ObjectPtr& spObj);
+
+   /// queues current state of object, with position from movement info
+   void QueueMovement(const ObjectPtr& spObj, const MovementInfo& info);
+
+   /// writes queued object states when the flush interval has passed; called once per world tick
+   void Tick(const TimeIndex& timeIndex);
+
+   /// writes all queued object states; when the last batch is still being written, the states stay queued
+   void Flush();
+
+   /// returns number of queued object states
+   size_t QueueSize() const;
+
+private:
+   /// object state to persist
+   struct ObjectState
+   {
+      /// ctor
+      ObjectState(const ObjectId& id)
+         :m_id(id),
+          m_dDirection(0.0),
+          m_iHealthPoints(-1)
+      {
+      }
+
+      /// object id
+      ObjectId m_id;
+
+      /// object name
+      CString m_cszName;
+
+      /// position in world
+      Vector3d m_vPos;
+
+      /// movement direction, in degrees
+      double m_dDirection;
+
+      /// health points; -1 when object has no health
+      int m_iHealthPoints;
+   };
+
+   /// returns state of object
+   static ObjectState GetObjectState(const ObjectPtr& spObj);
+
+   /// queues object state, replacing the queued state of the same object
+   void Queue(const ObjectState& state);
+
+   /// checks result of last written batch, and queues its states again when writing failed;
+   /// returns false when the batch is still being written and bWait is false
+   bool CheckLastWrite(bool bWait);
+
+   /// writes object states in one transaction; runs on database write thread
+   static void WriteObjectStates(Database::StatementCache& statementCache,
+      const std::vector<ObjectState>& vecObjectStates);
+
+private:
+   /// interval in seconds after which queued object states are written
+   static const double c_dFlushInterval;
+
+   /// number of queued object states that are written without waiting for the flush interval
+   static const size_t c_uiFlushThreshold = 256;
+
+   /// database manager
+   Database::Manager& m_databaseManager;
+
+   /// mutex to protect queued object states; states are queued from session
+   /// threads and from the world runner thread
+   mutable RecursiveMutex m_mtxQueue;
+
+   /// queued object states
+   std::map<ObjectId, ObjectState> m_mapQueuedStates;
+
+   /// object states of the batch that is currently written
+   std::vector<ObjectState> m_vecWritingStates;
+
+   /// result of the batch that is currently written; invalid when no batch was written yet
+   std::future<void> m_futureLastWrite;
+
+   /// time index of last flush
+   TimeIndex m_lastFlush;
+};
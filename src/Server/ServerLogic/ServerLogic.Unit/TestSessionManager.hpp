@@ -10,7 +10,9 @@
 #include "ISessionManager.hpp"
 #include "Session.hpp"
 #include "RawMessage.hpp"
+#include "Object.hpp"
 #include <vector>
+#include <map>
 
 class TestSessionManager: public ISessionManager
 {
@@ -38,9 +40,45 @@ public:
          return true;
       }
 
+      /// records sent buffer instead of writing it to the socket
+      virtual void SendBuffer(const SharedConstBuffer& buffer) override
+      {
+         m_vecSentBuffers.push_back(buffer);
+      }
+
+      /// returns ids of all messages sent since last call, in order
+      std::vector<unsigned short> TakeSentMessageIds()
+      {
+         std::vector<unsigned short> vecMessageIds;
+
+         // a buffer may contain more than one message, each with a 4 byte header
+         for (size_t i = 0; i < m_vecSentBuffers.size(); i++)
+         {
+            const std::vector<unsigned char>& vecData = m_vecSentBuffers[i].Data();
+            for (size_t uiPos = 0; uiPos + 4 <= vecData.size();
+               uiPos += 4 + (vecData[uiPos + 2] | (vecData[uiPos + 3] << 8)))
+            {
+               vecMessageIds.push_back(static_cast<unsigned short>(vecData[uiPos] | (vecData[uiPos + 1] << 8)));
+            }
+         }
+
+         m_vecSentBuffers.clear();
+         return vecMessageIds;
+      }
+
       std::vector<RawMessage> m_vecReceivedMessages;
+
+      std::vector<SharedConstBuffer> m_vecSentBuffers;
    };
 
+   /// adds session for object; updates for that object are recorded in the session
+   std::shared_ptr<TestSession> AddSession(const ObjectId& objId)
+   {
+      std::shared_ptr<TestSession> spSession(new TestSession(m_ioService));
+      m_mapSessions[objId] = spSession;
+      return spSession;
+   }
+
    virtual std::shared_ptr<Session> CreateNewSession() override
    {
       return std::shared_ptr<Session>(new TestSession(m_ioService));
@@ -51,11 +89,22 @@ public:
       throw -1;
    }
 
-   virtual std::weak_ptr<Session> FindSession(const ObjectId& /*objId*/) override
+   virtual std::weak_ptr<Session> FindSession(const ObjectId& objId) override
+   {
+      std::map<ObjectId, std::shared_ptr<TestSession>>::const_iterator iter = m_mapSessions.find(objId);
+      if (iter == m_mapSessions.end())
+         return std::weak_ptr<Session>();
+
+      return iter->second;
+   }
+
+   virtual void OnLookupsFinished() override
    {
-      return std::weak_ptr<Session>();
    }
 
 private:
    boost::asio::io_service& m_ioService;
+
+   /// sessions added with AddSession()
+   std::map<ObjectId, std::shared_ptr<TestSession>> m_mapSessions;
 };
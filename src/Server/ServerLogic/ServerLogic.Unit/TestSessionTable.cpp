@@ -0,0 +1,104 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file TestSessionTable.cpp Unit tests for the session table of class SessionManager
+//
+
+// includes
+#include "stdafx.h"
+#include "SessionManager.hpp"
+#include "StaticAccountAuthManager.hpp"
+#include "IoServicePool.hpp"
+#include "UpdateManager.hpp"
+#include "IModel.hpp"
+#include "Session.hpp"
+#include "Mobile.hpp"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTest
+{
+   /// model that ignores everything; sessions need a world model
+   class NullModel: public IModel
+   {
+   public:
+      virtual void InitialUpdate(MobilePtr /*spPlayer*/) override {}
+      virtual void Tick(const TimeIndex& /*timeIndex*/) override {}
+      virtual void ReceiveAction(ActionPtr /*spAction*/) override {}
+      virtual void ReceiveCommand(Command& /*c*/) override {}
+      virtual void AddRemoveObject(const std::vector<ObjectPtr>& /*vecObjectsToAdd*/,
+         const std::vector<ObjectId>& /*vecObjectsToRemove*/) override {}
+      virtual void UpdateObjectMovement(const ObjectId& /*id*/, const MovementInfo& /*info*/) override {}
+   };
+
+   /// tests the session table of class SessionManager
+   TEST_CLASS(TestSessionTable)
+   {
+      /// tests ConnectSession() and FindSession()
+      TEST_METHOD(TestConnectAndFindSession)
+      {
+         StaticAccountAuthManager authManager;
+         NullModel worldModel;
+         IoServicePool ioServicePool(1);
+
+         SessionManager sessionManager(authManager, worldModel, ioServicePool);
+         ISessionManager& iSessionManager = sessionManager;
+
+         ObjectId objId1 = ObjectId::New();
+         ObjectId objId2 = ObjectId::New();
+
+         Assert::IsTrue(iSessionManager.FindSession(objId1).expired(), _T("session table must be empty"));
+
+         std::shared_ptr<Session> spSession1 = iSessionManager.CreateNewSession();
+         std::shared_ptr<Session> spSession2 = iSessionManager.CreateNewSession();
+
+         iSessionManager.ConnectSession(objId1, spSession1);
+         iSessionManager.ConnectSession(objId2, spSession2);
+
+         Assert::IsTrue(iSessionManager.FindSession(objId1).lock() == spSession1, _T("session 1 must be found"));
+         Assert::IsTrue(iSessionManager.FindSession(objId2).lock() == spSession2, _T("session 2 must be found"));
+
+         // replaced tables are freed; current table must still be used
+         iSessionManager.OnLookupsFinished();
+
+         Assert::IsTrue(iSessionManager.FindSession(objId1).lock() == spSession1, _T("session 1 must still be found"));
+
+         // entries of sessions that are gone are removed
+         spSession1.reset();
+         sessionManager.Cleanup();
+         iSessionManager.OnLookupsFinished();
+
+         Assert::IsTrue(iSessionManager.FindSession(objId1).expired(), _T("session 1 must not be found anymore"));
+         Assert::IsTrue(iSessionManager.FindSession(objId2).lock() == spSession2, _T("session 2 must still be found"));
+      }
+
+      /// tests that flushed updates are sent to sessions connected in the session manager
+      TEST_METHOD(TestFlushUpdatesToConnectedSession)
+      {
+         StaticAccountAuthManager authManager;
+         NullModel worldModel;
+         IoServicePool ioServicePool(1);
+
+         SessionManager sessionManager(authManager, worldModel, ioServicePool);
+         ISessionManager& iSessionManager = sessionManager;
+
+         UpdateManager um(sessionManager);
+
+         MobilePtr spMobile1(new Mobile(ObjectId::New()));
+         MobilePtr spMobile2(new Mobile(ObjectId::New()));
+
+         // io service isn't run, so sent buffers stay queued in the session
+         std::shared_ptr<Session> spSession1 = iSessionManager.CreateNewSession();
+         iSessionManager.ConnectSession(spMobile1->Id(), spSession1);
+
+         um.ShareAddObject(spMobile1);
+         um.ShareAddObject(spMobile2);
+
+         um.FlushUpdates(TimeIndex(1.0));
+
+         Assert::IsTrue(spSession1->QueuedBytes() > 0, _T("player 1 must get add object message of player 2"));
+      }
+   };
+
+} // namespace UnitTest
@@ -0,0 +1,77 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file TestSpatialGrid.cpp Unit tests for class SpatialGrid
+//
+
+// includes
+#include "stdafx.h"
+#include "SpatialGrid.hpp"
+#include <set>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTest
+{
+   /// tests class SpatialGrid
+   TEST_CLASS(TestSpatialGrid)
+   {
+      /// returns all object ids in neighbour cells of given position
+      static std::set<ObjectId> FindNeighbours(const SpatialGrid& grid, const Vector3d& vPos)
+      {
+         std::set<ObjectId> setIds;
+         grid.ForEachNeighbour(vPos, [&](const ObjectId& objId)
+         {
+            setIds.insert(objId);
+         });
+
+         return setIds;
+      }
+
+      /// tests Add() and ForEachNeighbour()
+      TEST_METHOD(TestAddFindNeighbours)
+      {
+         SpatialGrid grid(10.0);
+
+         ObjectId id1 = ObjectId::New();
+         ObjectId id2 = ObjectId::New();
+         ObjectId id3 = ObjectId::New();
+
+         grid.Add(id1, Vector3d(1.0, 0.0, 1.0));
+         grid.Add(id2, Vector3d(-9.0, 0.0, 15.0)); // neighbour cell
+         grid.Add(id3, Vector3d(35.0, 0.0, 1.0)); // far away
+
+         std::set<ObjectId> setIds = FindNeighbours(grid, Vector3d(2.0, 0.0, 2.0));
+
+         Assert::AreEqual<size_t>(2, setIds.size(), _T("must find two objects"));
+         Assert::IsTrue(setIds.find(id1) != setIds.end(), _T("must find object in same cell"));
+         Assert::IsTrue(setIds.find(id2) != setIds.end(), _T("must find object in neighbour cell"));
+      }
+
+      /// tests Move() and Remove()
+      TEST_METHOD(TestMoveRemove)
+      {
+         SpatialGrid grid(10.0);
+
+         ObjectId id1 = ObjectId::New();
+
+         grid.Add(id1, Vector3d(1.0, 0.0, 1.0));
+
+         // move inside cell
+         grid.Move(id1, Vector3d(1.0, 0.0, 1.0), Vector3d(9.0, 0.0, 1.0));
+         Assert::AreEqual<size_t>(1, grid.NumCells());
+
+         // move to far away cell
+         grid.Move(id1, Vector3d(9.0, 0.0, 1.0), Vector3d(95.0, 0.0, 1.0));
+         Assert::AreEqual<size_t>(1, grid.NumCells(), _T("old cell must have been removed"));
+
+         Assert::IsTrue(FindNeighbours(grid, Vector3d(1.0, 0.0, 1.0)).empty());
+         Assert::AreEqual<size_t>(1, FindNeighbours(grid, Vector3d(95.0, 0.0, 1.0)).size());
+
+         grid.Remove(id1, Vector3d(95.0, 0.0, 1.0));
+         Assert::AreEqual<size_t>(0, grid.NumCells());
+      }
+   };
+
+} // namespace UnitTest
@@ -10,6 +10,10 @@
 #include "UpdateManager.hpp"
 #include "TestSessionManager.hpp"
 #include "Mobile.hpp"
+#include "Message.hpp"
+#include "ThreadPool.hpp"
+#include <ulib/HighResolutionTimer.hpp>
+#include <random>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
@@ -40,6 +44,356 @@ namespace UnitTest
 
          um.ShareAddObject(spMobile2);
       }
+
+      /// tests ShareUpdateMovement() and ShareRemoveObject() with objects leaving their grid cell
+      TEST_METHOD(TestMoveAndRemove)
+      {
+         boost::asio::io_service ioService;
+         TestSessionManager sm(ioService);
+         UpdateManager um(sm);
+
+         MobilePtr spMobile1(new Mobile(ObjectId::New()));
+         MobilePtr spMobile2(new Mobile(ObjectId::New()));
+         spMobile2->Pos(Vector3d(-10.0, 0.0, 10.0));
+
+         std::shared_ptr<TestSessionManager::TestSession> spSession1 = sm.AddSession(spMobile1->Id());
+         std::shared_ptr<TestSessionManager::TestSession> spSession2 = sm.AddSession(spMobile2->Id());
+
+         um.ShareAddObject(spMobile1);
+         um.ShareAddObject(spMobile2);
+
+         um.FlushUpdates(TimeIndex(1.0));
+
+         std::vector<unsigned short> vecMessageIds = spSession1->TakeSentMessageIds();
+         Assert::AreEqual<size_t>(1, vecMessageIds.size(), _T("player 1 must get add object message of player 2"));
+         Assert::AreEqual<int>(msgAddRemoveObject, vecMessageIds[0], _T("message must be add object message"));
+         Assert::IsTrue(spSession2->TakeSentMessageIds().empty(), _T("player 2 must not get any message"));
+
+         // move nearby
+         MovementInfo info(MovementInfo::movementPlayer);
+         info.Position(Vector3d(5.0, 0.0, 0.0));
+         um.ShareUpdateMovement(spMobile1->Id(), info, TimeIndex(1.05));
+
+         um.FlushUpdates(TimeIndex(1.3));
+
+         vecMessageIds = spSession2->TakeSentMessageIds();
+         Assert::AreEqual<size_t>(1, vecMessageIds.size(), _T("player 2 must get movement of player 1"));
+         Assert::AreEqual<int>(msgUpdateObjectMovementDelta, vecMessageIds[0], _T("message must be movement message"));
+         Assert::IsTrue(spSession1->TakeSentMessageIds().empty(), _T("player 1 must not get its own movement"));
+
+         // move out of update distance, leaving the grid cell
+         info.Position(Vector3d(3.0 * c_dMaxVisibleDistance, 0.0, -2.0 * c_dMaxVisibleDistance));
+         um.ShareUpdateMovement(spMobile1->Id(), info, TimeIndex(1.35));
+
+         um.FlushUpdates(TimeIndex(1.6));
+
+         Assert::IsTrue(spSession2->TakeSentMessageIds().empty(), _T("player 2 must not get movement out of update distance"));
+
+         // move back and remove before flushing; queued movement must be dropped
+         info.Position(Vector3d(5.0, 0.0, 5.0));
+         um.ShareUpdateMovement(spMobile1->Id(), info, TimeIndex(1.65));
+
+         um.ShareRemoveObject(spMobile1->Id());
+
+         um.FlushUpdates(TimeIndex(2.0));
+
+         vecMessageIds = spSession2->TakeSentMessageIds();
+         Assert::AreEqual<size_t>(1, vecMessageIds.size(), _T("player 2 must only get remove object message"));
+         Assert::AreEqual<int>(msgAddRemoveObject, vecMessageIds[0], _T("message must be remove object message"));
+
+         // movement after removal must not be sent
+         um.FlushUpdates(TimeIndex(2.5));
+         Assert::IsTrue(spSession2->TakeSentMessageIds().empty(), _T("player 2 must not get movement after remove"));
+
+         um.ShareRemoveObject(spMobile2->Id());
+         um.FlushUpdates(TimeIndex(3.0));
+      }
+
+      /// tests that movement is queued until the next flush, and newer movement replaces older
+      TEST_METHOD(TestQueueMovement)
+      {
+         boost::asio::io_service ioService;
+         TestSessionManager sm(ioService);
+         UpdateManager um(sm);
+
+         MobilePtr spMobile1(new Mobile(ObjectId::New()));
+         MobilePtr spMobile2(new Mobile(ObjectId::New()));
+
+         um.ShareAddObject(spMobile1);
+         um.ShareAddObject(spMobile2);
+
+         for (unsigned int ui = 0; ui < 10; ui++)
+         {
+            MovementInfo info(MovementInfo::movementPlayer);
+            info.Position(Vector3d(ui * 0.5, 0.0, 0.0));
+            um.ShareUpdateMovement(spMobile1->Id(), info, TimeIndex(ui * 0.05));
+         }
+
+         // objects have no sessions, so flushing drops all queued updates
+         um.FlushUpdates(TimeIndex(1.0));
+         um.FlushUpdates(TimeIndex(1.0));
+      }
+
+      /// tests flushing partitions on worker threads, while other threads share updates
+      TEST_METHOD(TestFlushUpdatesParallel)
+      {
+         boost::asio::io_service ioService;
+         TestSessionManager sm(ioService);
+         UpdateManager um(sm);
+
+         // place objects in several partitions
+         std::vector<ObjectId> vecObjectIds;
+         for (unsigned int ui = 0; ui < 100; ui++)
+         {
+            MobilePtr spMobile(new Mobile(ObjectId::New()));
+            spMobile->Pos(Vector3d((ui % 10) * c_dMaxVisibleDistance, 0.0, (ui / 10) * c_dMaxVisibleDistance));
+
+            um.ShareAddObject(spMobile);
+            vecObjectIds.push_back(spMobile->Id());
+         }
+
+         ThreadPool pool(3);
+
+         // share movement on another thread, so that some shares are deferred
+         std::atomic<bool> bStop(false);
+         std::thread shareThread([&]()
+         {
+            for (unsigned int ui = 0; !bStop; ui++)
+            {
+               MovementInfo info(MovementInfo::movementPlayer);
+               info.Position(Vector3d((ui % 100) * 1.0, 0.0, 0.0));
+               um.ShareUpdateMovement(vecObjectIds[ui % vecObjectIds.size()], info, TimeIndex(ui * 0.001));
+            }
+         });
+
+         for (unsigned int ui = 0; ui < 100; ui++)
+            um.FlushUpdates(TimeIndex(ui * 0.1), &pool);
+
+         bStop = true;
+         shareThread.join();
+
+         // shares must not be deferred anymore after flushing
+         for (size_t i = 0; i < vecObjectIds.size(); i++)
+            um.ShareRemoveObject(vecObjectIds[i]);
+
+         um.FlushUpdates(TimeIndex(100.0), &pool);
+      }
+
+      /// tests that movement following the predicted movement isn't sent again
+      TEST_METHOD(TestMovementWithinErrorNotResent)
+      {
+         boost::asio::io_service ioService;
+         TestSessionManager sm(ioService);
+         UpdateManager um(sm);
+
+         std::shared_ptr<TestSessionManager::TestSession> spSession;
+         ObjectId movedObjId;
+         MovementInfo infoSent = StartWalking(um, sm, spSession, movedObjId);
+
+         // exactly on the predicted path
+         MovementInfo info = infoSent;
+         info.Position(infoSent.PredictPosition(0.5));
+         ShareAndFlush(um, movedObjId, info, TimeIndex(2.0));
+
+         Assert::IsTrue(spSession->TakeSentMessageIds().empty(), _T("predicted movement must not be sent"));
+
+         // slightly off the predicted path, and slightly turned
+         info.Position(infoSent.PredictPosition(1.0) + Vector3d(0.1, 0.0, 0.1));
+         info.Direction(infoSent.Direction() + 2.0);
+         ShareAndFlush(um, movedObjId, info, TimeIndex(2.5));
+
+         Assert::IsTrue(spSession->TakeSentMessageIds().empty(), _T("movement within error limits must not be sent"));
+      }
+
+      /// tests that movement deviating from the predicted movement is sent again
+      TEST_METHOD(TestMovementBeyondErrorResent)
+      {
+         boost::asio::io_service ioService;
+         TestSessionManager sm(ioService);
+         UpdateManager um(sm);
+
+         std::shared_ptr<TestSessionManager::TestSession> spSession;
+         ObjectId movedObjId;
+         MovementInfo infoSent = StartWalking(um, sm, spSession, movedObjId);
+
+         // position error
+         MovementInfo info = infoSent;
+         info.Position(infoSent.PredictPosition(0.5) + Vector3d(0.5, 0.0, 0.0));
+         ShareAndFlush(um, movedObjId, info, TimeIndex(2.0));
+
+         std::vector<unsigned short> vecMessageIds = spSession->TakeSentMessageIds();
+         Assert::AreEqual<size_t>(1, vecMessageIds.size(), _T("movement beyond position error must be sent"));
+         Assert::AreEqual<int>(msgUpdateObjectMovementDelta, vecMessageIds[0], _T("message must be movement message"));
+
+         infoSent = info;
+
+         // view angle error
+         info.Position(infoSent.PredictPosition(0.5));
+         info.Direction(infoSent.Direction() + 10.0);
+         ShareAndFlush(um, movedObjId, info, TimeIndex(2.5));
+
+         vecMessageIds = spSession->TakeSentMessageIds();
+         Assert::AreEqual<size_t>(1, vecMessageIds.size(), _T("movement beyond view angle error must be sent"));
+         Assert::AreEqual<int>(msgUpdateObjectMovementDelta, vecMessageIds[0], _T("message must be movement message"));
+
+         infoSent = info;
+
+         // same errors are tolerated with larger limits
+         um.SetMaxMovementError(1.0, 20.0);
+
+         info.Position(infoSent.PredictPosition(0.5) + Vector3d(0.5, 0.0, 0.0));
+         info.Direction(infoSent.Direction() + 10.0);
+         ShareAndFlush(um, movedObjId, info, TimeIndex(3.0));
+
+         Assert::IsTrue(spSession->TakeSentMessageIds().empty(), _T("movement within larger error limits must not be sent"));
+      }
+
+      /// tests that changes of movement mode, speed or flags are always sent
+      TEST_METHOD(TestMovementChangeResent)
+      {
+         boost::asio::io_service ioService;
+         TestSessionManager sm(ioService);
+         UpdateManager um(sm);
+
+         std::shared_ptr<TestSessionManager::TestSession> spSession;
+         ObjectId movedObjId;
+         MovementInfo infoSent = StartWalking(um, sm, spSession, movedObjId);
+
+         // movement flags
+         MovementInfo info = infoSent;
+         info.Position(infoSent.PredictPosition(0.5));
+         info.SetSidewaysMovement(true, true);
+         ShareAndFlush(um, movedObjId, info, TimeIndex(2.0));
+
+         std::vector<unsigned short> vecMessageIds = spSession->TakeSentMessageIds();
+         Assert::AreEqual<size_t>(1, vecMessageIds.size(), _T("changed movement flags must be sent"));
+         Assert::AreEqual<int>(msgUpdateObjectMovementDelta, vecMessageIds[0], _T("message must be movement message"));
+
+         infoSent = info;
+
+         // speed
+         info.Position(infoSent.PredictPosition(0.5));
+         info.Speed(2.0);
+         ShareAndFlush(um, movedObjId, info, TimeIndex(2.5));
+
+         vecMessageIds = spSession->TakeSentMessageIds();
+         Assert::AreEqual<size_t>(1, vecMessageIds.size(), _T("changed speed must be sent"));
+         Assert::AreEqual<int>(msgUpdateObjectMovementDelta, vecMessageIds[0], _T("message must be movement message"));
+
+         infoSent = info;
+
+         // movement mode
+         MovementInfo infoStand(MovementInfo::movementStand);
+         infoStand.Position(infoSent.PredictPosition(0.5));
+         infoStand.Direction(infoSent.Direction());
+         infoStand.Speed(infoSent.Speed());
+         ShareAndFlush(um, movedObjId, infoStand, TimeIndex(3.0));
+
+         vecMessageIds = spSession->TakeSentMessageIds();
+         Assert::AreEqual<size_t>(1, vecMessageIds.size(), _T("changed movement mode must be sent"));
+         Assert::AreEqual<int>(msgUpdateObjectMovementDelta, vecMessageIds[0], _T("message must be movement message"));
+      }
+
+      /// \brief adds an observing player and a mobile that starts walking forward
+      /// \details returns the walking movement, which the observing player
+      /// got at time index 1.5; received messages are already taken
+      MovementInfo StartWalking(UpdateManager& um, TestSessionManager& sm,
+         std::shared_ptr<TestSessionManager::TestSession>& spSession, ObjectId& movedObjId)
+      {
+         MobilePtr spObserver(new Mobile(ObjectId::New()));
+         MobilePtr spMoved(new Mobile(ObjectId::New()));
+         spObserver->Pos(Vector3d(0.0, 0.0, 10.0));
+
+         spSession = sm.AddSession(spObserver->Id());
+         movedObjId = spMoved->Id();
+
+         um.ShareAddObject(spObserver);
+         um.ShareAddObject(spMoved);
+
+         um.FlushUpdates(TimeIndex(1.0));
+         spSession->TakeSentMessageIds();
+
+         MovementInfo info(MovementInfo::movementPlayer);
+         info.SetForwardMovement(true, true);
+         ShareAndFlush(um, movedObjId, info, TimeIndex(1.5));
+
+         std::vector<unsigned short> vecMessageIds = spSession->TakeSentMessageIds();
+         Assert::AreEqual<size_t>(1, vecMessageIds.size(), _T("observing player must get initial movement"));
+         Assert::AreEqual<int>(msgUpdateObjectMovementDelta, vecMessageIds[0], _T("message must be movement message"));
+
+         return info;
+      }
+
+      /// shares movement and flushes updates at the same time index
+      void ShareAndFlush(UpdateManager& um, const ObjectId& objId, const MovementInfo& info, const TimeIndex& timeIndex)
+      {
+         um.ShareUpdateMovement(objId, info, timeIndex);
+         um.FlushUpdates(timeIndex);
+      }
+
+      /// measures cost of ShareUpdateMovement() with increasing number of objects
+      TEST_METHOD(TestShareUpdateMovementPerformance)
+      {
+         MeasureShareUpdateMovement(1000);
+         MeasureShareUpdateMovement(10000);
+         MeasureShareUpdateMovement(50000);
+      }
+
+      /// adds given number of objects, then measures movement updates
+      void MeasureShareUpdateMovement(unsigned int uiNumObjects)
+      {
+         boost::asio::io_service ioService;
+         TestSessionManager sm(ioService);
+         UpdateManager um(sm);
+
+         // distribute objects on a fixed size area
+         const double c_dAreaSize = 8192.0;
+         std::mt19937 rng(42);
+         std::uniform_real_distribution<double> distPos(0.0, c_dAreaSize);
+
+         std::vector<ObjectId> vecObjectIds;
+         std::vector<Vector3d> vecPositions;
+         for (unsigned int ui = 0; ui < uiNumObjects; ui++)
+         {
+            MobilePtr spMobile(new Mobile(ObjectId::New()));
+            spMobile->Pos(Vector3d(distPos(rng), 0.0, distPos(rng)));
+
+            um.ShareAddObject(spMobile);
+
+            vecObjectIds.push_back(spMobile->Id());
+            vecPositions.push_back(spMobile->Pos());
+         }
+
+         // move objects around, so that some of them change grid cells
+         std::uniform_real_distribution<double> distStep(-5.0, 5.0);
+
+         const unsigned int c_uiNumUpdates = 20000;
+
+         HighResolutionTimer timer;
+         timer.Start();
+
+         for (unsigned int ui = 0; ui < c_uiNumUpdates; ui++)
+         {
+            size_t uiIndex = ui % uiNumObjects;
+            vecPositions[uiIndex] += Vector3d(distStep(rng), 0.0, distStep(rng));
+
+            MovementInfo info(MovementInfo::movementPlayer);
+            info.Position(vecPositions[uiIndex]);
+
+            um.ShareUpdateMovement(vecObjectIds[uiIndex], info, TimeIndex(ui * 1e-4));
+
+            // flush as world tick would do
+            if ((ui + 1) % 1000 == 0)
+               um.FlushUpdates(TimeIndex(ui * 1e-4));
+         }
+
+         timer.Stop();
+
+         CString cszText;
+         cszText.Format(_T("ShareUpdateMovement() with %u objects: %.3f us per update\n"),
+            uiNumObjects, timer.Elapsed() * 1e6 / c_uiNumUpdates);
+         Logger::WriteMessage(cszText);
+      }
    };
 
 } // namespace UnitTest
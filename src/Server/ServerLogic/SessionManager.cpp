@@ -10,13 +10,29 @@
 #include "SessionManager.hpp"
 #include "IAuthManager.hpp"
 #include "ServerSessionImpl.hpp"
+#include "IoServicePool.hpp"
+#include "MetricsManager.hpp"
+
+/// default number of bytes queued in a session, above which movement updates are coalesced
+const size_t c_uiDefaultSendHighWaterMark = 64 * 1024;
+
+/// default number of bytes queued in a session, above which the session is closed
+const size_t c_uiDefaultSendHardLimit = 1024 * 1024;
 
 SessionManager::SessionManager(IAuthManager& authManager,
-   IModel& worldModel, boost::asio::io_service& ioService)
+   IModel& worldModel, IoServicePool& ioServicePool)
 :m_authManager(authManager),
  m_worldModel(worldModel),
- m_ioService(ioService)
+ m_ioServicePool(ioServicePool),
+ m_uiSendHighWaterMark(c_uiDefaultSendHighWaterMark),
+ m_uiSendHardLimit(c_uiDefaultSendHardLimit),
+ m_pSessionTable(new T_mapSessionTable)
+{
+}
+
+SessionManager::~SessionManager()
 {
+   delete m_pSessionTable.load();
 }
 
 void SessionManager::Add(std::weak_ptr<ServerSession> wpClient)
@@ -53,6 +69,49 @@ void SessionManager::Cleanup()
       else
          ++iter;
    }
+
+   CleanupSessionTable();
+}
+
+/// \details Only replaces the session table when there are stale entries.
+/// Lookups that run in parallel still use the old table, and may find an
+/// expired session; they have to check the weak_ptr anyway.
+void SessionManager::CleanupSessionTable()
+{
+   RecursiveMutex::LockType lock(m_mtxSessionTable);
+
+   const T_mapSessionTable& sessionTable = *m_pSessionTable.load();
+
+   bool bStale = std::any_of(sessionTable.begin(), sessionTable.end(),
+      [](const T_mapSessionTable::value_type& val) { return val.second.expired(); });
+
+   if (!bStale)
+      return;
+
+   std::unique_ptr<T_mapSessionTable> upNewSessionTable(new T_mapSessionTable);
+   upNewSessionTable->reserve(sessionTable.size());
+
+   std::copy_if(sessionTable.begin(), sessionTable.end(),
+      std::inserter(*upNewSessionTable, upNewSessionTable->end()),
+      [](const T_mapSessionTable::value_type& val) { return !val.second.expired(); });
+
+   CString cszText;
+   cszText.Format(_T("SessionManager removed %u stale session table entries"),
+      static_cast<unsigned int>(sessionTable.size() - upNewSessionTable->size()));
+   LOG_INFO(cszText, Log::Server::Session);
+
+   ReplaceSessionTable(std::move(upNewSessionTable));
+}
+
+/// \details The old table isn't freed here, since FindSession() calls running
+/// in parallel may still use it; it's freed in OnLookupsFinished().
+void SessionManager::ReplaceSessionTable(std::unique_ptr<T_mapSessionTable> upNewSessionTable)
+{
+   RecursiveMutex::LockType lock(m_mtxSessionTable);
+
+   const T_mapSessionTable* pOldSessionTable = m_pSessionTable.exchange(upNewSessionTable.release());
+
+   m_vecRetiredSessionTables.push_back(std::unique_ptr<const T_mapSessionTable>(pOldSessionTable));
 }
 
 void SessionManager::LogoutAll()
@@ -72,33 +131,98 @@ void SessionManager::LogoutAll()
    }
 }
 
+/// \details Sent bytes and messages are accumulated; the queue sizes and the
+/// logon queue size are current values.
+void SessionManager::CollectMetrics(MetricsManager& metricsManager)
+{
+   RecursiveMutex::LockType lock(m_mtxAllClients);
+
+   unsigned int uiBytesSent = 0, uiMessagesSent = 0;
+   size_t uiQueuedBytes = 0, uiMaxQueuedBytes = 0;
+
+   std::for_each(m_setAllClients.begin(), m_setAllClients.end(), [&](const std::weak_ptr<ServerSession>& wpClient)
+   {
+      std::shared_ptr<ServerSession> spClient(wpClient.lock());
+      if (spClient == NULL)
+         return;
+
+      uiBytesSent += spClient->TakeBytesSent();
+      uiMessagesSent += spClient->TakeMessagesSent();
+
+      size_t uiSessionQueuedBytes = spClient->QueuedBytes();
+      uiQueuedBytes += uiSessionQueuedBytes;
+      uiMaxQueuedBytes = std::max(uiMaxQueuedBytes, uiSessionQueuedBytes);
+   });
+
+   metricsManager.Set(Metrics::DataBytesTx, uiBytesSent);
+   metricsManager.Set(Metrics::MessagesTx, uiMessagesSent);
+   metricsManager.Set(Metrics::Server::SendQueueBytes, static_cast<unsigned int>(uiQueuedBytes));
+   metricsManager.Set(Metrics::Server::MaxSendQueueBytes, static_cast<unsigned int>(uiMaxQueuedBytes));
+
+   metricsManager.Set(Metrics::Server::LogonQueueSize, static_cast<unsigned int>(m_authManager.LogonQueueSize()));
+}
+
+/// \details Every new session gets the next io service from the pool, so
+/// accepted sockets are spread over all io threads. All handlers of a session
+/// run on the same thread.
 std::shared_ptr<Session> SessionManager::CreateNewSession()
 {
    std::shared_ptr<ServerSessionImpl> spSession(
-      new ServerSessionImpl(m_ioService, m_worldModel, *this));
+      new ServerSessionImpl(m_ioServicePool.Next(), m_worldModel, *this));
 
    // query auth manager for server authentication module to use (if any)
    std::shared_ptr<IServerAuthModule> spAuthModule = m_authManager.GetAuthenticationModule();
    if (spAuthModule != NULL)
       spSession->SetAuthenticationModule(spAuthModule);
 
+   spSession->SetSendLimits(m_uiSendHighWaterMark, m_uiSendHardLimit);
+
    return spSession;
 }
 
-void SessionManager::ConnectSession(const ObjectId& /*objId*/, std::shared_ptr<Session> spSession)
+/// \details Copies the current session table, since it may still be used by
+/// FindSession() calls running in parallel.
+void SessionManager::ConnectSession(const ObjectId& objId, std::shared_ptr<Session> spSession)
 {
    std::shared_ptr<ServerSessionImpl> spSessionImpl =
       std::dynamic_pointer_cast<ServerSessionImpl>(spSession);
 
    ATLASSERT(spSessionImpl != nullptr);
 
-   // TODO connect player id with session
+   RecursiveMutex::LockType lock(m_mtxSessionTable);
+
+   std::unique_ptr<T_mapSessionTable> upNewSessionTable(new T_mapSessionTable(*m_pSessionTable.load()));
+
+   (*upNewSessionTable)[objId] = spSession;
+
+   ReplaceSessionTable(std::move(upNewSessionTable));
 }
 
-std::weak_ptr<Session> SessionManager::FindSession(const ObjectId& /*objId*/)
+/// \details Only loads the pointer to the current table; the table stays
+/// valid until OnLookupsFinished() is called.
+std::weak_ptr<Session> SessionManager::FindSession(const ObjectId& objId)
 {
-   // TODO implement
-   return std::weak_ptr<Session>();
+   const T_mapSessionTable& sessionTable = *m_pSessionTable.load(std::memory_order_acquire);
+
+   T_mapSessionTable::const_iterator iter = sessionTable.find(objId);
+   if (iter == sessionTable.end())
+      return std::weak_ptr<Session>();
+
+   return iter->second;
+}
+
+/// \details Tables that were replaced before this call can't be reached by
+/// lookups starting later, and all lookups that may have used them are
+/// finished, so they are freed.
+void SessionManager::OnLookupsFinished()
+{
+   // tables are freed outside of the lock
+   std::vector<std::unique_ptr<const T_mapSessionTable>> vecRetiredSessionTables;
+
+   {
+      RecursiveMutex::LockType lock(m_mtxSessionTable);
+      vecRetiredSessionTables.swap(m_vecRetiredSessionTables);
+   }
 }
 
 void SessionManager::InitSession(std::shared_ptr<Session> /*spSession*/)
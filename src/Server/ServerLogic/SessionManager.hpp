@@ -10,23 +10,35 @@
 #include "ServerLogic.hpp"
 #include <ulib/thread/RecursiveMutex.hpp>
 #include "ISessionManager.hpp"
+#include "Uuid.hpp"
 #include <set>
+#include <vector>
+#include <atomic>
+#include <unordered_map>
 
 // forward references
 class IAuthManager;
 class IModel;
+class IoServicePool;
+class MetricsManager;
 
 /// \brief session manager
-/// \details manages all sessions connected to the server
+/// \details manages all sessions connected to the server. Sessions that are
+/// connected to an object id are stored in a session table that is never
+/// modified; modifications copy the table and atomically replace the pointer
+/// to it. This way FindSession() doesn't need to lock anything, or to change
+/// any reference count, since it is called for every player that gets updates
+/// in each world tick. Replaced tables are kept until OnLookupsFinished() is
+/// called, since lookups running in parallel may still use them.
 class SERVERLOGIC_DECLSPEC SessionManager: public ISessionManager
 {
 public:
    DEFINE_INSTANCE(SessionManager)
 
    /// ctor
-   SessionManager(IAuthManager& authManager, IModel& worldModel, boost::asio::io_service& ioService);
+   SessionManager(IAuthManager& authManager, IModel& worldModel, IoServicePool& ioServicePool);
    /// dtor
-   virtual ~SessionManager() {}
+   virtual ~SessionManager();
 
    /// inits a new session
    void InitSession(std::shared_ptr<Session> spSession);
@@ -37,6 +49,16 @@ public:
    /// logs out all connected clients
    void LogoutAll();
 
+   /// sets send limits for new sessions; see Session::SetSendLimits()
+   void SetSendLimits(size_t uiHighWaterMark, size_t uiHardLimit)
+   {
+      m_uiSendHighWaterMark = uiHighWaterMark;
+      m_uiSendHardLimit = uiHardLimit;
+   }
+
+   /// collects send metrics of all sessions, and the logon queue size
+   void CollectMetrics(MetricsManager& metricsManager);
+
    /// adds a server session to manager
    void Add(std::weak_ptr<ServerSession> wpClient);
 
@@ -44,11 +66,18 @@ public:
    void Remove(std::weak_ptr<ServerSession> wpClient);
 
 private:
+   /// removes entries of sessions that are not existant anymore from session table
+   void CleanupSessionTable();
+
+   /// publishes new session table; the old one is retired
+   void ReplaceSessionTable(std::unique_ptr<T_mapSessionTable> upNewSessionTable);
+
    // virtual methods from ISessionManager
 
    virtual std::shared_ptr<Session> CreateNewSession() override;
    virtual void ConnectSession(const ObjectId& objId, std::shared_ptr<Session> spSession) override;
    virtual std::weak_ptr<Session> FindSession(const ObjectId& objId) override;
+   virtual void OnLookupsFinished() override;
 
 private:
    /// authentication manager
@@ -57,8 +86,14 @@ private:
    /// world model
    IModel& m_worldModel;
 
-   /// io service
-   boost::asio::io_service& m_ioService;
+   /// pool of io services that sessions are distributed on
+   IoServicePool& m_ioServicePool;
+
+   /// send high-water mark for new sessions
+   size_t m_uiSendHighWaterMark;
+
+   /// send hard limit for new sessions
+   size_t m_uiSendHardLimit;
 
    /// type of set to store server sessions
    typedef std::set<std::weak_ptr<ServerSession>, std::owner_less<std::weak_ptr<ServerSession>>> T_setAllClients;
@@ -68,4 +103,17 @@ private:
 
    /// mutex to protect m_setAllClients
    RecursiveMutex m_mtxAllClients;
+
+   /// type of table to find sessions by object id
+   typedef std::unordered_map<ObjectId, std::weak_ptr<Session>> T_mapSessionTable;
+
+   /// current session table; owned by the session manager
+   std::atomic<const T_mapSessionTable*> m_pSessionTable;
+
+   /// session tables that were replaced, but may still be used by lookups
+   std::vector<std::unique_ptr<const T_mapSessionTable>> m_vecRetiredSessionTables;
+
+   /// mutex to serialize modifications of m_pSessionTable and
+   /// m_vecRetiredSessionTables; not used by FindSession()
+   RecursiveMutex m_mtxSessionTable;
 };
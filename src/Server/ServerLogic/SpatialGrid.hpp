@@ -0,0 +1,141 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file SpatialGrid.hpp Spatial hash grid
+//
+#pragma once
+
+// includes
+#include "Object.hpp"
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+/// \brief spatial hash grid
+/// \details Divides the x/z plane into square cells and stores the ids of all
+/// objects that are in each cell. Only cells that contain objects are stored.
+/// When the cell size is at least the query distance, all objects in that
+/// distance are found in the 3x3 cells around a position; the caller still has
+/// to check the exact distance of each object returned.
+class SpatialGrid
+{
+public:
+   /// ctor
+   SpatialGrid(double dCellSize = c_dMaxVisibleDistance)
+      :m_dCellSize(dCellSize)
+   {
+      ATLASSERT(dCellSize > 0.0);
+   }
+
+   /// adds object at given position
+   void Add(const ObjectId& objId, const Vector3d& vPos)
+   {
+      m_mapCells[CellKeyFromPos(vPos)].push_back(objId);
+   }
+
+   /// removes object that was added at given position
+   void Remove(const ObjectId& objId, const Vector3d& vPos)
+   {
+      RemoveFromCell(objId, CellKeyFromPos(vPos));
+   }
+
+   /// moves object from old to new position; only updates cells when object changed cell
+   void Move(const ObjectId& objId, const Vector3d& vOldPos, const Vector3d& vNewPos)
+   {
+      T_CellKey oldKey = CellKeyFromPos(vOldPos);
+      T_CellKey newKey = CellKeyFromPos(vNewPos);
+
+      if (oldKey == newKey)
+         return;
+
+      RemoveFromCell(objId, oldKey);
+      m_mapCells[newKey].push_back(objId);
+   }
+
+   /// calls function for every object in the cell of given position and its neighbour cells
+   /// \tparam TFunc function type; signature void(const ObjectId&)
+   template <typename TFunc>
+   void ForEachNeighbour(const Vector3d& vPos, TFunc fn) const
+   {
+      int iCellX = CellIndex(vPos.X());
+      int iCellZ = CellIndex(vPos.Z());
+
+      for (int iZ = iCellZ-1; iZ <= iCellZ+1; iZ++)
+      for (int iX = iCellX-1; iX <= iCellX+1; iX++)
+      {
+         T_mapCells::const_iterator iter = m_mapCells.find(CellKey(iX, iZ));
+         if (iter == m_mapCells.end())
+            continue;
+
+         const T_vecObjectIds& vecObjectIds = iter->second;
+         for (size_t i=0, iMax=vecObjectIds.size(); i<iMax; i++)
+            fn(vecObjectIds[i]);
+      }
+   }
+
+   /// returns number of non-empty cells
+   size_t NumCells() const { return m_mapCells.size(); }
+
+private:
+   /// cell key; combination of x and z cell index
+   typedef unsigned long long T_CellKey;
+
+   /// object ids in a cell
+   typedef std::vector<ObjectId> T_vecObjectIds;
+
+   /// cell map type
+   typedef std::unordered_map<T_CellKey, T_vecObjectIds> T_mapCells;
+
+   /// returns cell index for coordinate
+   int CellIndex(double dCoord) const
+   {
+      return static_cast<int>(std::floor(dCoord / m_dCellSize));
+   }
+
+   /// returns cell key from cell indices
+   static T_CellKey CellKey(int iCellX, int iCellZ)
+   {
+      return (static_cast<T_CellKey>(static_cast<unsigned int>(iCellX)) << 32) |
+         static_cast<T_CellKey>(static_cast<unsigned int>(iCellZ));
+   }
+
+   /// returns cell key from position
+   T_CellKey CellKeyFromPos(const Vector3d& vPos) const
+   {
+      return CellKey(CellIndex(vPos.X()), CellIndex(vPos.Z()));
+   }
+
+   /// removes object from cell; removes cell when it gets empty
+   void RemoveFromCell(const ObjectId& objId, T_CellKey key)
+   {
+      T_mapCells::iterator iter = m_mapCells.find(key);
+      ATLASSERT(iter != m_mapCells.end()); // must have been added before
+
+      if (iter == m_mapCells.end())
+         return;
+
+      T_vecObjectIds& vecObjectIds = iter->second;
+
+      T_vecObjectIds::iterator iterObj = std::find(vecObjectIds.begin(), vecObjectIds.end(), objId);
+      ATLASSERT(iterObj != vecObjectIds.end());
+
+      if (iterObj != vecObjectIds.end())
+      {
+         // order in cell doesn't matter, so swap with last and pop
+         *iterObj = vecObjectIds.back();
+         vecObjectIds.pop_back();
+      }
+
+      if (vecObjectIds.empty())
+         m_mapCells.erase(iter);
+   }
+
+private:
+   /// cell size, in units
+   double m_dCellSize;
+
+   /// all non-empty cells
+   T_mapCells m_mapCells;
+};
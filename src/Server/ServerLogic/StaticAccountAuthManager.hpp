@@ -12,14 +12,20 @@
 #include "Account.hpp"
 #include "SRPServerAuthModule.hpp"
 #include "StringTools.hpp"
+#include "ThreadPool.hpp"
 #include <map>
 
-/// auth manager that has a fixed set of accounts
+/// \brief auth manager that has a fixed set of accounts
+/// \details Authentication runs on a worker pool; accounts must all be added
+/// before the first session authenticates.
 class StaticAccountAuthManager: public IAuthManager
 {
 public:
    /// ctor
-   StaticAccountAuthManager() {}
+   StaticAccountAuthManager()
+      :m_authWorkerPool(c_uiNumAuthWorkerThreads)
+   {
+   }
    /// dtor
    virtual ~StaticAccountAuthManager() {}
 
@@ -39,10 +45,12 @@ private:
 
    virtual Account GetAccount(const CString& cszUsername) override
    {
-      if (!IsAccountAvail(cszUsername))
+      // note: don't use operator[] here, since this is called from worker threads
+      std::map<CString, Account>::const_iterator iter = m_mapAllAccounts.find(cszUsername);
+      if (iter == m_mapAllAccounts.end())
          throw Exception(_T("unknown user"), __FILE__, __LINE__);
 
-      return m_mapAllAccounts[cszUsername];
+      return iter->second;
    }
 
    virtual std::shared_ptr<IServerAuthModule> GetAuthenticationModule() override
@@ -52,7 +60,12 @@ private:
          this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4);
 
       return std::shared_ptr<IServerAuthModule>(
-         new SRP::ServerAuthModule(fnGetServerAuthInfo));
+         new SRP::ServerAuthModule(fnGetServerAuthInfo, &m_authWorkerPool));
+   }
+
+   virtual size_t LogonQueueSize() const override
+   {
+      return m_authWorkerPool.QueueSize();
    }
 
    /// returns server auth info
@@ -67,6 +80,12 @@ private:
    }
 
 private:
+   /// number of threads that authenticate logons
+   static const unsigned int c_uiNumAuthWorkerThreads = 2;
+
    /// map with all accounts
    std::map<CString, Account> m_mapAllAccounts;
+
+   /// worker pool to authenticate logons on; logons wait in its queue when all workers are busy
+   ThreadPool m_authWorkerPool;
 };
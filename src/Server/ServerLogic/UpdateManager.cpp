@@ -10,188 +10,503 @@
 #include "UpdateManager.hpp"
 #include "Action.hpp"
 #include "Session.hpp"
-#include "MovePlayerMessage.hpp"
+#include "UpdateObjectMovementDeltaMessage.hpp"
 #include "ActionMessage.hpp"
 #include "AddRemoveObjectMessage.hpp"
+#include "JobBatch.hpp"
+
+/// minimum time between two updates of the same type to the same player, in seconds
+static const double c_adMinUpdateInterval[] =
+{
+   0.2, // lastUpdateMovement; newer movement replaces queued movement in between
+   0.0, // lastUpdateAction
+   0.0, // lastUpdateAddRemoveObject
+};
+
+/// default maximum position error of predicted movement, in units
+static const double c_dDefaultMaxPositionError = 0.25;
+
+/// default maximum view angle error of predicted movement, in degrees
+static const double c_dDefaultMaxAngleError = 5.0;
+
+/// \brief size of a spatial partition that is flushed as one job
+/// \details players in the same partition mostly see the same objects, and
+/// so share the serialized movement deltas of that partition
+static const double c_dPartitionSize = 4.0 * c_dMaxVisibleDistance;
+
+/// serialized movement update of an object, relative to a baseline
+struct UpdateManager::DeltaBuffer
+{
+   /// ctor
+   DeltaBuffer(const MovementSnapshot& snapshot, const MovementSnapshot& baseline,
+      const SharedConstBuffer& buffer)
+      :m_snapshot(snapshot),
+       m_baseline(baseline),
+       m_buffer(buffer)
+   {
+   }
+
+   MovementSnapshot m_snapshot;  ///< movement snapshot that was serialized
+   MovementSnapshot m_baseline;  ///< baseline that was used
+   SharedConstBuffer m_buffer;   ///< serialized message
+};
 
 UpdateManager::UpdateManager(ISessionManager& sessionManager)
-:m_sessionManager(sessionManager)
+:m_sessionManager(sessionManager),
+ m_dMaxPositionError(c_dDefaultMaxPositionError),
+ m_dMaxAngleError(c_dDefaultMaxAngleError),
+ m_bFlushRunning(false)
 {
 }
 
-void UpdateManager::ShareUpdateMovement(const ObjectId& objId, const MovementInfo& info)
+void UpdateManager::SetMaxMovementError(double dMaxPositionError, double dMaxAngleError)
 {
-   // go through all objects and check if they should be updated
-   std::map<ObjectId, ShareInfo>::iterator iter = m_mapShareInfo.begin(), stop = m_mapShareInfo.end();
-   for (; iter != stop; ++iter)
+   RecursiveMutex::LockType lock(m_mtxShareInfo);
+
+   m_dMaxPositionError = dMaxPositionError;
+   m_dMaxAngleError = dMaxAngleError;
+}
+
+bool UpdateManager::InUpdateDistance(const Vector3d& vPos1, const Vector3d& vPos2)
+{
+   return (vPos1 - vPos2).Length() < c_dMaxVisibleDistance;
+}
+
+/// \details only visits the objects in the grid cells around the position,
+/// then filters by exact distance
+template <typename TFunc>
+void UpdateManager::ForEachInUpdateDistance(const Vector3d& vPos, TFunc fn)
+{
+   m_spatialGrid.ForEachNeighbour(vPos, [&](const ObjectId& otherId)
    {
-      if (iter->first == objId)
-         continue; // no need to update self
+      ShareInfo& otherShareInfo = m_registryShareInfo.Get(otherId);
 
-      if (!InUpdateDistance(iter->first, objId))
-         continue;
+      if (InUpdateDistance(vPos, otherShareInfo.m_vPos))
+         fn(otherId, otherShareInfo);
+   });
+}
 
-      if (CheckLastUpdate(iter->first, lastUpdateMovement))
-      {
-         // ok, send action
-         std::weak_ptr<Session> wpSession =
-            m_sessionManager.FindSession(iter->first);
+void UpdateManager::ShareUpdateMovement(const ObjectId& objId, const MovementInfo& info, const TimeIndex& timeIndex)
+{
+   if (DeferWhileFlushing(std::bind(&UpdateManager::DoShareUpdateMovement, this, objId, info, timeIndex)))
+      return;
 
-         std::shared_ptr<Session> spSession = wpSession.lock();
-         if (spSession == NULL)
-            continue;
+   RecursiveMutex::LockType lock(m_mtxShareInfo);
+   DoShareUpdateMovement(objId, info, timeIndex);
+}
+
+void UpdateManager::ShareAction(ActionPtr spAction)
+{
+   if (DeferWhileFlushing(std::bind(&UpdateManager::DoShareAction, this, spAction)))
+      return;
+
+   RecursiveMutex::LockType lock(m_mtxShareInfo);
+   DoShareAction(spAction);
+}
+
+void UpdateManager::ShareAddObject(ObjectPtr spObj)
+{
+   if (DeferWhileFlushing(std::bind(&UpdateManager::DoShareAddObject, this, spObj)))
+      return;
+
+   RecursiveMutex::LockType lock(m_mtxShareInfo);
+   DoShareAddObject(spObj);
+}
+
+void UpdateManager::ShareRemoveObject(const ObjectId& objId)
+{
+   if (DeferWhileFlushing(std::bind(&UpdateManager::DoShareRemoveObject, this, objId)))
+      return;
+
+   RecursiveMutex::LockType lock(m_mtxShareInfo);
+   DoShareRemoveObject(objId);
+}
+
+bool UpdateManager::DeferWhileFlushing(T_fnShare fnShare)
+{
+   std::lock_guard<std::mutex> lock(m_mtxDeferredShares);
+
+   if (!m_bFlushRunning)
+      return false;
+
+   m_vecDeferredShares.push_back(fnShare);
+   return true;
+}
+
+/// \details Deferred shares are carried out in the order they were shared;
+/// shares that arrive while applying are deferred, too, until no more shares
+/// are left.
+void UpdateManager::ApplyDeferredShares()
+{
+   for (;;)
+   {
+      std::vector<T_fnShare> vecDeferredShares;
 
-         MovePlayerMessage actionMessage(info);
-         spSession->SendMessage(actionMessage);
-      }
-      else
       {
-         // TODO: postpone update
-         ATLASSERT(false);
+         std::lock_guard<std::mutex> lock(m_mtxDeferredShares);
+
+         if (m_vecDeferredShares.empty())
+         {
+            m_bFlushRunning = false;
+            return;
+         }
+
+         vecDeferredShares.swap(m_vecDeferredShares);
       }
+
+      for (size_t i=0, iMax=vecDeferredShares.size(); i<iMax; i++)
+         vecDeferredShares[i]();
    }
 }
 
-void UpdateManager::ShareAction(ActionPtr spAction)
+/// \details Speed and the parameters of the movement mode, e.g. the keys
+/// pressed for player movement, are compared with the quantization of
+/// MovementSnapshot in mind.
+bool UpdateManager::IsMovementChanged(const MovementInfo& knownInfo, const MovementInfo& info)
 {
-   const ObjectId& objId = spAction->ActorId();
+   if (knownInfo.MovementMode() != info.MovementMode())
+      return true;
+
+   if (!DoublesEqual(knownInfo.Speed(), info.Speed(), 0.1))
+      return true;
 
-   // go through all objects and check if they should be updated
-   std::map<ObjectId, ShareInfo>::iterator iter = m_mapShareInfo.begin(), stop = m_mapShareInfo.end();
-   for (; iter != stop; ++iter)
+   switch (info.MovementMode())
    {
-      if (iter->first == objId)
-         continue; // no need to update self
+   case MovementInfo::movementTarget:
+      return (knownInfo.Destination() - info.Destination()).Length() >= 1.0 / 32.0;
 
-      if (!InUpdateDistance(iter->first, objId))
-         continue;
+   case MovementInfo::movementPlayer:
+      return knownInfo.MovementFlags() != info.MovementFlags();
 
-      if (CheckLastUpdate(iter->first, lastUpdateAction))
-      {
-         // ok, send action
-         std::weak_ptr<Session> wpSession =
-            m_sessionManager.FindSession(iter->first);
+   default:
+      break;
+   }
+
+   return false;
+}
 
-         std::shared_ptr<Session> spSession = wpSession.lock();
-         if (spSession == NULL)
-            continue;
+/// \details The player predicts the movement of the object from the movement
+/// that was last sent to it, starting at the time it was sent.
+bool UpdateManager::IsCorrectionNeeded(const ShareInfo& shareInfo, const ObjectId& movedObjId,
+   const MovementInfo& info, const TimeIndex& timeIndex) const
+{
+   std::map<ObjectId, TimeIndex>::const_iterator iterBaselineTime = shareInfo.m_mapBaselineTimes.find(movedObjId);
+   if (iterBaselineTime == shareInfo.m_mapBaselineTimes.end())
+      return true; // player doesn't know any movement of the object yet
 
-         ActionMessage actionMessage(spAction);
-         spSession->SendMessage(actionMessage);
-      }
-      else
+   MovementInfo knownInfo = shareInfo.m_movementBaselines.Baseline(movedObjId).ToMovementInfo(
+      shareInfo.m_movementBaselines.ZoneOrigin());
+
+   if (IsMovementChanged(knownInfo, info))
+      return true;
+
+   double dElapsed = timeIndex.Get() - iterBaselineTime->second.Get();
+   Vector3d vPredictedPos = knownInfo.PredictPosition(dElapsed < 0.0 ? 0.0 : dElapsed);
+
+   if ((vPredictedPos - info.Position()).Length() > m_dMaxPositionError)
+      return true;
+
+   double dAngleError = AngleInRange(knownInfo.ViewAngle() - info.ViewAngle());
+   if (dAngleError > 180.0)
+      dAngleError = 360.0 - dAngleError;
+
+   return dAngleError > m_dMaxAngleError;
+}
+
+void UpdateManager::DoShareUpdateMovement(const ObjectId& objId, const MovementInfo& info, const TimeIndex& timeIndex)
+{
+   ObjectHandle handle = m_registryShareInfo.Find(objId);
+   ATLASSERT(handle.IsSet()); // must be in map
+
+   if (!handle.IsSet())
+      return;
+
+   // update position; only changes grid cell when object left its cell
+   ShareInfo& shareInfo = m_registryShareInfo.Get(handle);
+
+   m_spatialGrid.Move(objId, shareInfo.m_vPos, info.Position());
+   shareInfo.m_vPos = info.Position();
+
+   MovementSnapshot snapshot(info, shareInfo.m_movementBaselines.ZoneOrigin());
+
+   // queue for all nearby objects that need a correction
+   ForEachInUpdateDistance(shareInfo.m_vPos, [&](const ObjectId& otherId, ShareInfo& otherShareInfo)
+   {
+      if (otherId == objId)
+         return; // no need to update self
+
+      // replaces movement that wasn't sent yet, since that is sent anyway
+      std::map<ObjectId, MovementSnapshot>::iterator iterQueued = otherShareInfo.m_mapQueuedMovement.find(objId);
+      if (iterQueued != otherShareInfo.m_mapQueuedMovement.end())
       {
-         // TODO: postpone update
-         ATLASSERT(false);
+         iterQueued->second = snapshot;
+         return;
       }
-   }
+
+      if (IsCorrectionNeeded(otherShareInfo, objId, info, timeIndex))
+         otherShareInfo.m_mapQueuedMovement[objId] = snapshot;
+   });
 }
 
-void UpdateManager::ShareAddObject(ObjectPtr spObj)
+void UpdateManager::DoShareAction(ActionPtr spAction)
 {
-   // go through all objects and check if they should be updated
-   std::map<ObjectId, ShareInfo>::iterator iter = m_mapShareInfo.begin(), stop = m_mapShareInfo.end();
-   for (; iter != stop; ++iter)
+   const ObjectId& objId = spAction->ActorId();
+
+   ObjectHandle handle = m_registryShareInfo.Find(objId);
+   ATLASSERT(handle.IsSet()); // must be in map
+
+   if (!handle.IsSet())
+      return;
+
+   // serialize message only once, for all sessions
+   ActionMessage actionMessage(spAction);
+   SharedConstBuffer buffer = Session::SerializeMessage(actionMessage);
+
+   // go through all nearby objects, except the actor itself
+   ForEachInUpdateDistance(m_registryShareInfo.Get(handle).m_vPos, [&](const ObjectId& otherId, ShareInfo& otherShareInfo)
    {
-      ATLASSERT(iter->first != spObj->Id()); // must not be in map
+      if (otherId == objId)
+         return; // no need to update self
 
-      if (!InUpdateDistance(iter->first, spObj))
-         continue;
+      otherShareInfo.m_vecQueuedBuffers.push_back(QueuedBuffer(lastUpdateAction, buffer));
+   });
+}
 
-      if (CheckLastUpdate(iter->first, lastUpdateAddRemoveObject))
-      {
-         // update object
-         std::weak_ptr<Session> wpSession =
-            m_sessionManager.FindSession(iter->first);
+void UpdateManager::DoShareAddObject(ObjectPtr spObj)
+{
+   ATLASSERT(!m_registryShareInfo.Contains(spObj->Id())); // must not be in map
 
-         std::shared_ptr<Session> spSession = wpSession.lock();
-         if (spSession == NULL)
-            continue;
+   // serialize message only once, for all sessions
+   std::vector<ObjectPtr> vecObjectsToAdd;
+   vecObjectsToAdd.push_back(spObj);
 
-         std::vector<ObjectPtr> vecObjectsToAdd;
-         vecObjectsToAdd.push_back(spObj);
+   std::vector<ObjectId> vecObjectsToRemove;
 
-         std::vector<ObjectId> vecObjectsToRemove;
+   AddRemoveObjectMessage msg(vecObjectsToAdd, vecObjectsToRemove);
 
-         AddRemoveObjectMessage msg(vecObjectsToAdd, vecObjectsToRemove);
-         spSession->SendMessage(msg);
-      }
-      else
-      {
-         // TODO: postpone update
-         ATLASSERT(false);
-      }
-   }
+   // the world tick writes the position of the object while it's locked
+   Lockable::LockType lockObj = spObj->Lock();
 
-   // add to map
+   SharedConstBuffer buffer = Session::SerializeMessage(msg);
+   Vector3d vPos = spObj->Pos();
+
+   // go through all nearby objects
+   ForEachInUpdateDistance(vPos, [&](const ObjectId& /*otherId*/, ShareInfo& otherShareInfo)
+   {
+      otherShareInfo.m_vecQueuedBuffers.push_back(QueuedBuffer(lastUpdateAddRemoveObject, buffer));
+   });
+
+   // add to map and grid
    ShareInfo info;
-   info.m_vPos = spObj->Pos();
+   info.m_vPos = vPos;
+
+   m_spatialGrid.Add(spObj->Id(), info.m_vPos);
+   m_registryShareInfo.Add(spObj->Id(), std::move(info));
+}
+
+void UpdateManager::DoShareRemoveObject(const ObjectId& objId)
+{
+   ObjectHandle handle = m_registryShareInfo.Find(objId);
+   ATLASSERT(handle.IsSet()); // must be in map
+
+   if (!handle.IsSet())
+      return;
+
+   // remove from map and grid
+   Vector3d vPos = m_registryShareInfo.Get(handle).m_vPos;
 
-   ATLASSERT(m_mapShareInfo.find(spObj->Id()) == m_mapShareInfo.end()); // must not be in map
+   m_spatialGrid.Remove(objId, vPos);
+   m_registryShareInfo.Remove(handle);
 
-   m_mapShareInfo.insert(std::make_pair(spObj->Id(), info));
+   // serialize message only once, for all sessions
+   std::vector<ObjectPtr> vecObjectsToAdd;
+   std::vector<ObjectId> vecObjectsToRemove;
+   vecObjectsToRemove.push_back(objId);
+
+   AddRemoveObjectMessage msg(vecObjectsToAdd, vecObjectsToRemove);
+   SharedConstBuffer buffer = Session::SerializeMessage(msg);
+
+   ForEachInUpdateDistance(vPos, [&](const ObjectId& /*otherId*/, ShareInfo& otherShareInfo)
+   {
+      otherShareInfo.m_vecQueuedBuffers.push_back(QueuedBuffer(lastUpdateAddRemoveObject, buffer));
+
+      // the client drops its baseline when the object is removed; queued
+      // movement would arrive after the remove message, so drop it, too
+      otherShareInfo.m_movementBaselines.Remove(objId);
+      otherShareInfo.m_mapBaselineTimes.erase(objId);
+      otherShareInfo.m_mapQueuedMovement.erase(objId);
+   });
 }
 
-void UpdateManager::ShareRemoveObject(const ObjectId& objId)
+/// \details Players are grouped into spatial partitions, and each partition is
+/// flushed as one job. Jobs only modify the share infos of their own players,
+/// and the share info mutex is held until all jobs are finished, so the map
+/// and grid can't change while flushing. Shares that arrive after the flush
+/// was started are deferred and applied in the merge phase after all jobs
+/// finished; shares that already hold the lock are finished before flushing.
+void UpdateManager::FlushUpdates(const TimeIndex& timeIndex, ThreadPool* pWorkerPool)
 {
-   ATLASSERT(m_mapShareInfo.find(objId) != m_mapShareInfo.end()); // must be in map
+   // set flag before locking the share infos, so that shares arriving while
+   // waiting for the lock are deferred, too, and don't wait for the whole flush
+   {
+      std::lock_guard<std::mutex> lockDeferred(m_mtxDeferredShares);
+      m_bFlushRunning = true;
+   }
+
+   RecursiveMutex::LockType lock(m_mtxShareInfo);
 
-   // remove from map
-   m_mapShareInfo.erase(objId);
+   // partition phase
+   std::map<std::pair<int, int>, T_vecPartition> mapPartitions;
 
-   // go through all objects and check if they should be updated
-   std::map<ObjectId, ShareInfo>::iterator iter = m_mapShareInfo.begin(), stop = m_mapShareInfo.end();
-   for (; iter != stop; ++iter)
+   for (size_t i=0, iMax=m_registryShareInfo.Size(); i<iMax; i++)
    {
-      if (!InUpdateDistance(iter->first, objId))
+      const ShareInfo& shareInfo = m_registryShareInfo.ValueAt(i);
+      if (shareInfo.m_vecQueuedBuffers.empty() && shareInfo.m_mapQueuedMovement.empty())
          continue;
 
-      if (CheckLastUpdate(iter->first, lastUpdateAddRemoveObject))
-      {
-         // update object
-         std::weak_ptr<Session> wpSession =
-            m_sessionManager.FindSession(iter->first);
+      std::pair<int, int> partitionKey(
+         static_cast<int>(std::floor(shareInfo.m_vPos.X() / c_dPartitionSize)),
+         static_cast<int>(std::floor(shareInfo.m_vPos.Z() / c_dPartitionSize)));
 
-         std::shared_ptr<Session> spSession = wpSession.lock();
-         if (spSession == NULL)
-            continue;
+      mapPartitions[partitionKey].push_back(i);
+   }
 
-         std::vector<ObjectPtr> vecObjectsToAdd;
-         std::vector<ObjectId> vecObjectsToRemove;
-         vecObjectsToRemove.push_back(objId);
+   JobBatch jobBatch(pWorkerPool);
 
-         AddRemoveObjectMessage msg(vecObjectsToAdd, vecObjectsToRemove);
-         spSession->SendMessage(msg);
-      }
-      else
-      {
-         // TODO: postpone update
-         ATLASSERT(false);
-      }
+   std::for_each(mapPartitions.begin(), mapPartitions.end(),
+      [&](const std::pair<const std::pair<int, int>, T_vecPartition>& partition)
+   {
+      jobBatch.Add(std::bind(&UpdateManager::FlushPartition, this, std::cref(partition.second), std::cref(timeIndex)));
+   });
+
+   try
+   {
+      jobBatch.Run();
+   }
+   catch (...)
+   {
+      ApplyDeferredShares();
+      throw;
    }
+
+   // all jobs finished looking up sessions
+   m_sessionManager.OnLookupsFinished();
+
+   // merge phase
+   ApplyDeferredShares();
 }
 
-bool UpdateManager::InUpdateDistance(const ObjectId& objId1, ObjectPtr spObj2)
+void UpdateManager::FlushPartition(const T_vecPartition& vecPartition, const TimeIndex& timeIndex)
 {
-   ATLASSERT(m_mapShareInfo.find(objId1) != m_mapShareInfo.end());
+   // players that got the same updates share the same baseline; serialize
+   // movement delta only once for each distinct baseline
+   T_mapDeltaBuffers mapDeltaBuffers;
 
-   const ShareInfo& info1 = m_mapShareInfo[objId1];
-
-   return (info1.m_vPos - spObj2->Pos()).Length() < c_dMaxVisibleDistance;
+   for (size_t i=0, iMax=vecPartition.size(); i<iMax; i++)
+   {
+      size_t uiIndex = vecPartition[i];
+      FlushShareInfo(m_registryShareInfo.IdAt(uiIndex), m_registryShareInfo.ValueAt(uiIndex), timeIndex, mapDeltaBuffers);
+   }
 }
 
-bool UpdateManager::InUpdateDistance(const ObjectId& objId1, const ObjectId& objId2)
+/// \details Queued messages are sent in order; when the update rate for a
+/// message type doesn't allow sending, this and all following messages stay in
+/// the queue. Queued movement is serialized as delta to the baseline of the
+/// player. All messages for a player are sent as one buffer.
+void UpdateManager::FlushShareInfo(const ObjectId& objId, ShareInfo& shareInfo, const TimeIndex& timeIndex,
+   T_mapDeltaBuffers& mapDeltaBuffers)
 {
-   ATLASSERT(m_mapShareInfo.find(objId1) != m_mapShareInfo.end());
-   ATLASSERT(m_mapShareInfo.find(objId2) != m_mapShareInfo.end());
+   std::shared_ptr<Session> spSession = m_sessionManager.FindSession(objId).lock();
+   if (spSession == NULL)
+   {
+      // no session (anymore); nobody to send updates to
+      shareInfo.m_vecQueuedBuffers.clear();
+      shareInfo.m_mapQueuedMovement.clear();
+      return;
+   }
 
-   const ShareInfo& info1 = m_mapShareInfo[objId1];
-   const ShareInfo& info2 = m_mapShareInfo[objId2];
+   std::array<bool, lastUpdateMax> abUpdated;
+   abUpdated.fill(false);
 
-   return (info1.m_vPos - info2.m_vPos).Length() < c_dMaxVisibleDistance;
+   std::vector<unsigned char> vecBatch;
+
+   // queued messages
+   std::vector<QueuedBuffer>::iterator iterQueued = shareInfo.m_vecQueuedBuffers.begin();
+   for (; iterQueued != shareInfo.m_vecQueuedBuffers.end(); ++iterQueued)
+   {
+      if (!CheckLastUpdate(shareInfo, iterQueued->m_enUpdateType, timeIndex))
+         break; // postpone update
+
+      const std::vector<unsigned char>& vecData = iterQueued->m_buffer.Data();
+      vecBatch.insert(vecBatch.end(), vecData.begin(), vecData.end());
+
+      abUpdated[iterQueued->m_enUpdateType] = true;
+   }
+
+   shareInfo.m_vecQueuedBuffers.erase(shareInfo.m_vecQueuedBuffers.begin(), iterQueued);
+
+   // queued movement; when the client lags behind, movement stays queued
+   // and is coalesced with newer movement, until the send queue drains
+   if (!shareInfo.m_mapQueuedMovement.empty() &&
+       !spSession->IsSendQueueAboveHighWaterMark() &&
+       CheckLastUpdate(shareInfo, lastUpdateMovement, timeIndex))
+   {
+      std::for_each(shareInfo.m_mapQueuedMovement.begin(), shareInfo.m_mapQueuedMovement.end(),
+         [&](const std::pair<const ObjectId, MovementSnapshot>& movement)
+      {
+         const ObjectId& movedObjId = movement.first;
+         const MovementSnapshot& snapshot = movement.second;
+
+         const MovementSnapshot& baseline = shareInfo.m_movementBaselines.Baseline(movedObjId);
+         if (baseline == snapshot)
+            return; // player already knows this movement
+
+         const std::vector<unsigned char>& vecData =
+            GetDeltaBuffer(mapDeltaBuffers, movedObjId, snapshot, baseline).Data();
+         vecBatch.insert(vecBatch.end(), vecData.begin(), vecData.end());
+
+         shareInfo.m_movementBaselines.Update(movedObjId, snapshot);
+
+         // the player starts predicting the movement when it's sent
+         shareInfo.m_mapBaselineTimes[movedObjId] = timeIndex;
+      });
+
+      shareInfo.m_mapQueuedMovement.clear();
+
+      abUpdated[lastUpdateMovement] = true;
+   }
+
+   for (size_t i = 0; i < lastUpdateMax; i++)
+      if (abUpdated[i])
+         shareInfo.m_aLastUpdated[i] = timeIndex;
+
+   if (!vecBatch.empty())
+      spSession->SendBuffer(SharedConstBuffer(std::move(vecBatch)));
 }
 
-bool UpdateManager::CheckLastUpdate(const ObjectId& /*objId*/, T_enLastUpdateType /*enLastAction*/)
+bool UpdateManager::CheckLastUpdate(const ShareInfo& shareInfo, T_enLastUpdateType enUpdateType,
+   const TimeIndex& timeIndex)
 {
-   return true;
+   double dElapsed = timeIndex.Get() - shareInfo.m_aLastUpdated[enUpdateType].Get();
+   return dElapsed >= c_adMinUpdateInterval[enUpdateType];
+}
+
+const SharedConstBuffer& UpdateManager::GetDeltaBuffer(T_mapDeltaBuffers& mapDeltaBuffers,
+   const ObjectId& objId, const MovementSnapshot& snapshot, const MovementSnapshot& baseline)
+{
+   std::vector<DeltaBuffer>& vecDeltaBuffers = mapDeltaBuffers[objId];
+
+   std::vector<DeltaBuffer>::const_iterator iter =
+      std::find_if(vecDeltaBuffers.begin(), vecDeltaBuffers.end(), [&](const DeltaBuffer& deltaBuffer)
+   {
+      return deltaBuffer.m_snapshot == snapshot && deltaBuffer.m_baseline == baseline;
+   });
+
+   if (iter != vecDeltaBuffers.end())
+      return iter->m_buffer;
+
+   UpdateObjectMovementDeltaMessage msg(objId, snapshot, baseline);
+   vecDeltaBuffers.push_back(DeltaBuffer(snapshot, baseline, Session::SerializeMessage(msg)));
+
+   return vecDeltaBuffers.back().m_buffer;
 }
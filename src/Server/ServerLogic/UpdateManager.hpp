@@ -11,9 +11,17 @@
 #include "Object.hpp"
 #include "ISessionManager.hpp"
 #include "TimeBase.hpp"
+#include "SpatialGrid.hpp"
+#include "MovementBaselineMap.hpp"
+#include "SharedBuffer.hpp"
+#include "ObjectRegistry.hpp"
+#include <ulib/thread/RecursiveMutex.hpp>
+#include <mutex>
+#include <functional>
 
 // forward references
 class MovementInfo;
+class ThreadPool;
 
 /// \brief update manager for game state
 /// \details This is probably the most important class in the server code; it
@@ -23,6 +31,18 @@ class MovementInfo;
 /// * Manages action updates of players
 /// * Manages visibility of players (who can see who)
 /// * Manages rate of updates for all players
+/// * Manages movement baselines, so that only movement deltas are sent
+/// * Manages dead reckoning, so that movement is only sent when it changed or
+///   when the movement a player predicts from the last sent movement is off
+/// Objects are stored in a spatial grid, so that updates only have to check
+/// the objects in the neighbouring cells, not all objects.
+/// Updates are not sent immediately, but queued for each player and sent in
+/// one batch per player when FlushUpdates() is called in the world tick.
+/// Queued movement of an object is replaced by newer movement; movement is
+/// also kept queued while a player's session is above its send high-water mark.
+/// Flushing is done in spatial partitions, which are processed in parallel;
+/// updates that are shared while flushing are deferred to a merge phase after
+/// all partitions are flushed, so that they don't block the session threads.
 class UpdateManager
 {
 public:
@@ -31,8 +51,12 @@ public:
    /// dtor
    ~UpdateManager() {}
 
-   /// shares movement update
-   void ShareUpdateMovement(const ObjectId& objId, const MovementInfo& info);
+   /// shares movement update; time index is the time the movement info is valid
+   void ShareUpdateMovement(const ObjectId& objId, const MovementInfo& info, const TimeIndex& timeIndex);
+
+   /// sets maximum position error (in units) and view angle error (in degrees)
+   /// of predicted movement, before a movement correction is sent
+   void SetMaxMovementError(double dMaxPositionError, double dMaxAngleError);
 
    /// shares action
    void ShareAction(ActionPtr spAction);
@@ -43,12 +67,17 @@ public:
    /// shares removing object
    void ShareRemoveObject(const ObjectId& objId);
 
+   /// sends all queued updates whose update rate allows it; called once per world tick;
+   /// partitions are flushed on the worker pool, or on the calling thread only when no pool is given
+   void FlushUpdates(const TimeIndex& timeIndex, ThreadPool* pWorkerPool = nullptr);
+
 private:
-   /// returns if two objects are in update distance
-   bool InUpdateDistance(const ObjectId& objId1, ObjectPtr spObj2);
+   /// returns if two positions are in update distance
+   static bool InUpdateDistance(const Vector3d& vPos1, const Vector3d& vPos2);
 
-   /// returns if two objects are in update distance
-   bool InUpdateDistance(const ObjectId& objId1, const ObjectId& objId2);
+   /// calls function for all objects in update distance to given position
+   template <typename TFunc>
+   void ForEachInUpdateDistance(const Vector3d& vPos, TFunc fn);
 
    /// type of last update
    enum T_enLastUpdateType
@@ -60,13 +89,77 @@ private:
       lastUpdateMax
    };
 
-   /// check if update should be postponed (or dropped)
-   bool CheckLastUpdate(const ObjectId& objId, T_enLastUpdateType lastAction);
+   /// player share info; see below
+   struct ShareInfo;
+
+   /// check if update should be sent now or postponed
+   static bool CheckLastUpdate(const ShareInfo& shareInfo, T_enLastUpdateType enUpdateType,
+      const TimeIndex& timeIndex);
+
+   /// serialized movement update of an object, relative to a baseline
+   struct DeltaBuffer;
+
+   /// map with serialized movement updates
+   typedef std::map<ObjectId, std::vector<DeltaBuffer>> T_mapDeltaBuffers;
+
+   /// returns serialized movement update of object, relative to baseline
+   static const SharedConstBuffer& GetDeltaBuffer(T_mapDeltaBuffers& mapDeltaBuffers,
+      const ObjectId& objId, const MovementSnapshot& snapshot, const MovementSnapshot& baseline);
+
+   /// share function, deferred while flushing
+   typedef std::function<void()> T_fnShare;
+
+   /// defers share function when a flush is running; returns false when share can be done now
+   bool DeferWhileFlushing(T_fnShare fnShare);
+
+   /// carries out all share functions deferred while flushing
+   void ApplyDeferredShares();
+
+   /// checks if movement parameters changed, apart from position and direction
+   static bool IsMovementChanged(const MovementInfo& knownInfo, const MovementInfo& info);
+
+   /// checks if player must get movement of object, since the movement it
+   /// predicts from the last movement sent to it differs too much
+   bool IsCorrectionNeeded(const ShareInfo& shareInfo, const ObjectId& movedObjId,
+      const MovementInfo& info, const TimeIndex& timeIndex) const;
+
+   /// shares movement update; share info mutex must be locked
+   void DoShareUpdateMovement(const ObjectId& objId, const MovementInfo& info, const TimeIndex& timeIndex);
+
+   /// shares action; share info mutex must be locked
+   void DoShareAction(ActionPtr spAction);
+
+   /// shares adding object; share info mutex must be locked
+   void DoShareAddObject(ObjectPtr spObj);
+
+   /// shares removing object; share info mutex must be locked
+   void DoShareRemoveObject(const ObjectId& objId);
 
 private:
    /// session manager
    ISessionManager& m_sessionManager;
 
+   /// mutex to protect share infos and spatial grid; updates are shared from
+   /// session threads, but flushed from the world runner thread
+   RecursiveMutex m_mtxShareInfo;
+
+   /// queued update message
+   struct QueuedBuffer
+   {
+      /// ctor
+      QueuedBuffer(T_enLastUpdateType enUpdateType, const SharedConstBuffer& buffer)
+         :m_enUpdateType(enUpdateType),
+          m_buffer(buffer)
+      {
+      }
+
+      /// update type
+      T_enLastUpdateType m_enUpdateType;
+
+      /// serialized message
+      SharedConstBuffer m_buffer;
+   };
+
    /// player share info
    struct ShareInfo
    {
@@ -81,8 +174,51 @@ private:
 
       /// array with last updated time indices
       std::array<TimeIndex, lastUpdateMax> m_aLastUpdated;
+
+      /// movement baselines of other objects, as last sent to this object's session
+      MovementBaselineMap m_movementBaselines;
+
+      /// time indices when the movement baselines of other objects were sent
+      std::map<ObjectId, TimeIndex> m_mapBaselineTimes;
+
+      /// queued action and add/remove object messages, in order
+      std::vector<QueuedBuffer> m_vecQueuedBuffers;
+
+      /// queued movement of other objects; only the newest movement is kept
+      std::map<ObjectId, MovementSnapshot> m_mapQueuedMovement;
    };
 
-   /// share infos of all objects
-   std::map<ObjectId, ShareInfo> m_mapShareInfo;
+   /// share info registry type
+   typedef ObjectRegistry<ShareInfo> T_registryShareInfo;
+
+   /// dense indices of the share infos of players in a spatial partition
+   typedef std::vector<size_t> T_vecPartition;
+
+   /// flushes updates of all players in a partition; runs as job on a worker thread
+   void FlushPartition(const T_vecPartition& vecPartition, const TimeIndex& timeIndex);
+
+   /// flushes updates of a single player
+   void FlushShareInfo(const ObjectId& objId, ShareInfo& shareInfo, const TimeIndex& timeIndex,
+      T_mapDeltaBuffers& mapDeltaBuffers);
+
+   /// share infos of all objects; stored densely, so that flushing iterates linearly
+   T_registryShareInfo m_registryShareInfo;
+
+   /// spatial grid with all objects, indexed by ShareInfo::m_vPos
+   SpatialGrid m_spatialGrid;
+
+   /// maximum position error of predicted movement, in units
+   double m_dMaxPositionError;
+
+   /// maximum view angle error of predicted movement, in degrees
+   double m_dMaxAngleError;
+
+   /// mutex to protect flush running flag and deferred shares
+   std::mutex m_mtxDeferredShares;
+
+   /// indicates if a flush is currently running
+   bool m_bFlushRunning;
+
+   /// share functions deferred while flushing, in order
+   std::vector<T_fnShare> m_vecDeferredShares;
 };
@@ -9,6 +9,12 @@
 #include "StdAfx.h"
 #include "WorldModel.hpp"
 #include "IActionQueue.hpp"
+#include "JobBatch.hpp"
+
+/// \brief number of mobiles that are moved in one job
+/// \details large enough that scheduling a job costs little compared to the
+/// vectorized loops of MovementIntegrator::Advance()
+static const size_t c_uiMobilesPerMovementJob = 4096;
 
 void WorldModel::InitialUpdate(MobilePtr spPlayer)
 {
@@ -16,9 +22,70 @@ void WorldModel::InitialUpdate(MobilePtr spPlayer)
    ATLASSERT(false);
 }
 
-void WorldModel::Tick(const TimeIndex& /*timeIndex*/)
+void WorldModel::Tick(const TimeIndex& timeIndex)
+{
+   TickWorld(timeIndex, nullptr);
+}
+
+void WorldModel::Tick(const TimeIndex& timeIndex, ThreadPool& tickWorkerPool)
+{
+   TickWorld(timeIndex, &tickWorkerPool);
+}
+
+void WorldModel::TickWorld(const TimeIndex& timeIndex, ThreadPool* pTickWorkerPool)
 {
    // TODO call storyboard
+
+   // move all mobiles to their current position
+   {
+      ScopedMetricTimer timer(&m_metricsManager, m_idTickMovementTime);
+
+      RecursiveMutex::LockType lock(m_mtxObjectMap);
+
+      // split mobiles into index ranges that are moved in parallel
+      JobBatch jobBatch(pTickWorkerPool);
+
+      size_t uiNumMobiles = m_movementIntegrator.Size();
+      for (size_t uiStart=0; uiStart<uiNumMobiles; uiStart += c_uiMobilesPerMovementJob)
+      {
+         size_t uiEnd = std::min(uiStart + c_uiMobilesPerMovementJob, uiNumMobiles);
+
+         jobBatch.Add([this, &timeIndex, uiStart, uiEnd]()
+         {
+            m_movementIntegrator.Advance(timeIndex, uiStart, uiEnd);
+            m_movementIntegrator.WritePositions(uiStart, uiEnd);
+         });
+      }
+
+      jobBatch.Run();
+   }
+
+   // queue all timed actions that are due
+   {
+      ScopedMetricTimer timer(&m_metricsManager, m_idTickTimedActionsTime);
+
+      {
+         RecursiveMutex::LockType lock(m_mtxTimedActions);
+         m_timedActionScheduler.Advance(timeIndex, m_vecExpiredActions);
+      }
+
+      for (size_t i=0,iMax=m_vecExpiredActions.size(); i<iMax; i++)
+         QueueAction(m_vecExpiredActions[i]);
+
+      m_vecExpiredActions.clear();
+   }
+
+   // send out all updates collected since last tick
+   {
+      ScopedMetricTimer timer(&m_metricsManager, m_idTickUpdateTime);
+      m_updateManager.FlushUpdates(timeIndex, pTickWorkerPool);
+   }
+
+   // hand over changed object states to the database write thread
+   {
+      ScopedMetricTimer timer(&m_metricsManager, m_idTickPersistenceTime);
+      m_persistenceQueue.Tick(timeIndex);
+   }
 }
 
 void WorldModel::ReceiveAction(ActionPtr spAction)
@@ -45,7 +112,17 @@ void WorldModel::AddRemoveObject(const std::vector<ObjectPtr>& vecObjectsToAdd,
 
       {
          RecursiveMutex::LockType lock(m_mtxObjectMap);
+
+         // store last state of object
+         m_persistenceQueue.QueueObject(m_objectMap.Get(objId));
+
          m_objectMap.RemoveObject(objId);
+         m_movementIntegrator.Remove(objId);
+      }
+
+      {
+         RecursiveMutex::LockType lock(m_mtxTimedActions);
+         m_timedActionScheduler.CancelAll(objId);
       }
 
       m_updateManager.ShareRemoveObject(objId);
@@ -58,8 +135,14 @@ void WorldModel::AddRemoveObject(const std::vector<ObjectPtr>& vecObjectsToAdd,
       {
          RecursiveMutex::LockType lock(m_mtxObjectMap);
          m_objectMap.AddObject(spObj);
+
+         MobilePtr spMobile = std::dynamic_pointer_cast<Mobile>(spObj);
+         if (spMobile != NULL)
+            m_movementIntegrator.Add(spMobile, m_timeBase.Now());
       }
 
+      m_persistenceQueue.QueueObject(spObj);
+
       m_updateManager.ShareAddObject(spObj);
    }
 }
@@ -67,12 +150,40 @@ void WorldModel::AddRemoveObject(const std::vector<ObjectPtr>& vecObjectsToAdd,
 /// \details called when an object updated its position or movement info
 void WorldModel::UpdateObjectMovement(const ObjectId& id, const MovementInfo& info)
 {
-   CString cszText;
-   cszText.Format(_T("got update message from: %s"), id.ToString().GetString());
-   LOG_INFO(cszText, Log::Server::World::Player);
-
    // determine who should get update message
-   m_updateManager.ShareUpdateMovement(id, info);
+   m_updateManager.ShareUpdateMovement(id, info, m_timeBase.Now());
+
+   {
+      RecursiveMutex::LockType lock(m_mtxObjectMap);
+
+      ObjectHandle handle = m_objectMap.FindHandle(id);
+      if (handle.IsSet())
+         m_persistenceQueue.QueueMovement(m_objectMap.Get(handle), info);
+
+      m_movementIntegrator.UpdateMovement(id, info, m_timeBase.Now());
+   }
+}
+
+TimedActionHandle WorldModel::ScheduleAction(const TimeIndex& dueTime, ActionPtr spAction,
+   const ObjectId& ownerId)
+{
+   RecursiveMutex::LockType lock(m_mtxTimedActions);
+   return m_timedActionScheduler.Schedule(dueTime, spAction, ownerId);
+}
+
+/// \details Used for effects over time, e.g. for a damage over time spell
+/// effect, with TickTime() as interval and NumTicks() as number of times.
+TimedActionHandle WorldModel::SchedulePeriodicAction(const TimeIndex& firstDueTime, double dInterval,
+   unsigned int uiNumTimes, ActionPtr spAction, const ObjectId& ownerId)
+{
+   RecursiveMutex::LockType lock(m_mtxTimedActions);
+   return m_timedActionScheduler.SchedulePeriodic(firstDueTime, dInterval, uiNumTimes, spAction, ownerId);
+}
+
+bool WorldModel::CancelTimedAction(const TimedActionHandle& handle)
+{
+   RecursiveMutex::LockType lock(m_mtxTimedActions);
+   return m_timedActionScheduler.Cancel(handle);
 }
 
 void WorldModel::QueueAction(ActionPtr spAction)
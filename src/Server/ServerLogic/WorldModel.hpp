@@ -12,21 +12,37 @@
 #include "ObjectMap.hpp"
 #include "CommandTranslator.hpp"
 #include "UpdateManager.hpp"
+#include "PersistenceQueue.hpp"
+#include "MetricsManager.hpp"
+#include "MovementIntegrator.hpp"
+#include "TimedActionScheduler.hpp"
 #include <ulib/thread/RecursiveMutex.hpp>
 
 // forward references
 class ISessionManager;
 class IActionQueue;
+class ThreadPool;
+namespace Database
+{
+class Manager;
+}
 
 /// world model
 class SERVERLOGIC_DECLSPEC WorldModel: public IModel
 {
 public:
-   /// ctor
-   WorldModel(ISessionManager& sessionManager, IActionQueue& actionQueue)
+   /// ctor; the time used for the tick phases is stored in the metrics manager
+   WorldModel(ISessionManager& sessionManager, IActionQueue& actionQueue,
+      Database::Manager& databaseManager, MetricsManager& metricsManager)
       :m_actionQueue(actionQueue),
        m_commandTranslator(*this),
-       m_updateManager(sessionManager)
+       m_updateManager(sessionManager),
+       m_persistenceQueue(databaseManager),
+       m_metricsManager(metricsManager),
+       m_idTickMovementTime(metricsManager.Register(Metrics::Server::TickMovementTime, storeTypeTimeline)),
+       m_idTickTimedActionsTime(metricsManager.Register(Metrics::Server::TickTimedActionsTime, storeTypeTimeline)),
+       m_idTickUpdateTime(metricsManager.Register(Metrics::Server::TickUpdateTime, storeTypeTimeline)),
+       m_idTickPersistenceTime(metricsManager.Register(Metrics::Server::TickPersistenceTime, storeTypeTimeline))
    {
    }
 
@@ -40,7 +56,29 @@ public:
       const std::vector<ObjectId>& vecObjectsToRemove) override;
    virtual void UpdateObjectMovement(const ObjectId& id, const MovementInfo& info) override;
 
+   /// ticks world; partitions of the world are processed in parallel on the worker pool
+   void Tick(const TimeIndex& timeIndex, ThreadPool& tickWorkerPool);
+
+   /// returns time base that the world is ticked with
+   const TimeBase& GetTimeBase() const { return m_timeBase; }
+
+   // timed actions
+
+   /// schedules action to be queued at given time index; the action is cancelled when the
+   /// owner object is removed
+   TimedActionHandle ScheduleAction(const TimeIndex& dueTime, ActionPtr spAction, const ObjectId& ownerId);
+
+   /// schedules action to be queued uiNumTimes times, in given interval in seconds
+   TimedActionHandle SchedulePeriodicAction(const TimeIndex& firstDueTime, double dInterval,
+      unsigned int uiNumTimes, ActionPtr spAction, const ObjectId& ownerId);
+
+   /// cancels scheduled action; returns false when the action already expired
+   bool CancelTimedAction(const TimedActionHandle& handle);
+
 private:
+   /// ticks world, using worker pool when given
+   void TickWorld(const TimeIndex& timeIndex, ThreadPool* pTickWorkerPool);
+
    /// queues action
    void QueueAction(ActionPtr spAction);
 
@@ -51,6 +89,24 @@ private:
    /// object map
    ObjectMap m_objectMap;
 
+   /// time base; movement start times and tick time indices are taken from it
+   TimeBase m_timeBase;
+
+   /// \brief moves all mobiles in the object map; protected by object map mutex
+   /// \details Positions are written in the world tick, with each mobile locked;
+   /// other threads lock the object before reading its position. Object locks
+   /// are always taken after the object map mutex.
+   MovementIntegrator m_movementIntegrator;
+
+   /// mutex to protect timed action scheduler
+   RecursiveMutex m_mtxTimedActions;
+
+   /// timed actions; expired actions are queued in the world tick
+   TimedActionScheduler m_timedActionScheduler;
+
+   /// timed actions that expired in the current tick; only used in the world tick
+   std::vector<ActionPtr> m_vecExpiredActions;
+
    /// action queue interface
    IActionQueue& m_actionQueue;
 
@@ -59,4 +115,22 @@ private:
 
    /// update manager
    UpdateManager m_updateManager;
+
+   /// write-behind queue for object states
+   PersistenceQueue m_persistenceQueue;
+
+   /// metrics manager
+   MetricsManager& m_metricsManager;
+
+   /// metric id for time used for moving mobiles
+   MetricId m_idTickMovementTime;
+
+   /// metric id for time used for expiring timed actions
+   MetricId m_idTickTimedActionsTime;
+
+   /// metric id for time used for sending out updates
+   MetricId m_idTickUpdateTime;
+
+   /// metric id for time used for queueing object states
+   MetricId m_idTickPersistenceTime;
 };
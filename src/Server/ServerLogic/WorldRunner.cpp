@@ -13,6 +13,9 @@
 /// world tick cycle, in milliseconds
 const unsigned int c_uiWorldTickCycleInMilliseconds = 100;
 
+/// number of world ticks after which tick metrics are logged; one minute
+const unsigned int c_uiLogTickMetricsNumTicks = 600;
+
 void WorldRunner::Start()
 {
    m_timerWorldTick.expires_from_now(boost::posix_time::milliseconds(c_uiWorldTickCycleInMilliseconds));
@@ -21,6 +24,11 @@ void WorldRunner::Start()
       std::bind(&WorldRunner::OnTimerWorldTick, this, std::placeholders::_1));
 
    m_ioServiceThread.Run();
+
+   CString cszText;
+   cszText.Format(_T("Running world tick on %u threads"),
+      static_cast<unsigned int>(m_tickWorkerPool.NumThreads() + 1));
+   LOG_INFO(cszText, Log::Server::General);
 }
 
 void WorldRunner::Stop()
@@ -52,18 +60,56 @@ void WorldRunner::ProcessWorldTick()
    HighResolutionTimer timerTick;
    timerTick.Start();
 
-   m_worldModel.Tick(m_timeBase.Now());
+   m_worldModel.Tick(m_worldModel.GetTimeBase().Now(), m_tickWorkerPool);
 
    timerTick.Stop();
 
+   m_metricsManager.Set(m_idTickTime, static_cast<unsigned int>(timerTick.Elapsed() * 1000000.0));
+
    // check elapsed time if processing took >= 80%
    if (timerTick.Elapsed() >= c_uiWorldTickCycleInMilliseconds / 1000.0 * 0.8)
    {
+      // current values of the phase metrics are the ones of this tick
       CString cszText;
-      cszText.Format(_T("WorldModel::Tick() used %u ms of %u ms"),
+      cszText.Format(_T("WorldModel::Tick() used %u ms of %u ms (movement: %u ms, timed actions: %u ms, updates: %u ms, persistence: %u ms)"),
          static_cast<unsigned int>(timerTick.Elapsed() * 1000),
-         c_uiWorldTickCycleInMilliseconds);
+         c_uiWorldTickCycleInMilliseconds,
+         m_metricsManager.Get(Metrics::Server::TickMovementTime) / 1000,
+         m_metricsManager.Get(Metrics::Server::TickTimedActionsTime) / 1000,
+         m_metricsManager.Get(Metrics::Server::TickUpdateTime) / 1000,
+         m_metricsManager.Get(Metrics::Server::TickPersistenceTime) / 1000);
 
       LOG_WARN(cszText, Log::Server::General)
    }
+
+   if (++m_uiNumTicks % c_uiLogTickMetricsNumTicks == 0)
+      LogTickMetrics();
+}
+
+void WorldRunner::LogTickMetrics()
+{
+   LPCTSTR apszMetricNames[] =
+   {
+      Metrics::Server::TickTime,
+      Metrics::Server::TickMovementTime,
+      Metrics::Server::TickTimedActionsTime,
+      Metrics::Server::TickUpdateTime,
+      Metrics::Server::TickPersistenceTime,
+      Metrics::Server::ActionTime,
+   };
+
+   for (size_t i=0; i<sizeof(apszMetricNames)/sizeof(*apszMetricNames); i++)
+   {
+      MetricTimeline timeline = m_metricsManager.TakeTimeline(apszMetricNames[i]);
+
+      CString cszText;
+      cszText.Format(_T("%s: p50 %u us, p99 %u us, max %u us, %u samples"),
+         apszMetricNames[i],
+         timeline.Percentile(50.0),
+         timeline.Percentile(99.0),
+         timeline.Max(),
+         timeline.Count());
+
+      LOG_INFO(cszText, Log::Server::General);
+   }
 }
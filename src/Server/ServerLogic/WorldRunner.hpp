@@ -9,19 +9,29 @@
 // includes
 #include "ServerLogic.hpp"
 #include "IoServiceThread.hpp"
+#include "ThreadPool.hpp"
 #include <ulib/thread/Event.hpp>
-#include "TimeBase.hpp"
+#include "MetricsManager.hpp"
 
 // forward references
 class WorldModel;
 
-/// world runner
+/// \brief world runner
+/// \details Ticks the world model in fixed intervals on the world runner
+/// thread; the world is split into partitions that are processed in parallel
+/// by the world runner thread and the tick worker threads. The time used for
+/// the tick and its phases is stored in the metrics manager, and percentiles
+/// of the stored times are logged periodically.
 class SERVERLOGIC_DECLSPEC WorldRunner
 {
 public:
    /// ctor
-   WorldRunner(WorldModel& worldModel)
+   WorldRunner(WorldModel& worldModel, MetricsManager& metricsManager)
       :m_worldModel(worldModel),
+       m_metricsManager(metricsManager),
+       m_idTickTime(metricsManager.Register(Metrics::Server::TickTime, storeTypeTimeline)),
+       m_uiNumTicks(0),
+       m_tickWorkerPool(std::max(std::thread::hardware_concurrency(), 2U) - 1),
        m_ioServiceThread(true, _T("World Runner Thread")),
        m_timerWorldTick(m_ioServiceThread.Get()),
        m_evtWaitEndTimer(false)
@@ -41,12 +51,25 @@ private:
    /// process world tick
    void ProcessWorldTick();
 
+   /// logs percentiles of tick times stored since last call, and starts new timelines
+   void LogTickMetrics();
+
 private:
    /// world model to run
    WorldModel& m_worldModel;
 
-   /// game time base
-   TimeBase m_timeBase;
+   /// metrics manager
+   MetricsManager& m_metricsManager;
+
+   /// metric id for time used for world tick
+   MetricId m_idTickTime;
+
+   /// number of ticks processed; only accessed on world runner thread
+   unsigned int m_uiNumTicks;
+
+   /// worker threads for processing world partitions; the world runner thread
+   /// also processes partitions, so there's one worker less than cores
+   ThreadPool m_tickWorkerPool;
 
    /// service thread
    IoServiceThread m_ioServiceThread;
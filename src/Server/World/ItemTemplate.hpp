@@ -230,7 +230,7 @@ public:
    unsigned int MaxDurability() const { return m_uiMaxDurability; }
 
    /// returns weapon item info
-   const WeaponItemInfo& WeaponItem()
+   const WeaponItemInfo& WeaponItem() const
    {
       ATLASSERT(m_spWeaponItemInfo != NULL);
       ATLASSERT(m_enItemType == itemTypeWeapon);
@@ -238,7 +238,7 @@ public:
    }
 
    /// returns armor item info
-   const ArmorItemInfo& ArmorItem()
+   const ArmorItemInfo& ArmorItem() const
    {
       ATLASSERT(m_spArmorItemInfo != NULL);
       ATLASSERT(m_enItemType == itemTypeArmor);
@@ -246,7 +246,7 @@ public:
    }
 
    /// returns consumable item info
-   const ConsumableItemInfo& ConsumableItem()
+   const ConsumableItemInfo& ConsumableItem() const
    {
       ATLASSERT(m_spConsumableItemInfo != NULL);
       ATLASSERT(m_enItemType == itemTypeConsumable);
@@ -254,7 +254,7 @@ public:
    }
 
    /// returns usable item info
-   const UsableItemInfo& UsableItem()
+   const UsableItemInfo& UsableItem() const
    {
       ATLASSERT(m_spUsableItemInfo != NULL);
       ATLASSERT(m_enItemType == itemTypeUsable);
@@ -262,7 +262,7 @@ public:
    }
 
    /// returns quest item info
-   const QuestItemInfo& QuestItem()
+   const QuestItemInfo& QuestItem() const
    {
       ATLASSERT(m_spQuestItemInfo != NULL);
       ATLASSERT(m_enItemType == itemTypeQuest);
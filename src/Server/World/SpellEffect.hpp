@@ -181,6 +181,13 @@ public:
       return m_uiTickTime;
    }
 
+   /// when not instant, returns number of effect ticks during the duration; at least 1
+   unsigned int NumTicks() const
+   {
+      ATLASSERT(IsInstant() == false);
+      return m_uiTickTime == 0 || m_uiDuration < m_uiTickTime ? 1 : m_uiDuration / m_uiTickTime;
+   }
+
    // set methods
 
    /// sets if effect is instant
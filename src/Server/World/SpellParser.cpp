@@ -104,7 +104,7 @@ std::shared_ptr<SpellEffect> SpellParser::ParseEffect()
    else
    if (cszToken == _T("heal"))
    {
-      std::shared_ptr<HealSpellEffect> spHealEffect;
+      std::shared_ptr<HealSpellEffect> spHealEffect(new HealSpellEffect);
 
       // heal value/range
       spHealEffect->ValueOrRange(ParseValueOrRange(m_tokenizer.Next()));
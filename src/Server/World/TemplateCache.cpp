@@ -0,0 +1,152 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file TemplateCache.cpp Compiled spell and item template cache
+//
+
+// includes
+#include "StdAfx.h"
+#include "TemplateCache.hpp"
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+static_assert(sizeof(TemplateCacheHeader) == 28, "template cache header layout must not change");
+static_assert(sizeof(SpellEffectRecord) == 20, "spell effect record layout must not change");
+static_assert(sizeof(SpellRecord) == 28, "spell record layout must not change");
+static_assert(sizeof(ItemTemplateRecord) == 24, "item template record layout must not change");
+
+/// memory-mapped template cache file
+struct TemplateCache::MappedFile
+{
+   /// ctor; maps whole file read-only
+   MappedFile(const char* pszFilename)
+      :m_file(pszFilename, boost::interprocess::read_only),
+       m_region(m_file, boost::interprocess::read_only)
+   {
+   }
+
+   /// file mapping
+   boost::interprocess::file_mapping m_file;
+
+   /// mapped region of the whole file
+   boost::interprocess::mapped_region m_region;
+};
+
+TemplateCache::TemplateCache()
+{
+   Reset();
+}
+
+TemplateCache::~TemplateCache()
+{
+}
+
+void TemplateCache::Load(const CString& cszFilename)
+{
+   Reset();
+   m_upMappedFile.reset();
+
+   try
+   {
+      m_upMappedFile.reset(new MappedFile(CStringA(cszFilename)));
+   }
+   catch (const boost::interprocess::interprocess_exception& ex)
+   {
+      throw Exception(_T("couldn't map template cache file ") + cszFilename + _T(": ") + CString(ex.what()),
+         __FILE__, __LINE__);
+   }
+
+   Attach(static_cast<const unsigned char*>(m_upMappedFile->m_region.get_address()),
+      m_upMappedFile->m_region.get_size());
+}
+
+/// \details Checks that the data has the size the header specifies, and that
+/// all indices are in range, so that lookups needn't check them again.
+void TemplateCache::Attach(const unsigned char* pData, size_t uiSize)
+{
+   Reset();
+
+   if (uiSize < sizeof(TemplateCacheHeader))
+      throw Exception(_T("template cache too small"), __FILE__, __LINE__);
+
+   const TemplateCacheHeader* pHeader = reinterpret_cast<const TemplateCacheHeader*>(pData);
+
+   if (pHeader->m_uiMagic != c_uiTemplateCacheMagic)
+      throw Exception(_T("invalid template cache"), __FILE__, __LINE__);
+
+   if (pHeader->m_uiVersion != c_uiTemplateCacheVersion)
+      throw Exception(_T("template cache has wrong version; recompile templates"), __FILE__, __LINE__);
+
+   unsigned long long ullExpectedSize = sizeof(TemplateCacheHeader) +
+      static_cast<unsigned long long>(pHeader->m_uiSpellIndexSize) * sizeof(unsigned int) +
+      static_cast<unsigned long long>(pHeader->m_uiNumSpells) * sizeof(SpellRecord) +
+      static_cast<unsigned long long>(pHeader->m_uiNumSpellEffects) * sizeof(SpellEffectRecord) +
+      static_cast<unsigned long long>(pHeader->m_uiItemTemplateIndexSize) * sizeof(unsigned int) +
+      static_cast<unsigned long long>(pHeader->m_uiNumItemTemplates) * sizeof(ItemTemplateRecord);
+
+   if (ullExpectedSize != uiSize)
+      throw Exception(_T("template cache has invalid size"), __FILE__, __LINE__);
+
+   const unsigned char* pCurrent = pData + sizeof(TemplateCacheHeader);
+
+   const unsigned int* puiSpellIndex = reinterpret_cast<const unsigned int*>(pCurrent);
+   pCurrent += pHeader->m_uiSpellIndexSize * sizeof(unsigned int);
+
+   const SpellRecord* pSpells = reinterpret_cast<const SpellRecord*>(pCurrent);
+   pCurrent += pHeader->m_uiNumSpells * sizeof(SpellRecord);
+
+   const SpellEffectRecord* pSpellEffects = reinterpret_cast<const SpellEffectRecord*>(pCurrent);
+   pCurrent += pHeader->m_uiNumSpellEffects * sizeof(SpellEffectRecord);
+
+   const unsigned int* puiItemTemplateIndex = reinterpret_cast<const unsigned int*>(pCurrent);
+   pCurrent += pHeader->m_uiItemTemplateIndexSize * sizeof(unsigned int);
+
+   const ItemTemplateRecord* pItemTemplates = reinterpret_cast<const ItemTemplateRecord*>(pCurrent);
+
+   CheckIndex(puiSpellIndex, pHeader->m_uiSpellIndexSize, pHeader->m_uiNumSpells);
+   CheckIndex(puiItemTemplateIndex, pHeader->m_uiItemTemplateIndexSize, pHeader->m_uiNumItemTemplates);
+
+   for (unsigned int ui=0; ui<pHeader->m_uiNumSpells; ui++)
+   {
+      const SpellRecord& spell = pSpells[ui];
+      if (spell.m_auiEffectIndex[0] >= pHeader->m_uiNumSpellEffects ||
+          (spell.HasEffect2() && spell.m_auiEffectIndex[1] >= pHeader->m_uiNumSpellEffects))
+         throw Exception(_T("template cache contains invalid spell effect index"), __FILE__, __LINE__);
+   }
+
+   for (unsigned int ui=0; ui<pHeader->m_uiNumSpellEffects; ui++)
+   {
+      const SpellEffectRecord& effect = pSpellEffects[ui];
+      if (effect.m_ucEffectType >= SpellEffect::typeMax ||
+          (effect.EffectType() == SpellEffect::typeDamage && effect.m_ucSubType >= DamageType::typeMax) ||
+          (effect.EffectType() == SpellEffect::typeDisable && effect.m_ucSubType >= DisableSpellEffect::disableMax))
+         throw Exception(_T("template cache contains invalid spell effect"), __FILE__, __LINE__);
+   }
+
+   m_pHeader = pHeader;
+   m_puiSpellIndex = puiSpellIndex;
+   m_pSpells = pSpells;
+   m_pSpellEffects = pSpellEffects;
+   m_puiItemTemplateIndex = puiItemTemplateIndex;
+   m_pItemTemplates = pItemTemplates;
+}
+
+void TemplateCache::CheckIndex(const unsigned int* puiIndex, unsigned int uiIndexSize, unsigned int uiNumRecords)
+{
+   for (unsigned int ui=0; ui<uiIndexSize; ui++)
+   {
+      if (puiIndex[ui] != c_uiTemplateCacheNoIndex && puiIndex[ui] >= uiNumRecords)
+         throw Exception(_T("template cache contains invalid index entry"), __FILE__, __LINE__);
+   }
+}
+
+void TemplateCache::Reset()
+{
+   m_pHeader = nullptr;
+   m_puiSpellIndex = nullptr;
+   m_pSpells = nullptr;
+   m_pSpellEffects = nullptr;
+   m_puiItemTemplateIndex = nullptr;
+   m_pItemTemplates = nullptr;
+}
@@ -0,0 +1,244 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file TemplateCache.hpp Compiled spell and item template cache
+//
+#pragma once
+
+// includes
+#include "World.hpp"
+#include "SpellEffect.hpp"
+#include "ItemTemplate.hpp"
+#include <memory>
+
+/// magic value at the start of a template cache; "MOGT"
+const unsigned int c_uiTemplateCacheMagic = 0x54474f4d;
+
+/// template cache format version; increase when any record layout changes
+const unsigned int c_uiTemplateCacheVersion = 1;
+
+/// index value for a missing spell, effect or item template
+const unsigned int c_uiTemplateCacheNoIndex = 0xffffffff;
+
+/// \brief template cache header
+/// \details The header is followed by the spell index, the spell records,
+/// the spell effect records, the item template index and the item template
+/// records. An index has one entry per id, containing the record index, or
+/// c_uiTemplateCacheNoIndex when there's no record with that id.
+struct TemplateCacheHeader
+{
+   unsigned int m_uiMagic;                ///< magic value; c_uiTemplateCacheMagic
+   unsigned int m_uiVersion;              ///< format version; c_uiTemplateCacheVersion
+   unsigned int m_uiSpellIndexSize;       ///< number of spell index entries; highest spell id + 1
+   unsigned int m_uiNumSpells;            ///< number of spell records
+   unsigned int m_uiNumSpellEffects;      ///< number of spell effect records
+   unsigned int m_uiItemTemplateIndexSize;///< number of item template index entries; highest template id + 1
+   unsigned int m_uiNumItemTemplates;     ///< number of item template records
+};
+
+/// compiled spell effect; replaces SpellEffect and its derived classes
+struct SpellEffectRecord
+{
+   /// flags for m_ucFlags
+   enum T_enFlags
+   {
+      flagRange = 1,    ///< value is a range
+      flagPercent = 2,  ///< value or range is in percent
+      flagInstant = 4,  ///< damage or heal effect is instant
+   };
+
+   unsigned char m_ucEffectType;    ///< effect type; see SpellEffect::T_enEffectType
+   unsigned char m_ucFlags;         ///< flags; see T_enFlags
+   unsigned char m_ucSubType;       ///< damage type for damage effects, disable type for disable effects
+   unsigned char m_ucRestriction;   ///< restriction flags for damage effects
+   int m_aiValues[2];               ///< value or range
+   unsigned int m_uiDuration;       ///< duration in seconds, when not instant
+   unsigned int m_uiTickTime;       ///< tick time in seconds, when not instant
+
+   /// returns effect type
+   SpellEffect::T_enEffectType EffectType() const
+   {
+      return static_cast<SpellEffect::T_enEffectType>(m_ucEffectType);
+   }
+
+   /// returns effect value or range
+   EffectValueOrRange ValueOrRange() const
+   {
+      EffectValueOrRange valueOrRange;
+      if ((m_ucFlags & flagRange) != 0)
+         valueOrRange.SetRange((m_ucFlags & flagPercent) != 0, m_aiValues[0], m_aiValues[1]);
+      else
+         valueOrRange.SetValue((m_ucFlags & flagPercent) != 0, m_aiValues[0]);
+
+      return valueOrRange;
+   }
+
+   /// returns if damage or heal effect is instant
+   bool IsInstant() const { return (m_ucFlags & flagInstant) != 0; }
+
+   /// returns damage type of damage effect
+   DamageType GetDamageType() const
+   {
+      ATLASSERT(EffectType() == SpellEffect::typeDamage);
+      return DamageType(static_cast<DamageType::T_enDamageType>(m_ucSubType));
+   }
+
+   /// returns disable type of disable effect
+   DisableSpellEffect::T_enDisableType DisableType() const
+   {
+      ATLASSERT(EffectType() == SpellEffect::typeDisable);
+      return static_cast<DisableSpellEffect::T_enDisableType>(m_ucSubType);
+   }
+};
+
+/// compiled spell; replaces Spell
+struct SpellRecord
+{
+   /// flags for m_uiFlags
+   enum T_enFlags
+   {
+      flagAreaSpell = 1,   ///< area spell; range defines area radius
+      flagStackable = 2,   ///< effect is stackable
+   };
+
+   unsigned int m_uiSpellId;        ///< spell id
+   unsigned int m_uiCooldown;       ///< cooldown time in seconds
+   unsigned int m_uiCastTime;       ///< cast time in seconds
+   unsigned int m_uiRange;          ///< range of spell in game units
+   unsigned int m_uiFlags;          ///< flags; see T_enFlags
+   unsigned int m_auiEffectIndex[2];///< indices of spell effect records; second may be c_uiTemplateCacheNoIndex
+
+   /// indicates if it's an area spell
+   bool IsAreaSpell() const { return (m_uiFlags & flagAreaSpell) != 0; }
+
+   /// indicates if effect is stackable
+   bool IsStackable() const { return (m_uiFlags & flagStackable) != 0; }
+
+   /// indicates if spell has a second effect
+   bool HasEffect2() const { return m_auiEffectIndex[1] != c_uiTemplateCacheNoIndex; }
+};
+
+/// compiled item template; replaces ItemTemplate
+struct ItemTemplateRecord
+{
+   unsigned int m_uiTemplateId;     ///< item template id
+   unsigned char m_ucItemType;      ///< item type; see ItemTemplate::T_enItemType
+   unsigned char m_ucEquipSlotType; ///< equip slot type; see T_enEquipSlotType
+   unsigned char m_ucSubType;       ///< attack type for weapons, armor type for armor
+   unsigned char m_ucReserved;      ///< reserved; always 0
+   unsigned int m_uiMaxDurability;  ///< max. durability; 0 for durable item
+   unsigned int m_auiValues[3];     ///< weapons: attack speed, value and variance; armor: armor value
+
+   /// returns item type
+   ItemTemplate::T_enItemType ItemType() const
+   {
+      return static_cast<ItemTemplate::T_enItemType>(m_ucItemType);
+   }
+
+   /// returns equip slot type
+   T_enEquipSlotType EquipSlotType() const
+   {
+      return static_cast<T_enEquipSlotType>(m_ucEquipSlotType);
+   }
+};
+
+/// \brief read-only cache of compiled spells and item templates
+/// \details The cache is a single binary blob that is produced offline by
+/// TemplateCacheCompiler. Loading memory-maps the file and only checks the
+/// header and the indices; records are accessed in place, so that no text is
+/// parsed and no objects are allocated at startup. Spells and item templates
+/// are found by id through flat index arrays. The blob uses the byte order of
+/// the machine that compiled it.
+class WORLD_DECLSPEC TemplateCache
+{
+public:
+   /// ctor; creates empty cache
+   TemplateCache();
+   /// dtor
+   ~TemplateCache();
+
+   /// loads cache by memory-mapping the file; throws on invalid file
+   void Load(const CString& cszFilename);
+
+   /// uses cache data in memory; the data must stay valid while the cache is used; throws on invalid data
+   void Attach(const unsigned char* pData, size_t uiSize);
+
+   // spells
+
+   /// returns number of spells
+   size_t NumSpells() const { return m_pHeader == nullptr ? 0 : m_pHeader->m_uiNumSpells; }
+
+   /// returns spell with given index
+   const SpellRecord& SpellAt(size_t uiIndex) const
+   {
+      ATLASSERT(uiIndex < NumSpells());
+      return m_pSpells[uiIndex];
+   }
+
+   /// returns spell with given id, or nullptr when there's no such spell
+   const SpellRecord* FindSpell(unsigned int uiSpellId) const
+   {
+      if (m_pHeader == nullptr || uiSpellId >= m_pHeader->m_uiSpellIndexSize)
+         return nullptr;
+
+      unsigned int uiIndex = m_puiSpellIndex[uiSpellId];
+      return uiIndex == c_uiTemplateCacheNoIndex ? nullptr : &m_pSpells[uiIndex];
+   }
+
+   /// returns first effect of spell
+   const SpellEffectRecord& Effect1(const SpellRecord& spell) const
+   {
+      return m_pSpellEffects[spell.m_auiEffectIndex[0]];
+   }
+
+   /// returns second effect of spell
+   const SpellEffectRecord& Effect2(const SpellRecord& spell) const
+   {
+      ATLASSERT(spell.HasEffect2() == true);
+      return m_pSpellEffects[spell.m_auiEffectIndex[1]];
+   }
+
+   // item templates
+
+   /// returns number of item templates
+   size_t NumItemTemplates() const { return m_pHeader == nullptr ? 0 : m_pHeader->m_uiNumItemTemplates; }
+
+   /// returns item template with given index
+   const ItemTemplateRecord& ItemTemplateAt(size_t uiIndex) const
+   {
+      ATLASSERT(uiIndex < NumItemTemplates());
+      return m_pItemTemplates[uiIndex];
+   }
+
+   /// returns item template with given id, or nullptr when there's no such template
+   const ItemTemplateRecord* FindItemTemplate(unsigned int uiTemplateId) const
+   {
+      if (m_pHeader == nullptr || uiTemplateId >= m_pHeader->m_uiItemTemplateIndexSize)
+         return nullptr;
+
+      unsigned int uiIndex = m_puiItemTemplateIndex[uiTemplateId];
+      return uiIndex == c_uiTemplateCacheNoIndex ? nullptr : &m_pItemTemplates[uiIndex];
+   }
+
+private:
+   /// checks index entries; throws when an entry is out of range
+   static void CheckIndex(const unsigned int* puiIndex, unsigned int uiIndexSize, unsigned int uiNumRecords);
+
+   /// resets all pointers to the cache data
+   void Reset();
+
+private:
+   /// memory-mapped file
+   struct MappedFile;
+
+   /// mapped file; null when the cache data was attached
+   std::unique_ptr<MappedFile> m_upMappedFile;
+
+   const TemplateCacheHeader* m_pHeader;           ///< header; null when cache is empty
+   const unsigned int* m_puiSpellIndex;            ///< spell index
+   const SpellRecord* m_pSpells;                   ///< spell records
+   const SpellEffectRecord* m_pSpellEffects;       ///< spell effect records
+   const unsigned int* m_puiItemTemplateIndex;     ///< item template index
+   const ItemTemplateRecord* m_pItemTemplates;     ///< item template records
+};
@@ -0,0 +1,207 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file TemplateCacheCompiler.cpp Compiler for spell and item template cache
+//
+
+// includes
+#include "StdAfx.h"
+#include "TemplateCacheCompiler.hpp"
+#include "Spell.hpp"
+#include "SpellParser.hpp"
+#include <ulib/stream/FileStream.hpp>
+
+/// max. number of index entries; limits spell and item template ids
+const unsigned int c_uiMaxIndexSize = 1 << 20;
+
+void TemplateCacheCompiler::AddSpell(const Spell& spell)
+{
+   AddToIndex(m_vecSpellIndex, spell.Id(), m_vecSpells.size());
+
+   SpellRecord record = {};
+   record.m_uiSpellId = spell.Id();
+   record.m_uiCooldown = spell.Cooldown();
+   record.m_uiCastTime = spell.CastTime();
+   record.m_uiRange = spell.Range();
+   record.m_uiFlags =
+      (spell.IsAreaSpell() ? SpellRecord::flagAreaSpell : 0) |
+      (spell.IsStackable() ? SpellRecord::flagStackable : 0);
+
+   record.m_auiEffectIndex[0] = static_cast<unsigned int>(m_vecSpellEffects.size());
+   m_vecSpellEffects.push_back(ConvertEffect(spell.Effect1()));
+
+   record.m_auiEffectIndex[1] = c_uiTemplateCacheNoIndex;
+   if (spell.HasEffect2())
+   {
+      record.m_auiEffectIndex[1] = static_cast<unsigned int>(m_vecSpellEffects.size());
+      m_vecSpellEffects.push_back(ConvertEffect(spell.Effect2()));
+   }
+
+   m_vecSpells.push_back(record);
+}
+
+void TemplateCacheCompiler::AddSpellText(LPCTSTR pszText)
+{
+   CString cszText(pszText);
+
+   int iPos = 0;
+   CString cszLine = cszText.Tokenize(_T("\r\n"), iPos);
+   while (iPos != -1)
+   {
+      cszLine.Trim();
+
+      if (!cszLine.IsEmpty() && cszLine[0] != _T('#'))
+      {
+         SpellParser parser;
+         std::shared_ptr<Spell> spSpell = parser.Parse(cszLine);
+         AddSpell(*spSpell);
+      }
+
+      cszLine = cszText.Tokenize(_T("\r\n"), iPos);
+   }
+}
+
+void TemplateCacheCompiler::AddItemTemplate(const ItemTemplate& itemTemplate)
+{
+   AddToIndex(m_vecItemTemplateIndex, itemTemplate.TemplateId(), m_vecItemTemplates.size());
+
+   ItemTemplateRecord record = {};
+   record.m_uiTemplateId = itemTemplate.TemplateId();
+   record.m_ucItemType = static_cast<unsigned char>(itemTemplate.ItemType());
+   record.m_ucEquipSlotType = static_cast<unsigned char>(itemTemplate.EquipSlotType());
+   record.m_uiMaxDurability = itemTemplate.MaxDurability();
+
+   switch (itemTemplate.ItemType())
+   {
+   case ItemTemplate::itemTypeWeapon:
+      {
+         const WeaponItemInfo& weapon = itemTemplate.WeaponItem();
+         record.m_ucSubType = static_cast<unsigned char>(weapon.AttackType());
+         record.m_auiValues[0] = weapon.AttackSpeed();
+         record.m_auiValues[1] = weapon.AttackValue();
+         record.m_auiValues[2] = weapon.AttackVariance();
+      }
+      break;
+
+   case ItemTemplate::itemTypeArmor:
+      {
+         const ArmorItemInfo& armor = itemTemplate.ArmorItem();
+         record.m_ucSubType = static_cast<unsigned char>(armor.ArmorType());
+         record.m_auiValues[0] = armor.ArmorValue();
+      }
+      break;
+
+   default:
+      break;
+   }
+
+   m_vecItemTemplates.push_back(record);
+}
+
+void TemplateCacheCompiler::Compile(std::vector<unsigned char>& vecData) const
+{
+   TemplateCacheHeader header = {};
+   header.m_uiMagic = c_uiTemplateCacheMagic;
+   header.m_uiVersion = c_uiTemplateCacheVersion;
+   header.m_uiSpellIndexSize = static_cast<unsigned int>(m_vecSpellIndex.size());
+   header.m_uiNumSpells = static_cast<unsigned int>(m_vecSpells.size());
+   header.m_uiNumSpellEffects = static_cast<unsigned int>(m_vecSpellEffects.size());
+   header.m_uiItemTemplateIndexSize = static_cast<unsigned int>(m_vecItemTemplateIndex.size());
+   header.m_uiNumItemTemplates = static_cast<unsigned int>(m_vecItemTemplates.size());
+
+   vecData.clear();
+
+   const unsigned char* pHeader = reinterpret_cast<const unsigned char*>(&header);
+   vecData.insert(vecData.end(), pHeader, pHeader + sizeof(header));
+
+   AppendRecords(vecData, m_vecSpellIndex);
+   AppendRecords(vecData, m_vecSpells);
+   AppendRecords(vecData, m_vecSpellEffects);
+   AppendRecords(vecData, m_vecItemTemplateIndex);
+   AppendRecords(vecData, m_vecItemTemplates);
+}
+
+void TemplateCacheCompiler::Save(const CString& cszFilename) const
+{
+   std::vector<unsigned char> vecData;
+   Compile(vecData);
+
+   Stream::FileStream stream(cszFilename,
+      Stream::FileStream::modeCreate,
+      Stream::FileStream::accessWrite,
+      Stream::FileStream::shareRead);
+
+   DWORD dwBytesWritten = 0;
+   stream.Write(vecData.data(), static_cast<DWORD>(vecData.size()), dwBytesWritten);
+
+   if (dwBytesWritten != vecData.size())
+      throw Exception(_T("couldn't write template cache file ") + cszFilename, __FILE__, __LINE__);
+}
+
+SpellEffectRecord TemplateCacheCompiler::ConvertEffect(const SpellEffect& effect)
+{
+   SpellEffectRecord record = {};
+   record.m_ucEffectType = static_cast<unsigned char>(effect.EffectType());
+
+   EffectValueOrRange valueOrRange = effect.ValueOrRange();
+   record.m_aiValues[0] = valueOrRange.Value();
+   if (valueOrRange.IsRange())
+   {
+      record.m_ucFlags |= SpellEffectRecord::flagRange;
+      record.m_aiValues[1] = valueOrRange.RangeEnd();
+   }
+
+   if (valueOrRange.IsPercent())
+      record.m_ucFlags |= SpellEffectRecord::flagPercent;
+
+   switch (effect.EffectType())
+   {
+   case SpellEffect::typeDamage:
+   case SpellEffect::typeHeal:
+      {
+         const DamageHealSpellEffectBase& damageHeal = static_cast<const DamageHealSpellEffectBase&>(effect);
+         if (damageHeal.IsInstant())
+            record.m_ucFlags |= SpellEffectRecord::flagInstant;
+         else
+         {
+            record.m_uiDuration = damageHeal.Duration();
+            record.m_uiTickTime = damageHeal.TickTime();
+         }
+
+         if (effect.EffectType() == SpellEffect::typeDamage)
+         {
+            const DamageSpellEffect& damage = static_cast<const DamageSpellEffect&>(effect);
+            record.m_ucSubType = static_cast<unsigned char>(damage.GetDamageType().Type());
+            record.m_ucRestriction = static_cast<unsigned char>(
+               (damage.Restriction(DamageSpellEffect::noArmor) ? 1 : 0) |
+               (damage.Restriction(DamageSpellEffect::noParryBlock) ? 2 : 0));
+         }
+      }
+      break;
+
+   case SpellEffect::typeDisable:
+      record.m_ucSubType = static_cast<unsigned char>(
+         static_cast<const DisableSpellEffect&>(effect).DisableType());
+      break;
+
+   default:
+      break;
+   }
+
+   return record;
+}
+
+void TemplateCacheCompiler::AddToIndex(std::vector<unsigned int>& vecIndex, unsigned int uiId, size_t uiRecordIndex)
+{
+   if (uiId >= c_uiMaxIndexSize)
+      throw Exception(_T("template id too large for template cache"), __FILE__, __LINE__);
+
+   if (uiId >= vecIndex.size())
+      vecIndex.resize(uiId + 1, c_uiTemplateCacheNoIndex);
+
+   if (vecIndex[uiId] != c_uiTemplateCacheNoIndex)
+      throw Exception(_T("duplicate template id in template cache"), __FILE__, __LINE__);
+
+   vecIndex[uiId] = static_cast<unsigned int>(uiRecordIndex);
+}
@@ -0,0 +1,74 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file TemplateCacheCompiler.hpp Compiler for spell and item template cache
+//
+#pragma once
+
+// includes
+#include "World.hpp"
+#include "TemplateCache.hpp"
+#include <vector>
+
+// forward references
+class Spell;
+
+/// \brief compiles spells and item templates into a template cache
+/// \details This is the offline step that runs the text parsers; the
+/// resulting blob is loaded with TemplateCache::Load().
+class WORLD_DECLSPEC TemplateCacheCompiler
+{
+public:
+   /// ctor
+   TemplateCacheCompiler() {}
+
+   /// adds spell; throws when a spell with the same id was already added
+   void AddSpell(const Spell& spell);
+
+   /// parses spell descriptions, one per line, and adds them; empty lines and lines starting with # are skipped
+   void AddSpellText(LPCTSTR pszText);
+
+   /// adds item template; throws when a template with the same id was already added
+   void AddItemTemplate(const ItemTemplate& itemTemplate);
+
+   /// compiles all added spells and item templates into cache data
+   void Compile(std::vector<unsigned char>& vecData) const;
+
+   /// compiles all added spells and item templates and writes cache file
+   void Save(const CString& cszFilename) const;
+
+private:
+   /// converts spell effect to record
+   static SpellEffectRecord ConvertEffect(const SpellEffect& effect);
+
+   /// adds record index to index, at position of given id; throws when id is already in index
+   static void AddToIndex(std::vector<unsigned int>& vecIndex, unsigned int uiId, size_t uiRecordIndex);
+
+   /// appends array of records to data
+   template <typename T>
+   static void AppendRecords(std::vector<unsigned char>& vecData, const std::vector<T>& vecRecords)
+   {
+      if (!vecRecords.empty())
+      {
+         const unsigned char* pRecords = reinterpret_cast<const unsigned char*>(vecRecords.data());
+         vecData.insert(vecData.end(), pRecords, pRecords + vecRecords.size() * sizeof(T));
+      }
+   }
+
+private:
+   /// spell index; record index by spell id
+   std::vector<unsigned int> m_vecSpellIndex;
+
+   /// spell records
+   std::vector<SpellRecord> m_vecSpells;
+
+   /// spell effect records
+   std::vector<SpellEffectRecord> m_vecSpellEffects;
+
+   /// item template index; record index by template id
+   std::vector<unsigned int> m_vecItemTemplateIndex;
+
+   /// item template records
+   std::vector<ItemTemplateRecord> m_vecItemTemplates;
+};
@@ -0,0 +1,187 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file TestTemplateCache.cpp Unit tests for classes TemplateCache and TemplateCacheCompiler
+//
+
+// includes
+#include "stdafx.h"
+#include "Spell.hpp"
+#include "SpellEffect.hpp"
+#include "SpellParser.hpp"
+#include "TemplateCache.hpp"
+#include "TemplateCacheCompiler.hpp"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTest
+{
+
+/// spell descriptions, one per line
+LPCTSTR c_pszSpellText =
+   _T("# test spells\n")
+   _T("4 effect [damage 500 normal instant]\n")
+   _T("\n")
+   _T("5 cooldown 10s cast-time 2s stackable area range 10 ")
+   _T("effect [damage 500 normal over-time 10s tick-time 2s]\r\n")
+   _T("7 stackable ")
+   _T("effect [damage 2580-2630 fire instant] ")
+   _T("effect [damage 500 frost over-time 10s tick-time 2s]\n")
+   _T("9 effect [heal 20%-30% over-time 1m tick-time 5s] effect [disable spellcast]\n");
+
+/// tests classes TemplateCache and TemplateCacheCompiler
+TEST_CLASS(TestTemplateCache)
+{
+   /// checks that compiled effect matches parsed effect
+   static void CheckEffect(const SpellEffect& effect, const SpellEffectRecord& record)
+   {
+      Assert::AreEqual<int>(effect.EffectType(), record.EffectType(), _T("effect type must match"));
+      Assert::AreEqual(effect.ValueOrRange().ToString().GetString(), record.ValueOrRange().ToString().GetString(),
+         _T("value or range must match"));
+
+      if (effect.EffectType() == SpellEffect::typeDamage || effect.EffectType() == SpellEffect::typeHeal)
+      {
+         const DamageHealSpellEffectBase& damageHeal = static_cast<const DamageHealSpellEffectBase&>(effect);
+         Assert::AreEqual(damageHeal.IsInstant(), record.IsInstant(), _T("instant flag must match"));
+
+         if (!damageHeal.IsInstant())
+         {
+            Assert::AreEqual(damageHeal.Duration(), record.m_uiDuration, _T("duration must match"));
+            Assert::AreEqual(damageHeal.TickTime(), record.m_uiTickTime, _T("tick time must match"));
+         }
+      }
+
+      if (effect.EffectType() == SpellEffect::typeDamage)
+         Assert::AreEqual<int>(static_cast<const DamageSpellEffect&>(effect).GetDamageType().Type(),
+            record.GetDamageType().Type(), _T("damage type must match"));
+
+      if (effect.EffectType() == SpellEffect::typeDisable)
+         Assert::AreEqual<int>(static_cast<const DisableSpellEffect&>(effect).DisableType(),
+            record.DisableType(), _T("disable type must match"));
+   }
+
+   /// tests default ctor
+   TEST_METHOD(TestDefaultCtor)
+   {
+      TemplateCache cache;
+      Assert::AreEqual<size_t>(0, cache.NumSpells(), _T("cache must be empty"));
+      Assert::IsNull(cache.FindSpell(4), _T("spell must not be found"));
+      Assert::IsNull(cache.FindItemTemplate(1), _T("item template must not be found"));
+   }
+
+   /// tests compiling spells and looking them up in the cache
+   TEST_METHOD(TestCompileSpells)
+   {
+      TemplateCacheCompiler compiler;
+      compiler.AddSpellText(c_pszSpellText);
+
+      std::vector<unsigned char> vecData;
+      compiler.Compile(vecData);
+
+      TemplateCache cache;
+      cache.Attach(vecData.data(), vecData.size());
+
+      Assert::AreEqual<size_t>(4, cache.NumSpells(), _T("cache must contain 4 spells"));
+      Assert::IsNull(cache.FindSpell(6), _T("missing spell id must not be found"));
+      Assert::IsNull(cache.FindSpell(1000), _T("spell id beyond index must not be found"));
+
+      // compare with parsed spells
+      const unsigned int c_auiSpellIds[] = { 4, 5, 7, 9 };
+      LPCTSTR c_apszSpells[] =
+      {
+         _T("4 effect [damage 500 normal instant]"),
+         _T("5 cooldown 10s cast-time 2s stackable area range 10 effect [damage 500 normal over-time 10s tick-time 2s]"),
+         _T("7 stackable effect [damage 2580-2630 fire instant] effect [damage 500 frost over-time 10s tick-time 2s]"),
+         _T("9 effect [heal 20%-30% over-time 1m tick-time 5s] effect [disable spellcast]"),
+      };
+
+      for (size_t i=0; i<sizeof(c_auiSpellIds)/sizeof(*c_auiSpellIds); i++)
+      {
+         SpellParser parser;
+         std::shared_ptr<Spell> spSpell = parser.Parse(c_apszSpells[i]);
+
+         const SpellRecord* pSpell = cache.FindSpell(c_auiSpellIds[i]);
+         Assert::IsNotNull(pSpell, _T("spell must be found"));
+
+         Assert::AreEqual(spSpell->Id(), pSpell->m_uiSpellId, _T("spell id must match"));
+         Assert::AreEqual(spSpell->Cooldown(), pSpell->m_uiCooldown, _T("cooldown must match"));
+         Assert::AreEqual(spSpell->CastTime(), pSpell->m_uiCastTime, _T("cast time must match"));
+         Assert::AreEqual(spSpell->Range(), pSpell->m_uiRange, _T("range must match"));
+         Assert::AreEqual(spSpell->IsAreaSpell(), pSpell->IsAreaSpell(), _T("area flag must match"));
+         Assert::AreEqual(spSpell->IsStackable(), pSpell->IsStackable(), _T("stackable flag must match"));
+         Assert::AreEqual(spSpell->HasEffect2(), pSpell->HasEffect2(), _T("second effect must match"));
+
+         CheckEffect(spSpell->Effect1(), cache.Effect1(*pSpell));
+         if (spSpell->HasEffect2())
+            CheckEffect(spSpell->Effect2(), cache.Effect2(*pSpell));
+      }
+   }
+
+   /// tests compiling item templates
+   TEST_METHOD(TestCompileItemTemplates)
+   {
+      TemplateCacheCompiler compiler;
+      compiler.AddItemTemplate(ItemTemplate(12, ItemTemplate::itemTypeWeapon));
+      compiler.AddItemTemplate(ItemTemplate(3, ItemTemplate::itemTypeQuest));
+
+      std::vector<unsigned char> vecData;
+      compiler.Compile(vecData);
+
+      TemplateCache cache;
+      cache.Attach(vecData.data(), vecData.size());
+
+      Assert::AreEqual<size_t>(2, cache.NumItemTemplates(), _T("cache must contain 2 item templates"));
+
+      const ItemTemplateRecord* pItemTemplate = cache.FindItemTemplate(12);
+      Assert::IsNotNull(pItemTemplate, _T("item template must be found"));
+      Assert::AreEqual<int>(ItemTemplate::itemTypeWeapon, pItemTemplate->ItemType(), _T("item type must match"));
+      Assert::AreEqual(WeaponItemInfo().AttackSpeed(), pItemTemplate->m_auiValues[0], _T("attack speed must match"));
+
+      Assert::IsNotNull(cache.FindItemTemplate(3), _T("item template must be found"));
+      Assert::IsNull(cache.FindItemTemplate(4), _T("missing item template id must not be found"));
+   }
+
+   /// tests that adding the same id twice throws
+   TEST_METHOD(TestDuplicateId)
+   {
+      TemplateCacheCompiler compiler;
+      compiler.AddSpellText(_T("4 effect [damage 500 normal instant]"));
+
+      Assert::ExpectException<Exception>([&]()
+      {
+         compiler.AddSpellText(_T("4 effect [disable movement]"));
+      }, _T("duplicate spell id must throw"));
+   }
+
+   /// tests that invalid cache data is rejected
+   TEST_METHOD(TestInvalidData)
+   {
+      TemplateCacheCompiler compiler;
+      compiler.AddSpellText(c_pszSpellText);
+
+      std::vector<unsigned char> vecData;
+      compiler.Compile(vecData);
+
+      TemplateCache cache;
+
+      // truncated data
+      Assert::ExpectException<Exception>([&]()
+      {
+         cache.Attach(vecData.data(), vecData.size() - 1);
+      }, _T("truncated data must throw"));
+
+      // wrong version
+      std::vector<unsigned char> vecWrongVersion(vecData);
+      reinterpret_cast<TemplateCacheHeader*>(vecWrongVersion.data())->m_uiVersion++;
+
+      Assert::ExpectException<Exception>([&]()
+      {
+         cache.Attach(vecWrongVersion.data(), vecWrongVersion.size());
+      }, _T("wrong version must throw"));
+
+      Assert::AreEqual<size_t>(0, cache.NumSpells(), _T("cache must be empty after invalid data"));
+   }
+};
+
+} // namespace UnitTest
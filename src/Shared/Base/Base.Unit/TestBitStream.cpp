@@ -0,0 +1,79 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file TestBitStream.cpp Unit tests for classes BitWriter and BitReader
+//
+
+// includes
+#include "stdafx.h"
+#include "BitStream.hpp"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTest
+{
+
+/// tests classes BitWriter and BitReader
+TEST_CLASS(TestBitStream)
+{
+   /// tests writing and reading back values with different bit sizes
+   TEST_METHOD(TestWriteRead)
+   {
+      std::vector<unsigned char> vecData;
+      BitWriter writer(vecData);
+
+      writer.WriteBit(true);
+      writer.Write(5, 3);
+      writer.Write(0x3ff, 10);
+      writer.WriteSigned(-3, 10);
+      writer.WriteSigned(-(1 << 23), 24);
+      writer.Write(0x12345678, 32);
+
+      // 1 + 3 + 10 + 10 + 24 + 32 bits
+      Assert::AreEqual<size_t>(10, vecData.size());
+
+      BitReader reader(vecData.data(), vecData.size());
+      Assert::IsTrue(reader.ReadBit());
+      Assert::AreEqual(5U, reader.Read(3));
+      Assert::AreEqual(0x3ffU, reader.Read(10));
+      Assert::AreEqual(-3, reader.ReadSigned(10));
+      Assert::AreEqual(-(1 << 23), reader.ReadSigned(24));
+      Assert::AreEqual(0x12345678U, reader.Read(32));
+      Assert::AreEqual<size_t>(10, reader.BytesRead());
+   }
+
+   /// tests reading past the end of the data
+   TEST_METHOD(TestReadPastEnd)
+   {
+      std::vector<unsigned char> vecData;
+      BitWriter writer(vecData);
+      writer.Write(1, 6);
+
+      BitReader reader(vecData.data(), vecData.size());
+      reader.Read(6);
+
+      // padding bits can still be read
+      Assert::AreEqual(0U, reader.Read(2));
+
+      try
+      {
+         reader.Read(1);
+         Assert::Fail(_T("must throw exception"));
+      }
+      catch (const Exception&)
+      {
+      }
+   }
+
+   /// tests FitsSigned()
+   TEST_METHOD(TestFitsSigned)
+   {
+      Assert::IsTrue(BitWriter::FitsSigned(511, 10));
+      Assert::IsTrue(BitWriter::FitsSigned(-512, 10));
+      Assert::IsFalse(BitWriter::FitsSigned(512, 10));
+      Assert::IsFalse(BitWriter::FitsSigned(-513, 10));
+   }
+};
+
+} // namespace UnitTest
@@ -0,0 +1,81 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file TestJobBatch.cpp Unit tests for class JobBatch
+//
+
+// includes
+#include "stdafx.h"
+#include "JobBatch.hpp"
+#include <stdexcept>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTest
+{
+
+/// tests class JobBatch
+TEST_CLASS(TestJobBatch)
+{
+   /// tests running jobs without worker pool
+   TEST_METHOD(TestRunWithoutPool)
+   {
+      JobBatch batch;
+
+      int iCount = 0;
+      for (int i = 0; i < 10; i++)
+         batch.Add([&iCount]() { iCount++; });
+
+      Assert::AreEqual<size_t>(10, batch.Size());
+
+      batch.Run();
+
+      Assert::AreEqual(10, iCount);
+      Assert::AreEqual<size_t>(0, batch.Size());
+   }
+
+   /// tests that all jobs have finished when Run() returns
+   TEST_METHOD(TestRunWithPool)
+   {
+      ThreadPool pool(3);
+
+      for (int iRound = 0; iRound < 100; iRound++)
+      {
+         JobBatch batch(&pool);
+
+         std::atomic<int> iSum(0);
+         for (int i = 0; i < 50; i++)
+            batch.Add([&iSum, i]() { iSum += i; });
+
+         batch.Run();
+
+         Assert::AreEqual(49 * 50 / 2, iSum.load());
+      }
+   }
+
+   /// tests that an exception thrown by a job is rethrown, after all jobs finished
+   TEST_METHOD(TestJobException)
+   {
+      ThreadPool pool(2);
+      JobBatch batch(&pool);
+
+      std::atomic<int> iCount(0);
+      batch.Add([]() { throw std::runtime_error("job failed"); });
+      for (int i = 0; i < 10; i++)
+         batch.Add([&iCount]() { iCount++; });
+
+      try
+      {
+         batch.Run();
+         Assert::Fail(L"must throw exception");
+      }
+      catch (const std::runtime_error&)
+      {
+      }
+
+      Assert::AreEqual(10, iCount.load());
+   }
+};
+
+} // namespace UnitTest
@@ -0,0 +1,77 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file TestMpscQueue.cpp Unit tests for class MpscQueue
+//
+
+// includes
+#include "stdafx.h"
+#include "MpscQueue.hpp"
+#include <thread>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTest
+{
+
+/// tests class MpscQueue
+TEST_CLASS(TestMpscQueue)
+{
+   /// tests that items are popped in the order they were pushed
+   TEST_METHOD(TestPushPopOrder)
+   {
+      MpscQueue<int> queue;
+      Assert::IsTrue(queue.IsEmpty());
+
+      queue.Push(1);
+      queue.Push(2);
+      queue.Push(3);
+      Assert::IsFalse(queue.IsEmpty());
+
+      std::vector<int> vecItems;
+      vecItems.push_back(0);
+      queue.PopAll(vecItems);
+
+      Assert::IsTrue(queue.IsEmpty());
+      Assert::AreEqual<size_t>(4, vecItems.size());
+      for (int i = 0; i < 4; i++)
+         Assert::AreEqual(i, vecItems[i]);
+   }
+
+   /// tests pushing from multiple threads while popping
+   TEST_METHOD(TestMultipleProducers)
+   {
+      MpscQueue<int> queue;
+
+      const int c_iNumThreads = 4;
+      const int c_iNumItemsPerThread = 10000;
+
+      std::vector<std::thread> vecThreads;
+      for (int iThread = 0; iThread < c_iNumThreads; iThread++)
+      {
+         vecThreads.push_back(std::thread([&queue, iThread]()
+         {
+            for (int i = 0; i < c_iNumItemsPerThread; i++)
+               queue.Push(iThread * c_iNumItemsPerThread + i);
+         }));
+      }
+
+      std::vector<int> vecItems;
+      while (vecItems.size() < c_iNumThreads * c_iNumItemsPerThread)
+         queue.PopAll(vecItems);
+
+      std::for_each(vecThreads.begin(), vecThreads.end(), [](std::thread& t) { t.join(); });
+
+      // items of each thread must be in order
+      std::vector<int> vecLastItem(c_iNumThreads, -1);
+      std::for_each(vecItems.begin(), vecItems.end(), [&](int iItem)
+      {
+         int iThread = iItem / c_iNumItemsPerThread;
+         Assert::IsTrue(vecLastItem[iThread] < iItem);
+         vecLastItem[iThread] = iItem;
+      });
+   }
+};
+
+} // namespace UnitTest
@@ -9,6 +9,7 @@
 #include "stdafx.h"
 #include "RC4Encoder.hpp"
 #include <vector>
+#include <ulib/HighResolutionTimer.hpp>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
@@ -111,6 +112,70 @@ TEST_CLASS(TestRC4Encoder)
          Assert::IsTrue(CString(testData.text) == CString(&vecData[0]));
       }
    }
+
+   /// tests that encrypting a buffer gives the same result as encrypting with iterators
+   TEST_METHOD(TestEncryptBuffer)
+   {
+      const char* key = "Secret";
+
+      // test all lengths around the SSE2 and key stream block sizes
+      for (size_t length = 0; length < 600; length++)
+      {
+         std::vector<unsigned char> vecData1(length), vecData2(length);
+         for (size_t i = 0; i < length; i++)
+            vecData1[i] = vecData2[i] = static_cast<unsigned char>(i * 7);
+
+         RC4::Encoder rc4Iterator(reinterpret_cast<const unsigned char*>(key), strlen(key));
+         rc4Iterator.Encrypt(vecData1.begin(), vecData1.end());
+
+         // encrypt in two parts, to check that the key stream continues
+         RC4::Encoder rc4Buffer(reinterpret_cast<const unsigned char*>(key), strlen(key));
+         size_t firstPart = length / 3;
+         rc4Buffer.Encrypt(vecData2.data(), firstPart);
+         rc4Buffer.Encrypt(vecData2.data() + firstPart, length - firstPart);
+
+         Assert::IsTrue(vecData1 == vecData2);
+
+         // next byte of key stream must also be equal
+         Assert::AreEqual(rc4Iterator.Get(), rc4Buffer.Get());
+      }
+   }
+
+   /// compares throughput of encrypting with iterators and encrypting a buffer
+   TEST_METHOD(TestEncryptPerformance)
+   {
+      const char* key = "Secret";
+      std::vector<unsigned char> vecData(16 * 1024 * 1024);
+
+      RC4::Encoder rc4Iterator(reinterpret_cast<const unsigned char*>(key), strlen(key));
+
+      HighResolutionTimer timerIterator;
+      timerIterator.Start();
+
+      rc4Iterator.Encrypt(vecData.begin(), vecData.end());
+
+      timerIterator.Stop();
+
+      RC4::Encoder rc4Buffer(reinterpret_cast<const unsigned char*>(key), strlen(key));
+
+      HighResolutionTimer timerBuffer;
+      timerBuffer.Start();
+
+      rc4Buffer.Encrypt(vecData.data(), vecData.size());
+
+      timerBuffer.Stop();
+
+      // encrypting twice with the same key stream gives the original data
+      Assert::IsTrue(std::all_of(vecData.begin(), vecData.end(), [](unsigned char b) { return b == 0; }));
+
+      double dSizeMB = vecData.size() / (1024.0 * 1024.0);
+
+      CString cszText;
+      cszText.Format(_T("RC4 encryption: iterator %.1f MB/s, buffer %.1f MB/s\n"),
+         dSizeMB / timerIterator.Elapsed(),
+         dSizeMB / timerBuffer.Elapsed());
+      Logger::WriteMessage(cszText);
+   }
 };
 
 } // namespace UnitTest
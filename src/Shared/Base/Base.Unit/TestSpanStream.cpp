@@ -0,0 +1,91 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file TestSpanStream.cpp Unit tests for class SpanStream
+//
+
+// includes
+#include "stdafx.h"
+#include "SpanStream.hpp"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTest
+{
+
+/// tests class SpanStream
+TEST_CLASS(TestSpanStream)
+{
+   /// tests that SpanStream writes the same bytes as VectorStream
+   TEST_METHOD(TestSameAsVectorStream)
+   {
+      Uuid uuid = Uuid::New();
+      Vector3d vec(1.5, -2.25, 1024.0);
+
+      VectorStream vectorStream;
+      vectorStream.Write8(42);
+      vectorStream.Write16(0x1234);
+      vectorStream.Write32(0x12345678);
+      vectorStream.WriteDouble(-3.5);
+      vectorStream.WriteVector(vec);
+      vectorStream.WriteUuid(uuid);
+
+      std::array<unsigned char, 64> aData;
+      SpanStream spanStream(aData.data(), aData.size());
+      spanStream.Write8(42);
+      spanStream.Write16(0x1234);
+      spanStream.Write32(0x12345678);
+      spanStream.WriteDouble(-3.5);
+      spanStream.WriteVector(vec);
+      spanStream.WriteUuid(uuid);
+
+      Assert::IsTrue(vectorStream.Size() == spanStream.Pos());
+      Assert::IsTrue(0 == memcmp(vectorStream.Data().data(), aData.data(), spanStream.Pos()));
+
+      ConstMemoryRefStream readStream(aData.data(), spanStream.Pos());
+      Assert::IsTrue(42 == readStream.Read8());
+      Assert::IsTrue(0x1234 == readStream.Read16());
+      Assert::IsTrue(0x12345678 == readStream.Read32());
+      Assert::IsTrue(-3.5 == readStream.ReadDouble());
+      Vector3d vecRead = readStream.ReadVector();
+      Assert::IsTrue(vec.X() == vecRead.X() && vec.Y() == vecRead.Y() && vec.Z() == vecRead.Z());
+      Assert::IsTrue(uuid == readStream.ReadUuid());
+      Assert::IsTrue(0 == readStream.Remaining());
+   }
+
+   /// tests reading and writing through ByteStream interface
+   TEST_METHOD(TestByteStreamInterface)
+   {
+      std::array<unsigned char, 4> aData;
+      SpanStream spanStream(aData.data(), aData.size());
+
+      ByteStream& stream = spanStream;
+      stream.Write32(0x2a2a2a2a);
+
+      spanStream.Reset();
+      Assert::IsTrue(0x2a2a2a2a == stream.Read32());
+   }
+
+   /// tests that reading past the end throws
+   TEST_METHOD(TestReadPastEnd)
+   {
+      std::array<unsigned char, 3> aData = { 1, 2, 3 };
+      ConstMemoryRefStream stream(aData.data(), aData.size());
+
+      stream.Read16();
+      Assert::ExpectException<Exception>([&](){ stream.Read16(); });
+   }
+
+   /// tests that writing past the end throws
+   TEST_METHOD(TestWritePastEnd)
+   {
+      std::array<unsigned char, 3> aData;
+      SpanStream stream(aData.data(), aData.size());
+
+      stream.Write16(0x1234);
+      Assert::ExpectException<Exception>([&](){ stream.Write16(0x5678); });
+   }
+};
+
+} // namespace UnitTest
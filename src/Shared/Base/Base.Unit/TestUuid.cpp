@@ -9,6 +9,7 @@
 #include "stdafx.h"
 #include "Uuid.hpp"
 #include <set>
+#include <unordered_map>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
@@ -150,6 +151,23 @@ TEST_CLASS(TestUuid)
       Uuid u3 = Uuid::New();
       Assert::IsTrue(setUuids.find(u3) == setUuids.end());
    }
+
+   /// tests std::hash specialization
+   TEST_METHOD(TestHash)
+   {
+      std::unordered_map<Uuid, int> mapUuids;
+
+      Uuid u1 = Uuid::New();
+      Uuid u2 = Uuid::New();
+
+      mapUuids[u1] = 1;
+      mapUuids[u2] = 2;
+
+      Assert::IsTrue(std::hash<Uuid>()(u1) == std::hash<Uuid>()(Uuid(u1.Raw())));
+      Assert::AreEqual(1, mapUuids[u1]);
+      Assert::AreEqual(2, mapUuids[u2]);
+      Assert::IsTrue(mapUuids.find(Uuid::New()) == mapUuids.end());
+   }
 };
 
 } // namespace UnitTest
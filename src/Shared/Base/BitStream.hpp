@@ -0,0 +1,160 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file BitStream.hpp Bit packing writer and reader
+//
+#pragma once
+
+// includes
+#include <vector>
+#include <ulib/Exception.hpp>
+
+/// \brief writes values with arbitrary number of bits
+/// \details Values are packed starting with the lowest bit of each byte; the
+/// last byte is padded with zero bits.
+class BitWriter
+{
+public:
+   /// ctor; takes vector to append bytes to
+   BitWriter(std::vector<unsigned char>& vecData)
+      :m_vecData(vecData),
+       m_uiBitPos(0)
+   {
+   }
+
+   /// writes lower bits of unsigned value
+   void Write(unsigned int uiValue, unsigned int uiNumBits)
+   {
+      ATLASSERT(uiNumBits <= 32);
+      ATLASSERT(uiNumBits == 32 || (uiValue >> uiNumBits) == 0); // value must fit
+
+      while (uiNumBits > 0)
+      {
+         if (m_uiBitPos == 0)
+            m_vecData.push_back(0);
+
+         unsigned int uiBitsInByte = 8 - m_uiBitPos;
+         if (uiBitsInByte > uiNumBits)
+            uiBitsInByte = uiNumBits;
+
+         unsigned int uiMask = (1U << uiBitsInByte) - 1;
+         m_vecData.back() |= static_cast<unsigned char>((uiValue & uiMask) << m_uiBitPos);
+
+         uiValue >>= uiBitsInByte;
+         uiNumBits -= uiBitsInByte;
+         m_uiBitPos = (m_uiBitPos + uiBitsInByte) & 7;
+      }
+   }
+
+   /// writes signed value in two's complement, using given number of bits
+   void WriteSigned(int iValue, unsigned int uiNumBits)
+   {
+      ATLASSERT(uiNumBits > 0 && uiNumBits < 32);
+      ATLASSERT(FitsSigned(iValue, uiNumBits));
+
+      Write(static_cast<unsigned int>(iValue) & ((1U << uiNumBits) - 1), uiNumBits);
+   }
+
+   /// writes single bit
+   void WriteBit(bool bValue)
+   {
+      Write(bValue ? 1 : 0, 1);
+   }
+
+   /// returns if signed value can be written with given number of bits
+   static bool FitsSigned(int iValue, unsigned int uiNumBits)
+   {
+      int iLimit = 1 << (uiNumBits - 1);
+      return iValue >= -iLimit && iValue < iLimit;
+   }
+
+private:
+   /// data to append to
+   std::vector<unsigned char>& m_vecData;
+
+   /// next bit position in last byte; 0 when a new byte must be started
+   unsigned int m_uiBitPos;
+};
+
+/// \brief reads values written by BitWriter
+class BitReader
+{
+public:
+   /// ctor; takes data and size
+   BitReader(const unsigned char* pData, size_t uiSize)
+      :m_pData(pData),
+       m_uiSize(uiSize),
+       m_uiPos(0),
+       m_uiBitPos(0)
+   {
+   }
+
+   /// reads unsigned value with given number of bits
+   unsigned int Read(unsigned int uiNumBits)
+   {
+      ATLASSERT(uiNumBits <= 32);
+
+      unsigned int uiValue = 0;
+      unsigned int uiShift = 0;
+
+      while (uiNumBits > 0)
+      {
+         if (m_uiPos >= m_uiSize)
+            throw Exception(_T("BitReader: not enough data in stream"), __FILE__, __LINE__);
+
+         unsigned int uiBitsInByte = 8 - m_uiBitPos;
+         if (uiBitsInByte > uiNumBits)
+            uiBitsInByte = uiNumBits;
+
+         unsigned int uiMask = (1U << uiBitsInByte) - 1;
+         uiValue |= ((m_pData[m_uiPos] >> m_uiBitPos) & uiMask) << uiShift;
+
+         uiShift += uiBitsInByte;
+         uiNumBits -= uiBitsInByte;
+         m_uiBitPos += uiBitsInByte;
+
+         if (m_uiBitPos == 8)
+         {
+            m_uiBitPos = 0;
+            m_uiPos++;
+         }
+      }
+
+      return uiValue;
+   }
+
+   /// reads signed value in two's complement with given number of bits
+   int ReadSigned(unsigned int uiNumBits)
+   {
+      ATLASSERT(uiNumBits > 0 && uiNumBits < 32);
+
+      unsigned int uiValue = Read(uiNumBits);
+
+      // sign extend
+      unsigned int uiSignBit = 1U << (uiNumBits - 1);
+      return static_cast<int>(uiValue ^ uiSignBit) - static_cast<int>(uiSignBit);
+   }
+
+   /// reads single bit
+   bool ReadBit()
+   {
+      return Read(1) != 0;
+   }
+
+   /// returns number of bytes that were started reading
+   size_t BytesRead() const { return m_uiPos + (m_uiBitPos > 0 ? 1 : 0); }
+
+private:
+   /// data
+   const unsigned char* m_pData;
+
+   /// size of data
+   size_t m_uiSize;
+
+   /// current byte position
+   size_t m_uiPos;
+
+   /// current bit position in byte
+   unsigned int m_uiBitPos;
+};
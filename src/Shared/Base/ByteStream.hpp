@@ -60,41 +60,31 @@ public:
    /// reads unsigned short
    unsigned short Read16()
    {
-      unsigned short us = Read8(); // low byte
-      us |= static_cast<unsigned short>(Read8()) << 8; // high byte
-      return us;
+      unsigned char abData[2];
+      ReadBlock(abData, sizeof(abData));
+      return Load16(abData);
    }
 
    /// reads unsigned int
    unsigned int Read32()
    {
-      unsigned int ui = Read8();
-      ui |= static_cast<unsigned int>(Read8()) << 8;
-      ui |= static_cast<unsigned int>(Read8()) << 16;
-      ui |= static_cast<unsigned int>(Read8()) << 24;
-      return ui;
+      unsigned char abData[4];
+      ReadBlock(abData, sizeof(abData));
+      return Load32(abData);
    }
 
    /// reads double value
    double ReadDouble()
    {
-      // read in 23.8 bit format
-      unsigned int uiValue = Read32();
-      bool bNegative = (uiValue & 0x80000000) != 0;
-
-      double dValue = double(uiValue & (~0x80000000))/256.0;
-
-      return bNegative ? -dValue : dValue;
+      return FixedToDouble(Read32());
    }
 
    /// reads vector
    Vector3d ReadVector()
    {
-      double x = ReadDouble();
-      double y = ReadDouble();
-      double z = ReadDouble();
-
-      return Vector3d(x,y,z);
+      unsigned char abData[12];
+      ReadBlock(abData, sizeof(abData));
+      return LoadVector(abData);
    }
 
    /// reads utf-8 encoded string
@@ -125,38 +115,34 @@ public:
 
    // write functions
 
-   /// reads unsigned short
+   /// writes unsigned short
    void Write16(unsigned short us)
    {
-      Write8(static_cast<unsigned char>(us & 0x00ff)); // low byte
-      Write8(static_cast<unsigned char>((us >> 8)& 0x00ff)); // high byte
+      unsigned char abData[2];
+      Store16(abData, us);
+      WriteBlock(abData, sizeof(abData));
    }
 
-   /// reads unsigned int
+   /// writes unsigned int
    void Write32(unsigned int ui)
    {
-      Write8(static_cast<unsigned char>(ui & 0x000000ff));
-      Write8(static_cast<unsigned char>((ui >> 8)& 0x000000ff));
-      Write8(static_cast<unsigned char>((ui >> 16)& 0x000000ff));
-      Write8(static_cast<unsigned char>((ui >> 24)& 0x000000ff));
+      unsigned char abData[4];
+      Store32(abData, ui);
+      WriteBlock(abData, sizeof(abData));
    }
 
    /// writes double value, with 1/(2^8) precision
    void WriteDouble(double dValue)
    {
-      // write 23.8 bit format
-      unsigned int uiValue = static_cast<unsigned int>(fabs(dValue) * 256.0);
-      if (dValue < 0.0)
-         uiValue |= 0x80000000;
-      Write32(uiValue);
+      Write32(DoubleToFixed(dValue));
    }
 
    /// writes vector
    void WriteVector(const Vector3d& vec)
    {
-      WriteDouble(vec.X());
-      WriteDouble(vec.Y());
-      WriteDouble(vec.Z());
+      unsigned char abData[12];
+      StoreVector(abData, vec);
+      WriteBlock(abData, sizeof(abData));
    }
 
    /// writes UTF-8 encoded string
@@ -178,11 +164,81 @@ public:
    {
       WriteBlock(uuid.Raw(), 16);
    }
+
+protected:
+   // encoding helpers; all values are stored in little-endian byte order
+
+   /// loads unsigned short from memory
+   static unsigned short Load16(const unsigned char* p)
+   {
+      return static_cast<unsigned short>(p[0] | (static_cast<unsigned short>(p[1]) << 8));
+   }
+
+   /// loads unsigned int from memory
+   static unsigned int Load32(const unsigned char* p)
+   {
+      return static_cast<unsigned int>(p[0]) |
+         (static_cast<unsigned int>(p[1]) << 8) |
+         (static_cast<unsigned int>(p[2]) << 16) |
+         (static_cast<unsigned int>(p[3]) << 24);
+   }
+
+   /// stores unsigned short to memory
+   static void Store16(unsigned char* p, unsigned short us)
+   {
+      p[0] = static_cast<unsigned char>(us & 0x00ff); // low byte
+      p[1] = static_cast<unsigned char>((us >> 8) & 0x00ff); // high byte
+   }
+
+   /// stores unsigned int to memory
+   static void Store32(unsigned char* p, unsigned int ui)
+   {
+      p[0] = static_cast<unsigned char>(ui & 0x000000ff);
+      p[1] = static_cast<unsigned char>((ui >> 8) & 0x000000ff);
+      p[2] = static_cast<unsigned char>((ui >> 16) & 0x000000ff);
+      p[3] = static_cast<unsigned char>((ui >> 24) & 0x000000ff);
+   }
+
+   /// converts value in 23.8 bit format to double
+   static double FixedToDouble(unsigned int uiValue)
+   {
+      bool bNegative = (uiValue & 0x80000000) != 0;
+
+      double dValue = double(uiValue & (~0x80000000))/256.0;
+
+      return bNegative ? -dValue : dValue;
+   }
+
+   /// converts double to value in 23.8 bit format
+   static unsigned int DoubleToFixed(double dValue)
+   {
+      unsigned int uiValue = static_cast<unsigned int>(fabs(dValue) * 256.0);
+      if (dValue < 0.0)
+         uiValue |= 0x80000000;
+      return uiValue;
+   }
+
+   /// loads vector from 12 bytes of memory
+   static Vector3d LoadVector(const unsigned char* p)
+   {
+      return Vector3d(
+         FixedToDouble(Load32(p)),
+         FixedToDouble(Load32(p + 4)),
+         FixedToDouble(Load32(p + 8)));
+   }
+
+   /// stores vector to 12 bytes of memory
+   static void StoreVector(unsigned char* p, const Vector3d& vec)
+   {
+      Store32(p, DoubleToFixed(vec.X()));
+      Store32(p + 4, DoubleToFixed(vec.Y()));
+      Store32(p + 8, DoubleToFixed(vec.Z()));
+   }
 };
 
 
 /// const vector reference backed stream
-class ConstVectorRefStream: public ByteStream
+class ConstVectorRefStream final: public ByteStream
 {
 public:
    /// ctor; takes data stream
@@ -237,7 +293,7 @@ private:
 };
 
 /// vector backed stream
-class VectorStream: public ByteStream
+class VectorStream final: public ByteStream
 {
 public:
    /// default ctor
@@ -267,7 +323,7 @@ public:
    /// reads block of data
    virtual void ReadBlock(unsigned char* pData, size_t uiSizeToRead) override
    {
-      if (m_uiPos + uiSizeToRead >= m_vecData.size())
+      if (m_uiPos + uiSizeToRead > m_vecData.size())
          throw Exception(_T("ReadBlock: not enough data in stream"), __FILE__, __LINE__);
 
       memcpy(pData, m_vecData.data() + m_uiPos, uiSizeToRead);
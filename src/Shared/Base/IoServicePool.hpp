@@ -0,0 +1,75 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file IoServicePool.hpp pool of io_service objects, each with its own thread
+//
+#pragma once
+
+// includes
+#include "IoServiceThread.hpp"
+#include <vector>
+#include <atomic>
+
+/// \brief pool of io_service objects, each running in its own thread
+/// \details Objects that get an io_service from the pool have all their
+/// handlers called from the same thread, so they don't need a strand. New
+/// objects are distributed over the pool in a round-robin fashion.
+class IoServicePool: public boost::noncopyable
+{
+public:
+   /// ctor; a thread count of 0 uses one thread per processor core
+   IoServicePool(unsigned int uiNumThreads = 0, LPCTSTR pszThreadName = NULL)
+      :m_uiNext(0)
+   {
+      if (uiNumThreads == 0)
+         uiNumThreads = std::max(std::thread::hardware_concurrency(), 1U);
+
+      for (unsigned int ui = 0; ui < uiNumThreads; ui++)
+         m_vecIoServiceThreads.push_back(std::unique_ptr<IoServiceThread>(new IoServiceThread(true, pszThreadName)));
+   }
+
+   /// dtor
+   ~IoServicePool()
+   {
+      Join();
+   }
+
+   /// returns number of io_service objects in pool
+   size_t Size() const { return m_vecIoServiceThreads.size(); }
+
+   /// returns next io_service object to use
+   boost::asio::io_service& Next()
+   {
+      unsigned int uiIndex = m_uiNext++ % m_vecIoServiceThreads.size();
+      return m_vecIoServiceThreads[uiIndex]->Get();
+   }
+
+   /// runs all background threads
+   void Run()
+   {
+      std::for_each(m_vecIoServiceThreads.begin(), m_vecIoServiceThreads.end(),
+         [](std::unique_ptr<IoServiceThread>& upThread) { upThread->Run(); });
+   }
+
+   /// stops all io_service objects; pending handlers are not called anymore
+   void Stop()
+   {
+      std::for_each(m_vecIoServiceThreads.begin(), m_vecIoServiceThreads.end(),
+         [](std::unique_ptr<IoServiceThread>& upThread) { upThread->Get().stop(); });
+   }
+
+   /// waits for all background threads
+   void Join()
+   {
+      std::for_each(m_vecIoServiceThreads.begin(), m_vecIoServiceThreads.end(),
+         [](std::unique_ptr<IoServiceThread>& upThread) { upThread->Join(); });
+   }
+
+private:
+   /// all io_service threads
+   std::vector<std::unique_ptr<IoServiceThread>> m_vecIoServiceThreads;
+
+   /// index of next io_service to return
+   std::atomic<unsigned int> m_uiNext;
+};
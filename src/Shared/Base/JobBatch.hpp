@@ -0,0 +1,148 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file JobBatch.hpp Batch of parallel jobs
+//
+#pragma once
+
+// includes
+#include "ThreadPool.hpp"
+#include <functional>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <algorithm>
+#include <boost/noncopyable.hpp>
+
+/// \brief batch of independent jobs that are run in parallel
+/// \details The jobs are run by the worker threads of a thread pool and by
+/// the thread calling Run(). Each thread takes the next job that wasn't
+/// started yet, so threads that finish their jobs early take over the
+/// remaining ones, and long jobs don't hold up the whole batch. Run() returns
+/// when all jobs have finished; when a job throws an exception, the first
+/// exception is rethrown by Run().
+class JobBatch: public boost::noncopyable
+{
+public:
+   /// job function
+   typedef std::function<void()> T_fnJob;
+
+   /// ctor; without worker pool, all jobs are run on the thread calling Run()
+   explicit JobBatch(ThreadPool* pWorkerPool = nullptr)
+      :m_pWorkerPool(pWorkerPool)
+   {
+   }
+
+   /// adds job to batch
+   void Add(T_fnJob fnJob)
+   {
+      m_vecJobs.push_back(fnJob);
+   }
+
+   /// returns number of jobs added since last call to Run()
+   size_t Size() const { return m_vecJobs.size(); }
+
+   /// runs all jobs added; returns when all jobs are finished
+   void Run()
+   {
+      if (m_vecJobs.empty())
+         return;
+
+      // worker threads may still access the state after Run() returned, when
+      // they are started after all jobs were already taken
+      std::shared_ptr<State> spState = std::make_shared<State>();
+      spState->m_vecJobs.swap(m_vecJobs);
+
+      size_t uiNumJobs = spState->m_vecJobs.size();
+
+      // the calling thread runs jobs, too
+      size_t uiNumHelpers = m_pWorkerPool == nullptr ? 0 :
+         std::min(m_pWorkerPool->NumThreads(), uiNumJobs - 1);
+
+      for (size_t i = 0; i < uiNumHelpers; i++)
+         m_pWorkerPool->QueueWork(std::bind(&JobBatch::RunJobs, spState));
+
+      RunJobs(spState);
+
+      // wait for jobs that are still running on worker threads
+      {
+         std::unique_lock<std::mutex> lock(spState->m_mtxFinished);
+         spState->m_condFinished.wait(lock, [&]() { return spState->m_uiNumFinished == uiNumJobs; });
+      }
+
+      if (spState->m_exception != nullptr)
+         std::rethrow_exception(spState->m_exception);
+   }
+
+private:
+   /// state of running batch
+   struct State
+   {
+      /// ctor
+      State()
+         :m_uiNextJob(0),
+          m_uiNumFinished(0)
+      {
+      }
+
+      /// jobs to run
+      std::vector<T_fnJob> m_vecJobs;
+
+      /// index of next job to run
+      std::atomic<size_t> m_uiNextJob;
+
+      /// mutex to protect finished count and exception
+      std::mutex m_mtxFinished;
+
+      /// condition that is signaled when all jobs are finished
+      std::condition_variable m_condFinished;
+
+      /// number of finished jobs
+      size_t m_uiNumFinished;
+
+      /// first exception thrown by a job
+      std::exception_ptr m_exception;
+   };
+
+   /// runs jobs until no more jobs are left to start
+   static void RunJobs(std::shared_ptr<State> spState)
+   {
+      size_t uiNumJobs = spState->m_vecJobs.size();
+
+      for (;;)
+      {
+         size_t uiJob = spState->m_uiNextJob++;
+         if (uiJob >= uiNumJobs)
+            return;
+
+         std::exception_ptr exception;
+         try
+         {
+            spState->m_vecJobs[uiJob]();
+         }
+         catch (...)
+         {
+            exception = std::current_exception();
+         }
+
+         std::lock_guard<std::mutex> lock(spState->m_mtxFinished);
+
+         if (exception != nullptr && spState->m_exception == nullptr)
+            spState->m_exception = exception;
+
+         if (++spState->m_uiNumFinished == uiNumJobs)
+            spState->m_condFinished.notify_all();
+      }
+   }
+
+private:
+   /// worker pool; may be nullptr
+   ThreadPool* m_pWorkerPool;
+
+   /// jobs to run
+   std::vector<T_fnJob> m_vecJobs;
+};
@@ -0,0 +1,99 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file MpscQueue.hpp Lock-free multi-producer, single-consumer queue
+//
+#pragma once
+
+// includes
+#include <boost/noncopyable.hpp>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+
+/// \brief lock-free multi-producer, single-consumer queue
+/// \details Producers push items onto a linked list using compare-and-swap.
+/// The consumer always takes all items at once, with a single atomic exchange,
+/// and then restores the order in which the items were pushed.
+template <typename T>
+class MpscQueue: public boost::noncopyable
+{
+public:
+   /// ctor
+   MpscQueue()
+      :m_pHead(nullptr)
+   {
+   }
+
+   /// dtor
+   ~MpscQueue()
+   {
+      DeleteList(m_pHead.exchange(nullptr));
+   }
+
+   /// returns if queue is currently empty
+   bool IsEmpty() const
+   {
+      return m_pHead.load() == nullptr;
+   }
+
+   /// pushes item to queue; may be called from any thread
+   void Push(const T& item)
+   {
+      Node* pNode = new Node(item);
+
+      pNode->m_pNext = m_pHead.load(std::memory_order_relaxed);
+      while (!m_pHead.compare_exchange_weak(pNode->m_pNext, pNode,
+         std::memory_order_release, std::memory_order_relaxed))
+      {
+         // m_pNext was updated with current head; try again
+      }
+   }
+
+   /// \brief pops all items and appends them to the vector, in the order they were pushed
+   /// \details only one thread may call this method at a time
+   void PopAll(std::vector<T>& vecItems)
+   {
+      Node* pList = m_pHead.exchange(nullptr, std::memory_order_acquire);
+
+      // list is in reverse order
+      size_t uiStart = vecItems.size();
+      for (Node* pNode = pList; pNode != nullptr; pNode = pNode->m_pNext)
+         vecItems.push_back(pNode->m_item);
+
+      std::reverse(vecItems.begin() + uiStart, vecItems.end());
+
+      DeleteList(pList);
+   }
+
+private:
+   /// list node
+   struct Node
+   {
+      /// ctor
+      Node(const T& item)
+         :m_item(item),
+          m_pNext(nullptr)
+      {
+      }
+
+      T m_item;         ///< item
+      Node* m_pNext;    ///< next node; points to the item pushed before this one
+   };
+
+   /// deletes linked list of nodes
+   static void DeleteList(Node* pNode)
+   {
+      while (pNode != nullptr)
+      {
+         Node* pNext = pNode->m_pNext;
+         delete pNode;
+         pNode = pNext;
+      }
+   }
+
+private:
+   /// head of list; last pushed item
+   std::atomic<Node*> m_pHead;
+};
@@ -0,0 +1,162 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file SpanStream.hpp Byte stream on contiguous memory
+//
+#pragma once
+
+// includes
+#include "ByteStream.hpp"
+#include <type_traits>
+#include <cstring>
+
+/// \brief byte stream on contiguous memory
+/// \details Reads from and writes to a memory block owned by the caller; the
+/// stream never allocates. All accesses are bounds checked once per value, and
+/// values are loaded and stored directly, using the same little-endian format
+/// as ByteStream. The primitive read and write methods hide the ones from
+/// ByteStream, so that code using a SpanStreamT directly needs no virtual calls.
+/// \tparam TByte byte type; use const unsigned char for read-only streams
+template <typename TByte>
+class SpanStreamT final: public ByteStream
+{
+public:
+   /// ctor; takes memory block and size
+   SpanStreamT(TByte* pData, size_t uiSize)
+      :m_pData(pData),
+       m_uiSize(uiSize),
+       m_uiPos(0)
+   {
+   }
+
+   // the vector overloads of ReadBlock() and WriteBlock() stay visible
+   using ByteStream::ReadBlock;
+   using ByteStream::WriteBlock;
+
+   // ByteStream overrides
+
+   /// reads unsigned char
+   virtual unsigned char Read8() override
+   {
+      return *ReadPtr(1);
+   }
+
+   /// reads block of data
+   virtual void ReadBlock(unsigned char* pData, size_t uiSizeToRead) override
+   {
+      memcpy(pData, ReadPtr(uiSizeToRead), uiSizeToRead);
+   }
+
+   /// writes unsigned char
+   virtual void Write8(unsigned char uc) override
+   {
+      *WritePtr(1) = uc;
+   }
+
+   /// writes block of data
+   virtual void WriteBlock(const unsigned char* pData, size_t uiSize) override
+   {
+      memcpy(WritePtr(uiSize), pData, uiSize);
+   }
+
+   // read methods
+
+   /// reads unsigned short
+   unsigned short Read16() { return Load16(ReadPtr(2)); }
+
+   /// reads unsigned int
+   unsigned int Read32() { return Load32(ReadPtr(4)); }
+
+   /// reads double value
+   double ReadDouble() { return FixedToDouble(Read32()); }
+
+   /// reads vector
+   Vector3d ReadVector() { return LoadVector(ReadPtr(12)); }
+
+   /// reads Uuid
+   Uuid ReadUuid() { return Uuid(ReadPtr(16)); }
+
+   // write methods
+
+   /// writes unsigned short
+   void Write16(unsigned short us) { Store16(WritePtr(2), us); }
+
+   /// writes unsigned int
+   void Write32(unsigned int ui) { Store32(WritePtr(4), ui); }
+
+   /// writes double value, with 1/(2^8) precision
+   void WriteDouble(double dValue) { Write32(DoubleToFixed(dValue)); }
+
+   /// writes vector
+   void WriteVector(const Vector3d& vec) { StoreVector(WritePtr(12), vec); }
+
+   /// writes Uuid
+   void WriteUuid(const Uuid& uuid) { memcpy(WritePtr(16), uuid.Raw(), 16); }
+
+   // misc. methods
+
+   /// returns current position; when writing, this is the number of bytes written
+   size_t Pos() const { return m_uiPos; }
+
+   /// returns size of memory block
+   size_t Size() const { return m_uiSize; }
+
+   /// returns number of bytes that can still be read or written
+   size_t Remaining() const { return m_uiSize - m_uiPos; }
+
+   /// sets position to start of memory block again
+   void Reset() { m_uiPos = 0; }
+
+private:
+   /// returns pointer to next bytes to read, and advances position
+   const unsigned char* ReadPtr(size_t uiSize)
+   {
+      if (uiSize > Remaining())
+         throw Exception(_T("SpanStream: not enough data in stream"), __FILE__, __LINE__);
+
+      const unsigned char* p = m_pData + m_uiPos;
+      m_uiPos += uiSize;
+      return p;
+   }
+
+   /// returns pointer to next bytes to write, and advances position
+   unsigned char* WritePtr(size_t uiSize)
+   {
+      return WritePtr(uiSize, std::is_const<TByte>());
+   }
+
+   /// returns pointer to next bytes to write; overload for read-only streams
+   unsigned char* WritePtr(size_t /*uiSize*/, std::true_type /*bIsConst*/)
+   {
+      ATLASSERT(false); // call not supported
+      throw Exception(_T("SpanStream: stream is read-only"), __FILE__, __LINE__);
+   }
+
+   /// returns pointer to next bytes to write, and advances position; overload for writable streams
+   unsigned char* WritePtr(size_t uiSize, std::false_type /*bIsConst*/)
+   {
+      if (uiSize > Remaining())
+         throw Exception(_T("SpanStream: not enough space in stream"), __FILE__, __LINE__);
+
+      unsigned char* p = m_pData + m_uiPos;
+      m_uiPos += uiSize;
+      return p;
+   }
+
+private:
+   /// memory block
+   TByte* m_pData;
+
+   /// size of memory block
+   size_t m_uiSize;
+
+   /// current position
+   size_t m_uiPos;
+};
+
+/// stream that reads from and writes to a memory block
+typedef SpanStreamT<unsigned char> SpanStream;
+
+/// stream that only reads from a memory block; doesn't copy or own the data
+typedef SpanStreamT<const unsigned char> ConstMemoryRefStream;
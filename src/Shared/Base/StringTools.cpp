@@ -48,6 +48,24 @@ void StringTools::HexStringToBytes(const CString& cszText, std::vector<unsigned
       vecData.push_back(HexDigitsToByte(cszText.GetString()+i));
 }
 
+CString StringTools::BytesToHexString(const std::vector<unsigned char>& vecData)
+{
+   static const TCHAR c_aszHexDigits[] = _T("0123456789ABCDEF");
+
+   CString cszText;
+   LPTSTR pszText = cszText.GetBuffer(static_cast<int>(vecData.size() * 2));
+
+   for (size_t i=0, iMax=vecData.size(); i<iMax; i++)
+   {
+      pszText[i*2] = c_aszHexDigits[vecData[i] >> 4];
+      pszText[i*2+1] = c_aszHexDigits[vecData[i] & 0x0F];
+   }
+
+   cszText.ReleaseBuffer(static_cast<int>(vecData.size() * 2));
+
+   return cszText;
+}
+
 void StringTools::ConvertToLowercase(std::string& str)
 {
    std::transform(str.begin(), str.end(), str.begin(), [](const std::string::value_type& ch)
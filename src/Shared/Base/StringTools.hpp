@@ -21,6 +21,9 @@ void BASE_DECLSPEC StringToUTF8(const CString& cszText, std::vector<unsigned cha
 /// converts a string containing hex bytes to bytes
 void BASE_DECLSPEC HexStringToBytes(const CString& cszText, std::vector<unsigned char>& vecData);
 
+/// converts bytes to a string containing hex bytes, in uppercase
+CString BASE_DECLSPEC BytesToHexString(const std::vector<unsigned char>& vecData);
+
 /// converts an std::string to lowercase
 void BASE_DECLSPEC ConvertToLowercase(std::string& str);
 
@@ -9,10 +9,14 @@
 // includes
 #include <thread>
 #include <functional>
+#include <vector>
+#include <atomic>
+#include <algorithm>
 #include <ulib/config/BoostAsio.hpp>
 
 /// \brief Thread pool
-/// at the moment only one thread is used
+/// \details Runs queued work on a fixed number of worker threads; work that
+/// is queued while all threads are busy waits in the queue.
 class ThreadPool
 {
 public:
@@ -20,31 +24,54 @@ public:
    typedef std::function<void()> T_fnWork;
 
    /// ctor
-   ThreadPool()
-      :m_upWork(new boost::asio::io_service::work(m_ioService))
+   ThreadPool(unsigned int uiNumThreads = 1)
+      :m_upWork(new boost::asio::io_service::work(m_ioService)),
+       m_uiQueueSize(0)
    {
-      m_upQueueThread.reset(
-         new std::thread(
-            std::bind(&boost::asio::io_service::run, &m_ioService)));
+      for (unsigned int ui = 0; ui < uiNumThreads; ui++)
+         m_vecWorkerThreads.push_back(std::unique_ptr<std::thread>(
+            new std::thread(
+               std::bind(&ThreadPool::RunWorkerThread, this))));
    }
 
    /// dtor; joins all worker threads
    ~ThreadPool()
    {
       m_upWork.reset();
-      if (m_upQueueThread != NULL)
-         m_upQueueThread->join();
+      std::for_each(m_vecWorkerThreads.begin(), m_vecWorkerThreads.end(),
+         [](std::unique_ptr<std::thread>& upThread) { upThread->join(); });
    }
 
    /// queues worker function
    void QueueWork(T_fnWork fnWork)
    {
-      m_ioService.post(fnWork);
+      m_uiQueueSize++;
+      m_ioService.post(std::bind(&ThreadPool::RunWork, this, fnWork));
    }
 
+   /// returns number of queued worker functions that weren't started yet
+   size_t QueueSize() const { return m_uiQueueSize; }
+
+   /// returns number of worker threads
+   size_t NumThreads() const { return m_vecWorkerThreads.size(); }
+
    /// returns io service used
    boost::asio::io_service& GetIoService() { return m_ioService; }
 
+private:
+   /// runs io service in worker thread
+   void RunWorkerThread()
+   {
+      m_ioService.run();
+   }
+
+   /// runs worker function
+   void RunWork(T_fnWork fnWork)
+   {
+      m_uiQueueSize--;
+      fnWork();
+   }
+
 private:
    /// io service for queue
    boost::asio::io_service m_ioService;
@@ -52,6 +79,9 @@ private:
    /// work item
    std::unique_ptr<boost::asio::io_service::work> m_upWork;
 
-   /// worker thread
-   std::unique_ptr<std::thread> m_upQueueThread;
+   /// worker threads
+   std::vector<std::unique_ptr<std::thread>> m_vecWorkerThreads;
+
+   /// number of queued worker functions
+   std::atomic<size_t> m_uiQueueSize;
 };
@@ -49,3 +49,23 @@ private:
    /// private ctor; initializes unique id from GUID
    Uuid(GUID& g);
 };
+
+namespace std
+{
+   /// hash function for Uuid, e.g. to use Uuid as key in std::unordered_map
+   template <>
+   struct hash<Uuid>
+   {
+      /// returns hash value; folds all 16 bytes, since not all bytes of an uuid are random
+      size_t operator()(const Uuid& uuid) const
+      {
+         const BYTE* pbData = uuid.Raw();
+
+         size_t uiHash = 0;
+         for (size_t i = 0; i < 16; i++)
+            uiHash = uiHash * 31 + pbData[i];
+
+         return uiHash;
+      }
+   };
+}
@@ -10,6 +10,7 @@
 #include <functional>
 #include "IActionQueue.hpp"
 #include "Action.hpp"
+#include "MetricsManager.hpp"
 
 // forward references
 class IModel;
@@ -20,10 +21,14 @@ class IModel;
 class AsyncActionQueue: public IActionQueue
 {
 public:
-   /// ctor
-   AsyncActionQueue(boost::asio::io_service& ioService, IModel& model)
+   /// ctor; when a metrics manager is given, the execution time of actions is stored
+   AsyncActionQueue(boost::asio::io_service& ioService, IModel& model,
+      MetricsManager* pMetricsManager = nullptr)
       :m_ioService(ioService),
-       m_model(model)
+       m_model(model),
+       m_pMetricsManager(pMetricsManager),
+       m_idActionTime(pMetricsManager == nullptr ? 0 :
+          pMetricsManager->Register(Metrics::Server::ActionTime, storeTypeTimeline))
    {
    }
 
@@ -40,6 +45,8 @@ private:
       ObjectRef& arg = spAction->ArgumentRef();
       ATLASSERT(arg.m_sp != NULL);
 
+      ScopedMetricTimer timer(m_pMetricsManager, m_idActionTime);
+
       {
          // lock argument ref
          Lockable::LockType lock = arg.m_sp->Lock();
@@ -53,4 +60,10 @@ private:
 
    /// model
    IModel& m_model;
+
+   /// metrics manager; may be nullptr
+   MetricsManager* m_pMetricsManager;
+
+   /// metric id for action execution time
+   MetricId m_idActionTime;
 };
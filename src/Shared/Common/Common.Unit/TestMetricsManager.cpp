@@ -8,6 +8,9 @@
 // includes
 #include "stdafx.h"
 #include "MetricsManager.hpp"
+#include <thread>
+#include <vector>
+#include <algorithm>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
@@ -59,6 +62,99 @@ TEST_CLASS(TestMetricsManager)
 
       Assert::AreEqual<unsigned int>(21, mm.Get(Metrics::DataBytesTx), _T("last value must be 21, since default is 'current value'"));
    }
+
+   /// tests percentiles of metric timeline
+   TEST_METHOD(TestTimelinePercentiles)
+   {
+      MetricTimeline mt;
+      Assert::AreEqual<unsigned int>(0, mt.Percentile(50.0), _T("empty timeline must return 0"));
+
+      for (unsigned int ui = 1; ui <= 1000; ui++)
+         mt.Add(ui);
+
+      Assert::AreEqual<unsigned int>(1000, mt.Count(), _T("1000 values must have been added"));
+      Assert::AreEqual<unsigned int>(1000, mt.Max(), _T("max value must be 1000"));
+
+      // buckets have an error of at most 12.5%
+      unsigned int uiMedian = mt.Percentile(50.0);
+      Assert::IsTrue(uiMedian >= 500 && uiMedian <= 563, _T("median must be near 500"));
+
+      unsigned int uiP99 = mt.Percentile(99.0);
+      Assert::IsTrue(uiP99 >= 990 && uiP99 <= 1000, _T("99th percentile must be near 990, but not above max"));
+
+      mt.Reset();
+      Assert::AreEqual<unsigned int>(0, mt.Count(), _T("reset timeline must be empty"));
+   }
+
+   /// tests configuring metric as timeline
+   TEST_METHOD(TestMetricTimeline)
+   {
+      MetricsManager mm;
+      mm.Config(Metrics::Server::TickTime, storeTypeTimeline);
+
+      mm.Set(Metrics::Server::TickTime, 10);
+      mm.Set(Metrics::Server::TickTime, 21);
+
+      Assert::AreEqual<unsigned int>(21, mm.Get(Metrics::Server::TickTime), _T("last stored value of 21 must be returned"));
+
+      MetricTimeline mt = mm.TakeTimeline(Metrics::Server::TickTime);
+      Assert::AreEqual<unsigned int>(2, mt.Count(), _T("timeline must contain 2 values"));
+      Assert::AreEqual<unsigned int>(21, mt.Max(), _T("max value must be 21"));
+
+      Assert::AreEqual<unsigned int>(0, mm.GetTimeline(Metrics::Server::TickTime).Count(),
+         _T("taking timeline must start a new timeline"));
+
+      Assert::AreEqual<unsigned int>(0, mm.GetTimeline(Metrics::DataBytesTx).Count(),
+         _T("metric that isn't stored as timeline must return empty timeline"));
+   }
+
+   /// tests setting metrics by id
+   TEST_METHOD(TestMetricIds)
+   {
+      MetricsManager mm;
+      MetricId idBytes = mm.Register(Metrics::DataBytesTx, storeTypeAccumulated);
+      MetricId idMessages = mm.Register(Metrics::MessagesTx, storeTypeCurrentValue);
+
+      Assert::AreNotEqual(idBytes, idMessages, _T("metrics must have different ids"));
+      Assert::AreEqual(idBytes, mm.Register(Metrics::DataBytesTx, storeTypeAccumulated),
+         _T("registering metric again must return same id"));
+
+      mm.Set(idBytes, 10);
+      mm.Set(Metrics::DataBytesTx, 21);
+      mm.Set(idMessages, 5);
+
+      Assert::AreEqual<unsigned int>(31, mm.Get(idBytes), _T("accumulated value must be 31"));
+      Assert::AreEqual<unsigned int>(5, mm.Get(Metrics::MessagesTx), _T("metric set by id must be found by name"));
+   }
+
+   /// tests accumulating metric from multiple threads
+   TEST_METHOD(TestMetricAccumulatedThreads)
+   {
+      MetricsManager mm;
+      MetricId idBytes = mm.Register(Metrics::DataBytesTx, storeTypeAccumulated);
+      MetricId idTime = mm.Register(Metrics::Server::TickTime, storeTypeTimeline);
+
+      std::vector<std::thread> vecThreads;
+      for (int iThread = 0; iThread < 4; iThread++)
+      {
+         vecThreads.push_back(std::thread([&mm, idBytes, idTime]()
+         {
+            for (unsigned int ui = 0; ui < 10000; ui++)
+            {
+               mm.Set(idBytes, 1);
+               mm.Set(idTime, ui);
+            }
+         }));
+      }
+
+      std::for_each(vecThreads.begin(), vecThreads.end(), [](std::thread& t) { t.join(); });
+
+      Assert::AreEqual<unsigned int>(40000, mm.Get(idBytes), _T("all values must be accumulated"));
+
+      MetricTimeline mt = mm.TakeTimeline(idTime);
+      Assert::IsTrue(mt.Count() > 0 && mt.Count() < 40000, _T("timeline must only contain most recent values"));
+      Assert::IsTrue(mt.Max() < 10000, _T("timeline must only contain values that were set"));
+   }
 };
 
 } // namespace UnitTest
@@ -0,0 +1,174 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+//! \file TestMovementIntegrator.cpp Unit tests for class MovementIntegrator
+//
+
+// includes
+#include "stdafx.h"
+#include "MovementIntegrator.hpp"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTest
+{
+   /// tests class MovementIntegrator
+   TEST_CLASS(TestMovementIntegrator)
+   {
+      /// checks if two positions are nearly equal
+      static bool IsNear(const Vector3d& v1, const Vector3d& v2)
+      {
+         return (v1 - v2).Length() < 1e-6;
+      }
+
+      /// tests default ctor
+      TEST_METHOD(TestDefaultCtor)
+      {
+         MovementIntegrator integrator;
+         Assert::AreEqual<size_t>(0, integrator.Size(), _T("integrator must be empty"));
+      }
+
+      /// tests that standing mobiles stay at their position
+      TEST_METHOD(TestStand)
+      {
+         MovementIntegrator integrator;
+
+         MobilePtr spMobile(new Mobile(ObjectId::New()));
+         spMobile->Pos(Vector3d(1.0, 2.0, 3.0));
+
+         integrator.Add(spMobile, TimeIndex(10.0));
+         integrator.Advance(TimeIndex(20.0));
+         integrator.WritePositions();
+
+         Assert::IsTrue(IsNear(Vector3d(1.0, 2.0, 3.0), spMobile->Pos()), _T("mobile must not move"));
+      }
+
+      /// tests moving to target; mobile must stop at destination
+      TEST_METHOD(TestMoveTarget)
+      {
+         MovementIntegrator integrator;
+
+         MobilePtr spMobile(new Mobile(ObjectId::New()));
+         integrator.Add(spMobile, TimeIndex(0.0));
+
+         MovementInfo info(MovementInfo::movementTarget);
+         info.Position(Vector3d(0.0, 0.0, 0.0));
+         info.Destination(Vector3d(10.0, 0.0, 0.0));
+         info.Speed(2.0);
+
+         integrator.UpdateMovement(spMobile->Id(), info, TimeIndex(100.0));
+
+         integrator.Advance(TimeIndex(102.0));
+         Assert::IsTrue(IsNear(info.PredictPosition(2.0), integrator.PositionAt(0)),
+            _T("position must match predicted position"));
+         Assert::IsTrue(IsNear(Vector3d(4.0, 0.0, 0.0), integrator.PositionAt(0)), _T("mobile must have moved 4 units"));
+
+         integrator.Advance(TimeIndex(110.0));
+         integrator.WritePositions();
+         Assert::IsTrue(IsNear(Vector3d(10.0, 0.0, 0.0), spMobile->Pos()), _T("mobile must stop at destination"));
+      }
+
+      /// tests moving in direction and player movement against MovementInfo::PredictPosition()
+      TEST_METHOD(TestMoveDirection)
+      {
+         MovementIntegrator integrator;
+
+         MobilePtr spMobile1(new Mobile(ObjectId::New()));
+         MobilePtr spMobile2(new Mobile(ObjectId::New()));
+         integrator.Add(spMobile1, TimeIndex(0.0));
+         integrator.Add(spMobile2, TimeIndex(0.0));
+
+         MovementInfo info1(MovementInfo::movementDirection);
+         info1.Position(Vector3d(5.0, 0.0, 5.0));
+         info1.Direction(30.0);
+         info1.Speed(3.0);
+
+         MovementInfo info2(MovementInfo::movementPlayer);
+         info2.Position(Vector3d(-5.0, 0.0, 5.0));
+         info2.Direction(120.0);
+         info2.SetForwardMovement(true, false);
+         info2.SetSidewaysMovement(true, true);
+
+         integrator.UpdateMovement(spMobile1->Id(), info1, TimeIndex(1.0));
+         integrator.UpdateMovement(spMobile2->Id(), info2, TimeIndex(1.0));
+
+         integrator.Advance(TimeIndex(3.5));
+         integrator.WritePositions();
+
+         Assert::IsTrue(IsNear(info1.PredictPosition(2.5), spMobile1->Pos()),
+            _T("position must match predicted position for direction movement"));
+         Assert::IsTrue(IsNear(info2.PredictPosition(2.5), spMobile2->Pos()),
+            _T("position must match predicted position for player movement"));
+      }
+
+      /// tests removing mobiles; remaining mobiles must keep their movement
+      TEST_METHOD(TestRemove)
+      {
+         MovementIntegrator integrator;
+
+         MobilePtr spMobile1(new Mobile(ObjectId::New()));
+         MobilePtr spMobile2(new Mobile(ObjectId::New()));
+         MobilePtr spMobile3(new Mobile(ObjectId::New()));
+         spMobile3->Pos(Vector3d(7.0, 0.0, 7.0));
+
+         integrator.Add(spMobile1, TimeIndex(0.0));
+         integrator.Add(spMobile2, TimeIndex(0.0));
+         integrator.Add(spMobile3, TimeIndex(0.0));
+
+         integrator.Remove(spMobile1->Id());
+
+         Assert::AreEqual<size_t>(2, integrator.Size(), _T("integrator must contain 2 mobiles"));
+         Assert::IsFalse(integrator.Contains(spMobile1->Id()), _T("removed mobile must not be contained"));
+         Assert::IsTrue(integrator.Contains(spMobile3->Id()), _T("last mobile must still be contained"));
+
+         // last mobile was moved to the front; updates must still reach it
+         MovementInfo info(MovementInfo::movementDirection);
+         info.Position(Vector3d(7.0, 0.0, 7.0));
+         info.Speed(1.0);
+         integrator.UpdateMovement(spMobile3->Id(), info, TimeIndex(0.0));
+
+         integrator.Advance(TimeIndex(2.0));
+         integrator.WritePositions();
+
+         Assert::IsTrue(IsNear(info.PredictPosition(2.0), spMobile3->Pos()), _T("moved mobile must keep its movement"));
+         Assert::IsTrue(IsNear(Vector3d(), spMobile2->Pos()), _T("other mobile must not move"));
+      }
+
+      /// tests advancing index ranges; only mobiles in the range must move
+      TEST_METHOD(TestAdvanceRange)
+      {
+         MovementIntegrator integrator;
+
+         MovementInfo info(MovementInfo::movementDirection);
+         info.Position(Vector3d(1.0, 0.0, 1.0));
+         info.Speed(2.0);
+
+         std::vector<MobilePtr> vecMobiles;
+         for (size_t i=0; i<3; i++)
+         {
+            MobilePtr spMobile(new Mobile(ObjectId::New()));
+            spMobile->Pos(Vector3d(1.0, 0.0, 1.0));
+
+            integrator.Add(spMobile, TimeIndex(0.0));
+            integrator.UpdateMovement(spMobile->Id(), info, TimeIndex(0.0));
+
+            vecMobiles.push_back(spMobile);
+         }
+
+         integrator.Advance(TimeIndex(1.5), 1, 3);
+         integrator.WritePositions(1, 3);
+
+         Assert::IsTrue(IsNear(Vector3d(1.0, 0.0, 1.0), vecMobiles[0]->Pos()), _T("mobile outside of range must not move"));
+         Assert::IsTrue(IsNear(info.PredictPosition(1.5), vecMobiles[1]->Pos()), _T("mobile in range must move"));
+         Assert::IsTrue(IsNear(info.PredictPosition(1.5), vecMobiles[2]->Pos()), _T("last mobile in range must move"));
+
+         // the remaining range gives the same result as advancing all mobiles
+         integrator.Advance(TimeIndex(1.5), 0, 1);
+         integrator.WritePositions(0, 1);
+
+         Assert::IsTrue(IsNear(info.PredictPosition(1.5), vecMobiles[0]->Pos()), _T("first mobile must move"));
+      }
+   };
+
+} // namespace UnitTest
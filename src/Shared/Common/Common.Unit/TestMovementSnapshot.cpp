@@ -0,0 +1,99 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+//! \file TestMovementSnapshot.cpp Unit tests for class MovementSnapshot
+//
+
+// includes
+#include "stdafx.h"
+#include "MovementSnapshot.hpp"
+#include "BitStream.hpp"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTest
+{
+   /// tests class MovementSnapshot
+   TEST_CLASS(TestMovementSnapshot)
+   {
+      /// writes delta of snapshot to baseline, then reads it back
+      static MovementSnapshot WriteAndReadDelta(const MovementSnapshot& snapshot,
+         const MovementSnapshot& baseline, size_t& uiNumBytes)
+      {
+         std::vector<unsigned char> vecData;
+         BitWriter writer(vecData);
+         snapshot.WriteDelta(writer, baseline);
+
+         uiNumBytes = vecData.size();
+
+         BitReader reader(vecData.data(), vecData.size());
+         MovementSnapshot readSnapshot;
+         readSnapshot.ReadDelta(reader, baseline);
+
+         Assert::AreEqual(vecData.size(), reader.BytesRead());
+
+         return readSnapshot;
+      }
+
+      /// tests quantizing relative to zone origin
+      TEST_METHOD(TestQuantize)
+      {
+         Vector3d vZoneOrigin(1000.0, 0.0, -2000.0);
+
+         MovementInfo info(MovementInfo::movementPlayer);
+         info.Position(Vector3d(1234.5, 12.25, -1987.125));
+         info.Direction(359.9);
+         info.Speed(5.0);
+         info.SetForwardMovement(true, true);
+
+         MovementSnapshot snapshot(info, vZoneOrigin);
+         MovementInfo info2 = snapshot.ToMovementInfo(vZoneOrigin);
+
+         Assert::IsTrue((info.Position() - info2.Position()).Length() < 1.0 / 32.0);
+         Assert::IsTrue(info2.Direction() < 360.0);
+         Assert::IsTrue(DoublesEqual(info2.Speed(), 5.0));
+         Assert::IsTrue(info.MovementFlags() == info2.MovementFlags());
+
+         // quantizing again results in the same snapshot
+         Assert::IsTrue(snapshot == MovementSnapshot(info2, vZoneOrigin));
+      }
+
+      /// tests writing and reading deltas
+      TEST_METHOD(TestDelta)
+      {
+         MovementInfo info(MovementInfo::movementPlayer);
+         info.Position(Vector3d(100.0, 0.0, 100.0));
+         info.Direction(90.0);
+
+         // first update is written against the initial baseline
+         MovementSnapshot baseline;
+         MovementSnapshot snapshot(info, Vector3d());
+
+         size_t uiNumBytes = 0;
+         MovementSnapshot readSnapshot = WriteAndReadDelta(snapshot, baseline, uiNumBytes);
+         Assert::IsTrue(snapshot == readSnapshot);
+
+         // small move only sends position delta
+         info.Position(Vector3d(100.5, 0.0, 99.5));
+         MovementSnapshot snapshot2(info, Vector3d());
+
+         readSnapshot = WriteAndReadDelta(snapshot2, snapshot, uiNumBytes);
+         Assert::IsTrue(snapshot2 == readSnapshot);
+         Assert::AreEqual<size_t>(5, uiNumBytes); // 6 + 1 + 3 * 10 bits
+
+         // unchanged snapshot only sends changed mask
+         readSnapshot = WriteAndReadDelta(snapshot2, snapshot2, uiNumBytes);
+         Assert::IsTrue(snapshot2 == readSnapshot);
+         Assert::AreEqual<size_t>(1, uiNumBytes);
+
+         // large move sends full position
+         info.Position(Vector3d(-5000.0, 10.0, 7000.0));
+         MovementSnapshot snapshot3(info, Vector3d());
+
+         readSnapshot = WriteAndReadDelta(snapshot3, snapshot2, uiNumBytes);
+         Assert::IsTrue(snapshot3 == readSnapshot);
+      }
+   };
+
+} // namespace UnitTest
@@ -9,7 +9,12 @@
 #include "stdafx.h"
 #include "ObjectMap.hpp"
 #include <vector>
+#include <map>
+#include <algorithm>
 #include "Vector3.hpp"
+#include <ulib/HighResolutionTimer.hpp>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
 namespace UnitTest
 {
@@ -21,15 +26,14 @@ namespace UnitTest
       std::vector<ObjectPtr>& vecObjects,
       Predicate pred) throw()
    {
-      const ObjectMap::T_mapObjects& objMap = objectMap.GetMap();
-      ObjectMap::T_mapObjects::const_iterator iter = objMap.begin(), stop = objMap.end();
+      ObjectMap::const_iterator iter = objectMap.begin(), stop = objectMap.end();
 
       for (; iter != stop; ++iter)
       {
-         if (!pred(iter->second))
+         if (!pred(*iter))
             continue;
 
-         vecObjects.push_back(iter->second);
+         vecObjects.push_back(*iter);
       }
    }
 
@@ -37,15 +41,14 @@ namespace UnitTest
    void FindAllObjectsExcept(const ObjectMap& objectMap, const ObjectId& idExcept,
       std::vector<ObjectPtr>& vecObjects) throw()
    {
-      const ObjectMap::T_mapObjects& objMap = objectMap.GetMap();
-      ObjectMap::T_mapObjects::const_iterator iter = objMap.begin(), stop = objMap.end();
+      ObjectMap::const_iterator iter = objectMap.begin(), stop = objectMap.end();
 
       for (; iter != stop; ++iter)
       {
-         if (iter->first == idExcept)
+         if ((*iter)->Id() == idExcept)
             continue;
 
-         vecObjects.push_back(iter->second);
+         vecObjects.push_back(*iter);
       }
    }
 
@@ -59,16 +62,15 @@ namespace UnitTest
       double dRange, Vector3d vecPos,
       std::vector<ObjectPtr>& vecObjects)
    {
-      const ObjectMap::T_mapObjects& objMap = objectMap.GetMap();
-      ObjectMap::T_mapObjects::const_iterator iter = objMap.begin(), stop = objMap.end();
+      ObjectMap::const_iterator iter = objectMap.begin(), stop = objectMap.end();
 
       for (; iter != stop; ++iter)
       {
-         if (iter->first == idExcept)
+         if ((*iter)->Id() == idExcept)
             continue;
 
-         if (Distance(vecPos, iter->second->Pos()) < dRange)
-            vecObjects.push_back(iter->second);
+         if (Distance(vecPos, (*iter)->Pos()) < dRange)
+            vecObjects.push_back(*iter);
       }
    }
 
@@ -89,6 +91,173 @@ namespace UnitTest
       {
          ObjectMap objMap1, objMap2;
       }
+
+      /// tests adding, finding and removing objects
+      TEST_METHOD(TestAddFindRemove)
+      {
+         ObjectMap objMap;
+
+         ObjectPtr spObj1(new Object(ObjectId::New()));
+         ObjectPtr spObj2(new Object(ObjectId::New()));
+
+         ObjectHandle handle1 = objMap.AddObject(spObj1);
+         ObjectHandle handle2 = objMap.AddObject(spObj2);
+
+         Assert::AreEqual<size_t>(2, objMap.Size(), _T("map must contain 2 objects"));
+         Assert::IsTrue(objMap.IsInMap(spObj1->Id()), _T("object 1 must be in map"));
+         Assert::IsTrue(handle1 == objMap.FindHandle(spObj1->Id()), _T("handle of object 1 must be found"));
+         Assert::IsTrue(spObj2 == objMap.Get(handle2), _T("object 2 must be returned by handle"));
+         Assert::IsTrue(spObj2 == objMap.FindObject(spObj2->Id()).m_sp, _T("object 2 must be returned by id"));
+
+         objMap.RemoveObject(spObj1->Id());
+
+         Assert::IsFalse(objMap.IsInMap(spObj1->Id()), _T("object 1 must not be in map anymore"));
+         Assert::IsFalse(objMap.FindHandle(spObj1->Id()).IsSet(), _T("handle of removed object must not be found"));
+         Assert::IsTrue(spObj2 == objMap.Get(handle2), _T("object 2 must still be returned by handle"));
+         Assert::IsTrue(spObj2 == *objMap.begin(), _T("object 2 must be iterated"));
+      }
+
+      /// tests that handles of removed objects are detected, even when their slot is used again
+      TEST_METHOD(TestStaleHandle)
+      {
+         ObjectMap objMap;
+
+         ObjectPtr spObj1(new Object(ObjectId::New()));
+         ObjectHandle handle1 = objMap.AddObject(spObj1);
+         objMap.RemoveObject(spObj1->Id());
+
+         ObjectPtr spObj2(new Object(ObjectId::New()));
+         ObjectHandle handle2 = objMap.AddObject(spObj2);
+
+         Assert::IsTrue(handle1 != handle2, _T("handle of object in reused slot must differ"));
+         Assert::IsFalse(objMap.IsValid(handle1), _T("handle of removed object must be invalid"));
+         Assert::IsTrue(objMap.IsValid(handle2), _T("handle of added object must be valid"));
+
+         bool bThrown = false;
+         try
+         {
+            objMap.Get(handle1);
+         }
+         catch (const Exception&)
+         {
+            bThrown = true;
+         }
+
+         Assert::IsTrue(bThrown, _T("getting object with stale handle must throw"));
+      }
+
+      /// tests adding and removing many objects, compared to std::map
+      TEST_METHOD(TestAddRemoveMany)
+      {
+         ObjectMap objMap;
+         std::map<ObjectId, ObjectPtr> mapObjects;
+
+         std::vector<ObjectId> vecIds;
+         for (unsigned int ui = 0; ui < 10000; ui++)
+         {
+            ObjectPtr spObj(new Object(ObjectId::New()));
+            objMap.AddObject(spObj);
+            mapObjects.insert(std::make_pair(spObj->Id(), spObj));
+            vecIds.push_back(spObj->Id());
+
+            // remove every third object again, from the middle of the map
+            if (ui % 3 == 2)
+            {
+               const ObjectId id = vecIds[vecIds.size() / 2];
+               vecIds.erase(vecIds.begin() + vecIds.size() / 2);
+
+               objMap.RemoveObject(id);
+               mapObjects.erase(id);
+            }
+         }
+
+         Assert::AreEqual(mapObjects.size(), objMap.Size(), _T("map sizes must be equal"));
+
+         std::for_each(mapObjects.begin(), mapObjects.end(), [&](const std::pair<const ObjectId, ObjectPtr>& obj)
+         {
+            Assert::IsTrue(obj.second == objMap.Get(obj.first), _T("object must be found by id"));
+         });
+
+         std::for_each(objMap.begin(), objMap.end(), [&](const ObjectPtr& spObj)
+         {
+            Assert::IsTrue(mapObjects.find(spObj->Id()) != mapObjects.end(), _T("iterated object must be in std::map"));
+         });
+      }
+
+      /// compares lookup and iteration of 100k objects with std::map
+      TEST_METHOD(TestLookupIteratePerformance)
+      {
+         const unsigned int c_uiNumObjects = 100000;
+
+         ObjectMap objMap;
+         std::map<ObjectId, ObjectPtr> mapObjects;
+
+         std::vector<ObjectId> vecIds;
+         std::vector<ObjectHandle> vecHandles;
+         for (unsigned int ui = 0; ui < c_uiNumObjects; ui++)
+         {
+            ObjectPtr spObj(new Object(ObjectId::New()));
+            spObj->Pos(Vector3d(ui, 0.0, 0.0));
+
+            vecHandles.push_back(objMap.AddObject(spObj));
+            mapObjects.insert(std::make_pair(spObj->Id(), spObj));
+            vecIds.push_back(spObj->Id());
+         }
+
+         // look up in random order
+         std::random_shuffle(vecIds.begin(), vecIds.end());
+
+         double dSum = 0.0;
+
+         HighResolutionTimer timerMapLookup;
+         timerMapLookup.Start();
+         for (size_t i = 0; i < vecIds.size(); i++)
+            dSum += mapObjects.find(vecIds[i])->second->Pos().X();
+         timerMapLookup.Stop();
+
+         HighResolutionTimer timerObjectMapLookup;
+         timerObjectMapLookup.Start();
+         for (size_t i = 0; i < vecIds.size(); i++)
+            dSum -= objMap.Get(vecIds[i])->Pos().X();
+         timerObjectMapLookup.Stop();
+
+         HighResolutionTimer timerHandleLookup;
+         timerHandleLookup.Start();
+         for (size_t i = 0; i < vecHandles.size(); i++)
+            dSum += objMap.Get(vecHandles[i])->Pos().X();
+         timerHandleLookup.Stop();
+
+         HighResolutionTimer timerMapIterate;
+         timerMapIterate.Start();
+         std::for_each(mapObjects.begin(), mapObjects.end(), [&](const std::pair<const ObjectId, ObjectPtr>& obj)
+         {
+            dSum -= obj.second->Pos().X();
+         });
+         timerMapIterate.Stop();
+
+         HighResolutionTimer timerObjectMapIterate;
+         timerObjectMapIterate.Start();
+         std::for_each(objMap.begin(), objMap.end(), [&](const ObjectPtr& spObj)
+         {
+            dSum += spObj->Pos().X();
+         });
+         timerObjectMapIterate.Stop();
+
+         // every position was added and subtracted the same number of times
+         Assert::AreEqual(c_uiNumObjects * (c_uiNumObjects - 1) / 2.0, dSum, _T("sum must match"));
+
+         CString cszText;
+         cszText.Format(_T("%u objects: lookup std::map %.1f ms, ObjectMap by id %.1f ms, by handle %.1f ms; ")
+            _T("iterate std::map %.1f ms, ObjectMap %.1f ms
+"),
+            c_uiNumObjects,
+            timerMapLookup.Elapsed() * 1000.0,
+            timerObjectMapLookup.Elapsed() * 1000.0,
+            timerHandleLookup.Elapsed() * 1000.0,
+            timerMapIterate.Elapsed() * 1000.0,
+            timerObjectMapIterate.Elapsed() * 1000.0);
+         Logger::WriteMessage(cszText);
+      }
    };
 
 } // namespace UnitTest
@@ -0,0 +1,211 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+//! \file TestTimedActionScheduler.cpp Unit tests for class TimedActionScheduler
+//
+
+// includes
+#include "stdafx.h"
+#include "TimedActionScheduler.hpp"
+#include "MobileActions.hpp"
+#include <ulib/HighResolutionTimer.hpp>
+#include <random>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTest
+{
+   /// tests class TimedActionScheduler
+   TEST_CLASS(TestTimedActionScheduler)
+   {
+      /// creates action that damages given mobile
+      static ActionPtr CreateAction(const ObjectId& mobileId, unsigned int uiHealthPoints = 1)
+      {
+         return ActionPtr(new DecreaseHealthPointsAction(ObjectId::Null(), mobileId, uiHealthPoints));
+      }
+
+      /// tests default ctor
+      TEST_METHOD(TestDefaultCtor)
+      {
+         TimedActionScheduler scheduler;
+         Assert::AreEqual<size_t>(0, scheduler.Size(), _T("scheduler must be empty"));
+
+         std::vector<ActionPtr> vecExpiredActions;
+         scheduler.Advance(TimeIndex(10.0), vecExpiredActions);
+         Assert::IsTrue(vecExpiredActions.empty(), _T("no actions must expire"));
+      }
+
+      /// tests that actions expire at their due time, not earlier
+      TEST_METHOD(TestSchedule)
+      {
+         TimedActionScheduler scheduler;
+         ObjectId mobileId = ObjectId::New();
+
+         ActionPtr spAction1 = CreateAction(mobileId);
+         ActionPtr spAction2 = CreateAction(mobileId);
+
+         TimedActionHandle handle1 = scheduler.Schedule(TimeIndex(1.0), spAction1, mobileId);
+         scheduler.Schedule(TimeIndex(0.5), spAction2, mobileId);
+
+         Assert::AreEqual<size_t>(2, scheduler.Size(), _T("scheduler must contain 2 actions"));
+         Assert::IsTrue(scheduler.IsScheduled(handle1), _T("action must be scheduled"));
+
+         std::vector<ActionPtr> vecExpiredActions;
+         scheduler.Advance(TimeIndex(0.45), vecExpiredActions);
+         Assert::IsTrue(vecExpiredActions.empty(), _T("no action must expire before due time"));
+
+         scheduler.Advance(TimeIndex(0.5), vecExpiredActions);
+         Assert::AreEqual<size_t>(1, vecExpiredActions.size(), _T("one action must expire"));
+         Assert::IsTrue(spAction2 == vecExpiredActions[0], _T("earlier action must expire first"));
+
+         vecExpiredActions.clear();
+         scheduler.Advance(TimeIndex(2.0), vecExpiredActions);
+         Assert::AreEqual<size_t>(1, vecExpiredActions.size(), _T("second action must expire"));
+         Assert::IsTrue(spAction1 == vecExpiredActions[0], _T("later action must expire"));
+
+         Assert::IsFalse(scheduler.IsScheduled(handle1), _T("expired action must not be scheduled anymore"));
+         Assert::IsFalse(scheduler.Cancel(handle1), _T("expired action must not be cancelled"));
+         Assert::AreEqual<size_t>(0, scheduler.Size(), _T("scheduler must be empty"));
+      }
+
+      /// tests cancelling single actions and all actions of an owner
+      TEST_METHOD(TestCancel)
+      {
+         TimedActionScheduler scheduler;
+         ObjectId mobileId1 = ObjectId::New();
+         ObjectId mobileId2 = ObjectId::New();
+
+         TimedActionHandle handle1 = scheduler.Schedule(TimeIndex(1.0), CreateAction(mobileId1), mobileId1);
+         scheduler.Schedule(TimeIndex(2.0), CreateAction(mobileId1), mobileId1);
+         scheduler.SchedulePeriodic(TimeIndex(1.0), 1.0, 10, CreateAction(mobileId1), mobileId1);
+
+         ActionPtr spAction2 = CreateAction(mobileId2);
+         scheduler.Schedule(TimeIndex(2.0), spAction2, mobileId2);
+
+         Assert::IsTrue(scheduler.Cancel(handle1), _T("action must be cancelled"));
+         Assert::IsFalse(scheduler.Cancel(handle1), _T("action must not be cancelled twice"));
+         Assert::AreEqual<size_t>(3, scheduler.Size(), _T("scheduler must contain 3 actions"));
+
+         // slot of cancelled entry is reused; old handle must stay invalid
+         TimedActionHandle handle3 = scheduler.Schedule(TimeIndex(3.0), CreateAction(mobileId1), mobileId1);
+         Assert::IsFalse(scheduler.IsScheduled(handle1), _T("handle of cancelled action must stay invalid"));
+         Assert::IsTrue(scheduler.IsScheduled(handle3), _T("new action must be scheduled"));
+
+         scheduler.CancelAll(mobileId1);
+         Assert::AreEqual<size_t>(1, scheduler.Size(), _T("only action of other mobile must be left"));
+
+         std::vector<ActionPtr> vecExpiredActions;
+         scheduler.Advance(TimeIndex(20.0), vecExpiredActions);
+         Assert::AreEqual<size_t>(1, vecExpiredActions.size(), _T("only action of other mobile must expire"));
+         Assert::IsTrue(spAction2 == vecExpiredActions[0], _T("action of other mobile must expire"));
+      }
+
+      /// tests periodic actions, e.g. damage over time
+      TEST_METHOD(TestPeriodic)
+      {
+         TimedActionScheduler scheduler;
+         ObjectId mobileId = ObjectId::New();
+
+         TimedActionHandle handle =
+            scheduler.SchedulePeriodic(TimeIndex(3.0), 3.0, 4, CreateAction(mobileId), mobileId);
+
+         std::vector<ActionPtr> vecExpiredActions;
+         for (unsigned int ui = 1; ui <= 90; ui++)
+         {
+            size_t uiNumExpiredBefore = vecExpiredActions.size();
+            scheduler.Advance(TimeIndex(ui * 0.1), vecExpiredActions);
+
+            if (ui % 30 == 0)
+               Assert::AreEqual<size_t>(uiNumExpiredBefore + 1, vecExpiredActions.size(), _T("action must expire every 3 seconds"));
+            else
+               Assert::AreEqual<size_t>(uiNumExpiredBefore, vecExpiredActions.size(), _T("action must not expire between ticks"));
+         }
+
+         Assert::IsTrue(scheduler.IsScheduled(handle), _T("periodic action must keep its handle"));
+
+         scheduler.Advance(TimeIndex(100.0), vecExpiredActions);
+         Assert::AreEqual<size_t>(4, vecExpiredActions.size(), _T("action must expire 4 times"));
+         Assert::IsFalse(scheduler.IsScheduled(handle), _T("action must not be scheduled after last expiry"));
+      }
+
+      /// tests actions that are due far in the future, in the higher wheels and beyond
+      TEST_METHOD(TestFarFuture)
+      {
+         TimedActionScheduler scheduler;
+         ObjectId mobileId = ObjectId::New();
+
+         const double c_adDueTimes[] = { 6.4, 409.6, 26214.4, 3600.0 * 24 * 30 };
+         const size_t c_uiNumDueTimes = sizeof(c_adDueTimes) / sizeof(*c_adDueTimes);
+
+         for (size_t i = 0; i < c_uiNumDueTimes; i++)
+            scheduler.Schedule(TimeIndex(c_adDueTimes[i]), CreateAction(mobileId), mobileId);
+
+         std::vector<ActionPtr> vecExpiredActions;
+         for (size_t i = 0; i < c_uiNumDueTimes; i++)
+         {
+            scheduler.Advance(TimeIndex(c_adDueTimes[i] - 0.1), vecExpiredActions);
+            Assert::AreEqual<size_t>(i, vecExpiredActions.size(), _T("action must not expire before due time"));
+
+            scheduler.Advance(TimeIndex(c_adDueTimes[i]), vecExpiredActions);
+            Assert::AreEqual<size_t>(i + 1, vecExpiredActions.size(), _T("action must expire at due time"));
+         }
+      }
+
+      /// measures scheduling, expiring and cancelling many actions
+      TEST_METHOD(TestManyActionsPerformance)
+      {
+         TimedActionScheduler scheduler;
+
+         const unsigned int c_uiNumMobiles = 10000;
+         const unsigned int c_uiNumActions = 200000;
+
+         std::vector<ObjectId> vecMobileIds;
+         for (unsigned int ui = 0; ui < c_uiNumMobiles; ui++)
+            vecMobileIds.push_back(ObjectId::New());
+
+         std::mt19937 rng(42);
+         std::uniform_real_distribution<double> distDueTime(0.0, 600.0);
+
+         HighResolutionTimer timer;
+         timer.Start();
+
+         scheduler.Reserve(c_uiNumActions);
+         for (unsigned int ui = 0; ui < c_uiNumActions; ui++)
+         {
+            const ObjectId& mobileId = vecMobileIds[ui % c_uiNumMobiles];
+            scheduler.SchedulePeriodic(TimeIndex(distDueTime(rng)), 3.0, 5, CreateAction(mobileId), mobileId);
+         }
+
+         double dScheduleTime = timer.Elapsed();
+
+         // run one minute of world ticks
+         std::vector<ActionPtr> vecExpiredActions;
+         size_t uiNumExpired = 0;
+         for (unsigned int ui = 1; ui <= 600; ui++)
+         {
+            scheduler.Advance(TimeIndex(ui * 0.1), vecExpiredActions);
+            uiNumExpired += vecExpiredActions.size();
+            vecExpiredActions.clear();
+         }
+
+         double dAdvanceTime = timer.Elapsed() - dScheduleTime;
+
+         // half of the mobiles die
+         for (unsigned int ui = 0; ui < c_uiNumMobiles; ui += 2)
+            scheduler.CancelAll(vecMobileIds[ui]);
+
+         double dCancelTime = timer.Elapsed() - dScheduleTime - dAdvanceTime;
+
+         Assert::IsTrue(uiNumExpired > 0, _T("actions must have expired"));
+         Assert::IsTrue(scheduler.Size() < c_uiNumActions / 2 + c_uiNumMobiles, _T("actions of dead mobiles must be cancelled"));
+
+         CString cszText;
+         cszText.Format(_T("%u periodic actions: schedule %.3f ms, 600 ticks %.3f ms (%u expired), cancel %u mobiles %.3f ms\n"),
+            c_uiNumActions, dScheduleTime * 1000.0, dAdvanceTime * 1000.0, static_cast<unsigned int>(uiNumExpired),
+            c_uiNumMobiles / 2, dCancelTime * 1000.0);
+         Logger::WriteMessage(cszText);
+      }
+   };
+
+} // namespace UnitTest
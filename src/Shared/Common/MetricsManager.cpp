@@ -9,62 +9,225 @@
 #include "StdAfx.h"
 #include "MetricsManager.hpp"
 
-void MetricsManager::Config(LPCTSTR pszMetricName, T_enMetricStoreType enStoreType)
+/// \brief ring buffer with the most recent values of a timeline metric
+/// \details Values are written to the next slot without locking; a value
+/// that is read while it is being written may be the previous value of the
+/// slot, which is good enough for metrics.
+struct MetricTimelineRing
 {
-   if (m_mapStoredValues.find(pszMetricName) == m_mapStoredValues.end())
+   /// ctor
+   MetricTimelineRing()
+      :m_ullNumAdded(0),
+       m_ullNumTaken(0)
    {
-      m_mapStoredValues[pszMetricName] = StoredData();
+      for (size_t i=0; i<m_arrValues.size(); i++)
+         m_arrValues[i].store(0, std::memory_order_relaxed);
    }
-   else
+
+   /// adds value
+   void Add(unsigned int uiValue)
    {
-      // reset value
-      m_mapStoredValues[pszMetricName].m_metricValue;
+      unsigned long long ullIndex = m_ullNumAdded.fetch_add(1, std::memory_order_relaxed);
+      m_arrValues[ullIndex % c_uiNumValues].store(uiValue, std::memory_order_relaxed);
    }
 
-   StoredData& data = m_mapStoredValues[pszMetricName];
+   /// number of values stored; about one minute of 10 Hz world ticks
+   static const unsigned int c_uiNumValues = 4096;
+
+   /// values
+   std::array<std::atomic<unsigned int>, c_uiNumValues> m_arrValues;
 
-   if (enStoreType != storeTypeTimeline && data.spTimeline != NULL)
-      data.spTimeline.reset();
+   /// number of values added
+   std::atomic<unsigned long long> m_ullNumAdded;
 
-   data.enStoreType = enStoreType;
+   /// number of values added at the time the timeline was last taken
+   std::atomic<unsigned long long> m_ullNumTaken;
+};
+
+/// returns index of counter that the current thread adds values to
+static unsigned int CurrentThreadCounter(unsigned int uiNumCounters)
+{
+   static std::atomic<unsigned int> s_uiNextCounter(0);
+   thread_local unsigned int t_uiCounter = s_uiNextCounter++;
 
-   if (enStoreType == storeTypeTimeline)
-      data.spTimeline.reset(new MetricTimeline);
+   return t_uiCounter % uiNumCounters;
 }
 
-void MetricsManager::Set(LPCTSTR pszMetricName, unsigned int uiNewValue)
+MetricsManager::MetricsManager()
+:m_uiNumMetrics(0)
 {
-   if (m_mapStoredValues.find(pszMetricName) == m_mapStoredValues.end())
+   for (size_t i=0; i<m_arrStoredData.size(); i++)
+   {
+      StoredData& data = m_arrStoredData[i];
+
+      data.m_iStoreType.store(storeTypeCurrentValue, std::memory_order_relaxed);
+
+      for (size_t uiCounter=0; uiCounter<c_uiNumCounters; uiCounter++)
+         data.m_arrCounters[uiCounter].m_uiValue.store(0, std::memory_order_relaxed);
+
+      data.m_pTimeline.store(nullptr, std::memory_order_relaxed);
+   }
+}
+
+MetricsManager::~MetricsManager()
+{
+   for (size_t i=0; i<m_arrStoredData.size(); i++)
+      delete m_arrStoredData[i].m_pTimeline.load();
+}
+
+/// \details Registering a metric that is already registered resets its values.
+MetricId MetricsManager::Register(LPCTSTR pszMetricName, T_enMetricStoreType enStoreType)
+{
+   RecursiveMutex::LockType lock(m_mtxRegister);
+
+   MetricId metricId;
+
+   std::map<CString, MetricId>::const_iterator iter = m_mapMetricIds.find(pszMetricName);
+   if (iter != m_mapMetricIds.end())
+      metricId = iter->second;
+   else
    {
-      m_mapStoredValues[pszMetricName] = StoredData();
+      metricId = m_uiNumMetrics.load();
+      if (metricId >= c_uiMaxMetrics)
+         throw Exception(_T("too many metrics registered"), __FILE__, __LINE__);
    }
 
-   StoredData& data = m_mapStoredValues[pszMetricName];
+   StoredData& data = m_arrStoredData[metricId];
+
+   // reset values
+   for (size_t i=0; i<c_uiNumCounters; i++)
+      data.m_arrCounters[i].m_uiValue.store(0, std::memory_order_relaxed);
+
+   MetricTimelineRing* pTimeline = data.m_pTimeline.load();
+   if (enStoreType == storeTypeTimeline && pTimeline == nullptr)
+      data.m_pTimeline.store(new MetricTimelineRing);
+   else if (pTimeline != nullptr)
+      pTimeline->m_ullNumTaken.store(pTimeline->m_ullNumAdded.load());
 
-   switch (data.enStoreType)
+   data.m_iStoreType.store(enStoreType);
+
+   if (iter == m_mapMetricIds.end())
+   {
+      m_mapMetricIds.insert(std::make_pair(CString(pszMetricName), metricId));
+
+      // publishes the new metric, after it was set up
+      m_uiNumMetrics.store(metricId + 1);
+   }
+
+   return metricId;
+}
+
+void MetricsManager::Set(MetricId metricId, unsigned int uiNewValue)
+{
+   ATLASSERT(metricId < m_uiNumMetrics.load(std::memory_order_relaxed));
+
+   StoredData& data = m_arrStoredData[metricId];
+
+   switch (data.m_iStoreType.load(std::memory_order_acquire))
    {
    case storeTypeCurrentValue:
-      m_mapStoredValues[pszMetricName].m_metricValue = MetricValue(uiNewValue);
+      data.m_arrCounters[0].m_uiValue.store(uiNewValue, std::memory_order_relaxed);
       break;
 
    case storeTypeAccumulated:
-      m_mapStoredValues[pszMetricName].m_metricValue.Add(uiNewValue);
+      data.m_arrCounters[CurrentThreadCounter(c_uiNumCounters)].m_uiValue.fetch_add(uiNewValue, std::memory_order_relaxed);
       break;
 
    case storeTypeTimeline:
-      // TODO store in timeline
+      data.m_pTimeline.load(std::memory_order_acquire)->Add(uiNewValue);
+
       // also store as current value
-      m_mapStoredValues[pszMetricName].m_metricValue = MetricValue(uiNewValue);
+      data.m_arrCounters[0].m_uiValue.store(uiNewValue, std::memory_order_relaxed);
       break;
    }
 }
 
+void MetricsManager::Set(LPCTSTR pszMetricName, unsigned int uiNewValue)
+{
+   Set(IdFromName(pszMetricName), uiNewValue);
+}
+
+unsigned int MetricsManager::Get(MetricId metricId) const
+{
+   ATLASSERT(metricId < m_uiNumMetrics.load(std::memory_order_relaxed));
+
+   const StoredData& data = m_arrStoredData[metricId];
+
+   if (data.m_iStoreType.load(std::memory_order_relaxed) != storeTypeAccumulated)
+      return data.m_arrCounters[0].m_uiValue.load(std::memory_order_relaxed);
+
+   unsigned int uiValue = 0;
+   for (size_t i=0; i<c_uiNumCounters; i++)
+      uiValue += data.m_arrCounters[i].m_uiValue.load(std::memory_order_relaxed);
+
+   return uiValue;
+}
+
 unsigned int MetricsManager::Get(LPCTSTR pszMetricName)
 {
-   if (m_mapStoredValues.find(pszMetricName) == m_mapStoredValues.end())
-   {
-      m_mapStoredValues[pszMetricName] = StoredData();
-   }
+   return Get(IdFromName(pszMetricName));
+}
+
+MetricTimeline MetricsManager::GetTimeline(MetricId metricId) const
+{
+   ATLASSERT(metricId < m_uiNumMetrics.load(std::memory_order_relaxed));
+
+   const StoredData& data = m_arrStoredData[metricId];
+
+   const MetricTimelineRing* pTimeline = data.m_pTimeline.load(std::memory_order_acquire);
+   if (data.m_iStoreType.load() != storeTypeTimeline || pTimeline == nullptr)
+      return MetricTimeline();
+
+   return TimelineFromRing(*pTimeline, pTimeline->m_ullNumTaken.load());
+}
+
+MetricTimeline MetricsManager::GetTimeline(LPCTSTR pszMetricName)
+{
+   return GetTimeline(IdFromName(pszMetricName));
+}
+
+MetricTimeline MetricsManager::TakeTimeline(MetricId metricId)
+{
+   ATLASSERT(metricId < m_uiNumMetrics.load(std::memory_order_relaxed));
+
+   StoredData& data = m_arrStoredData[metricId];
+
+   MetricTimelineRing* pTimeline = data.m_pTimeline.load(std::memory_order_acquire);
+   if (data.m_iStoreType.load() != storeTypeTimeline || pTimeline == nullptr)
+      return MetricTimeline();
+
+   unsigned long long ullStart = pTimeline->m_ullNumTaken.exchange(pTimeline->m_ullNumAdded.load());
+
+   return TimelineFromRing(*pTimeline, ullStart);
+}
+
+MetricTimeline MetricsManager::TakeTimeline(LPCTSTR pszMetricName)
+{
+   return TakeTimeline(IdFromName(pszMetricName));
+}
+
+MetricId MetricsManager::IdFromName(LPCTSTR pszMetricName)
+{
+   RecursiveMutex::LockType lock(m_mtxRegister);
+
+   std::map<CString, MetricId>::const_iterator iter = m_mapMetricIds.find(pszMetricName);
+   if (iter != m_mapMetricIds.end())
+      return iter->second;
+
+   return Register(pszMetricName, storeTypeCurrentValue);
+}
+
+MetricTimeline MetricsManager::TimelineFromRing(const MetricTimelineRing& ring, unsigned long long ullStart)
+{
+   unsigned long long ullEnd = ring.m_ullNumAdded.load();
+
+   // older values were already overwritten
+   if (ullEnd - ullStart > MetricTimelineRing::c_uiNumValues)
+      ullStart = ullEnd - MetricTimelineRing::c_uiNumValues;
+
+   MetricTimeline timeline;
+   for (unsigned long long ullIndex = ullStart; ullIndex < ullEnd; ullIndex++)
+      timeline.Add(ring.m_arrValues[ullIndex % MetricTimelineRing::c_uiNumValues].load(std::memory_order_relaxed));
 
-   return m_mapStoredValues[pszMetricName].m_metricValue.Value();
+   return timeline;
 }
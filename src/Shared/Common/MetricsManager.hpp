@@ -8,7 +8,17 @@
 
 // includes
 #include "Common.hpp"
+#include <ulib/thread/RecursiveMutex.hpp>
+#include <ulib/HighResolutionTimer.hpp>
 #include <map>
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <atomic>
+#include <boost/noncopyable.hpp>
+
+// forward references
+struct MetricTimelineRing;
 
 /// metric names
 namespace Metrics
@@ -41,6 +51,16 @@ namespace Metrics
       static LPCTSTR NumConnectionsRejected = _T("NumConnectionsRejected"); ///< number of connections rejected
 
       static LPCTSTR LogonQueueSize = _T("LogonQueueSize"); ///< size of logon queue
+
+      static LPCTSTR SendQueueBytes = _T("SendQueueBytes"); ///< number of bytes queued for sending, in all sessions
+      static LPCTSTR MaxSendQueueBytes = _T("MaxSendQueueBytes"); ///< maximum number of bytes queued for sending in a session
+
+      static LPCTSTR TickTime = _T("TickTime"); ///< time used for world tick, in microseconds
+      static LPCTSTR TickMovementTime = _T("TickMovementTime"); ///< time used for moving mobiles in world tick, in microseconds
+      static LPCTSTR TickTimedActionsTime = _T("TickTimedActionsTime"); ///< time used for expiring timed actions in world tick, in microseconds
+      static LPCTSTR TickUpdateTime = _T("TickUpdateTime"); ///< time used for sending out updates in world tick, in microseconds
+      static LPCTSTR TickPersistenceTime = _T("TickPersistenceTime"); ///< time used for queueing object states in world tick, in microseconds
+      static LPCTSTR ActionTime = _T("ActionTime"); ///< time used for executing an action, in microseconds
    }
 }
 
@@ -85,45 +105,246 @@ enum T_enMetricStoreType
    storeTypeTimeline,      ///< vales are stored as timeline
 };
 
-/// metric timeline
+/// \brief metric timeline
+/// \details Stores the distribution of values in a histogram with a fixed
+/// number of buckets; values below 8 have their own bucket, and every power of
+/// two above is split into 8 buckets, so that percentiles have an error of at
+/// most 12.5%. Adding a value never allocates memory.
 class MetricTimeline
 {
 public:
+   /// ctor
+   MetricTimeline()
+      :m_uiCount(0),
+       m_uiMax(0)
+   {
+      m_arrBuckets.fill(0);
+   }
+
+   /// adds value
+   void Add(unsigned int uiValue)
+   {
+      m_arrBuckets[BucketFromValue(uiValue)]++;
+      m_uiCount++;
+      m_uiMax = std::max(m_uiMax, uiValue);
+   }
+
+   /// returns number of values added
+   unsigned int Count() const { return m_uiCount; }
+
+   /// returns maximum value added
+   unsigned int Max() const { return m_uiMax; }
+
+   /// returns value below which the given percentage of values lie; percentage is in range [0; 100]
+   unsigned int Percentile(double dPercent) const
+   {
+      if (m_uiCount == 0)
+         return 0;
+
+      unsigned int uiRank = static_cast<unsigned int>(std::ceil(m_uiCount * dPercent / 100.0));
+      uiRank = std::min(std::max(uiRank, 1U), m_uiCount);
+
+      unsigned int uiSum = 0;
+      for (unsigned int uiBucket = 0; uiBucket < c_uiNumBuckets; uiBucket++)
+      {
+         uiSum += m_arrBuckets[uiBucket];
+         if (uiSum >= uiRank)
+            return std::min(BucketUpperValue(uiBucket), m_uiMax);
+      }
+
+      return m_uiMax;
+   }
+
+   /// removes all values
+   void Reset()
+   {
+      m_arrBuckets.fill(0);
+      m_uiCount = 0;
+      m_uiMax = 0;
+   }
+
+private:
+   /// returns bucket for value
+   static unsigned int BucketFromValue(unsigned int uiValue)
+   {
+      if (uiValue < c_uiSubBuckets)
+         return uiValue;
+
+      unsigned int uiShift = 0;
+      while ((uiValue >> uiShift) >= 2 * c_uiSubBuckets)
+         uiShift++;
+
+      return (uiShift + 1) * c_uiSubBuckets + ((uiValue >> uiShift) - c_uiSubBuckets);
+   }
+
+   /// returns largest value that is stored in bucket
+   static unsigned int BucketUpperValue(unsigned int uiBucket)
+   {
+      if (uiBucket < c_uiSubBuckets)
+         return uiBucket;
+
+      unsigned int uiShift = uiBucket / c_uiSubBuckets - 1;
+      unsigned long long ullUpper =
+         (static_cast<unsigned long long>(uiBucket % c_uiSubBuckets + c_uiSubBuckets + 1) << uiShift) - 1;
+
+      return static_cast<unsigned int>(std::min<unsigned long long>(ullUpper, 0xffffffffULL));
+   }
+
+private:
+   /// number of buckets per power of two
+   static const unsigned int c_uiSubBuckets = 8;
+
+   /// number of buckets; enough for all unsigned int values
+   static const unsigned int c_uiNumBuckets = 30 * c_uiSubBuckets;
+
+   /// number of values per bucket
+   std::array<unsigned int, c_uiNumBuckets> m_arrBuckets;
+
+   /// number of values added
+   unsigned int m_uiCount;
+
+   /// maximum value added
+   unsigned int m_uiMax;
 };
 
-/// metrics manager
-class COMMON_DECLSPEC MetricsManager
+/// metric id; returned when registering a metric
+typedef unsigned int MetricId;
+
+/// \brief metrics manager
+/// \details Metrics are registered once, by name, and are then set and read
+/// by their id. Setting and reading metrics by id neither locks nor
+/// allocates memory, so that it can be done on hot paths from any thread:
+/// current values are stored in an atomic, accumulated values are added to
+/// one of several counters, depending on the thread, that are summed up on
+/// reading, and timeline values are stored in a fixed-size ring buffer that
+/// keeps the most recent values. Setting and reading metrics by name
+/// registers the metric when necessary and is slower.
+class COMMON_DECLSPEC MetricsManager: public boost::noncopyable
 {
 public:
+   /// ctor
+   MetricsManager();
+   /// dtor
+   ~MetricsManager();
+
+   /// registers metric, or (re-)configures store type of registered metric; returns metric id
+   MetricId Register(LPCTSTR pszMetricName, T_enMetricStoreType enStoreType);
+
    /// (re-)configures metric store type
-   void Config(LPCTSTR pszMetricName, T_enMetricStoreType enStoreType);
+   void Config(LPCTSTR pszMetricName, T_enMetricStoreType enStoreType)
+   {
+      Register(pszMetricName, enStoreType);
+   }
 
    /// sets new value
+   void Set(MetricId metricId, unsigned int uiNewValue);
+
+   /// sets new value; registers metric as current value when not registered yet
    void Set(LPCTSTR pszMetricName, unsigned int uiNewValue);
 
+   /// returns current value
+   unsigned int Get(MetricId metricId) const;
+
    /// returns current value
    unsigned int Get(LPCTSTR pszMetricName);
 
+   /// returns timeline of the values set since the timeline was last taken, as
+   /// far as they are still stored; the timeline is empty when metric isn't
+   /// stored as timeline
+   MetricTimeline GetTimeline(MetricId metricId) const;
+
+   /// returns timeline
+   MetricTimeline GetTimeline(LPCTSTR pszMetricName);
+
+   /// returns timeline of the values set since the timeline was last taken,
+   /// and starts a new one
+   MetricTimeline TakeTimeline(MetricId metricId);
+
+   /// returns timeline and starts a new one
+   MetricTimeline TakeTimeline(LPCTSTR pszMetricName);
+
 private:
+   /// returns id of metric; registers metric as current value when not registered yet
+   MetricId IdFromName(LPCTSTR pszMetricName);
+
+   /// returns timeline with values from ring buffer, starting with given value index
+   static MetricTimeline TimelineFromRing(const MetricTimelineRing& ring, unsigned long long ullStart);
+
+private:
+   /// maximum number of metrics that can be registered
+   static const unsigned int c_uiMaxMetrics = 64;
+
+   /// number of counters per metric; accumulated values are spread on them
+   static const unsigned int c_uiNumCounters = 8;
+
+   /// counter; padded to cache line size, so that threads don't contend
+   struct Counter
+   {
+      /// value
+      std::atomic<unsigned int> m_uiValue;
+
+      /// padding
+      char m_padding[64 - sizeof(std::atomic<unsigned int>)];
+   };
+
    /// stored data for metric
    struct StoredData
    {
-      /// ctor
-      StoredData()
-         :enStoreType(storeTypeCurrentValue)
-      {
-      }
-
       /// store type
-      T_enMetricStoreType enStoreType;
+      std::atomic<int> m_iStoreType;
 
-      /// value
-      MetricValue m_metricValue;
+      /// counters; current values are stored in the first one
+      std::array<Counter, c_uiNumCounters> m_arrCounters;
 
-      /// timeline; used when type storeTypeTimeline
-      std::shared_ptr<MetricTimeline> spTimeline;
+      /// timeline; set when metric is stored as timeline, and kept until dtor
+      std::atomic<MetricTimelineRing*> m_pTimeline;
    };
 
-   /// stored metrics values
-   std::map<CString, StoredData> m_mapStoredValues;
+   /// mutex to protect registering metrics
+   RecursiveMutex m_mtxRegister;
+
+   /// ids of all registered metrics; only accessed when registering
+   std::map<CString, MetricId> m_mapMetricIds;
+
+   /// number of registered metrics
+   std::atomic<unsigned int> m_uiNumMetrics;
+
+   /// stored metrics values, indexed by metric id
+   std::array<StoredData, c_uiMaxMetrics> m_arrStoredData;
+};
+
+/// \brief timer that stores the time elapsed in its scope as metric
+/// \details The time is stored in microseconds; when no metrics manager is
+/// given, no time is measured.
+class ScopedMetricTimer
+{
+public:
+   /// ctor; starts timer
+   ScopedMetricTimer(MetricsManager* pMetricsManager, MetricId metricId)
+      :m_pMetricsManager(pMetricsManager),
+       m_metricId(metricId)
+   {
+      if (m_pMetricsManager != nullptr)
+         m_timer.Start();
+   }
+
+   /// dtor; stores elapsed time
+   ~ScopedMetricTimer()
+   {
+      if (m_pMetricsManager == nullptr)
+         return;
+
+      m_timer.Stop();
+      m_pMetricsManager->Set(m_metricId, static_cast<unsigned int>(m_timer.Elapsed() * 1000000.0));
+   }
+
+private:
+   /// metrics manager; may be nullptr
+   MetricsManager* m_pMetricsManager;
+
+   /// metric id
+   MetricId m_metricId;
+
+   /// timer
+   HighResolutionTimer m_timer;
 };
@@ -16,16 +16,6 @@ void Mobile::UpdateMovementInfo(const MovementInfo& info)
 
    Pos(info.Position());
    ViewAngle(unsigned(info.ViewAngle()));
-
-   m_timerMovement.Restart();
-}
-
-void Mobile::Move()
-{
-   double dElapsed = m_timerMovement.Elapsed();
-
-   Vector3d vPos = m_movementInfo.PredictPosition(dElapsed);
-   Pos(vPos);
 }
 
 void Mobile::Serialize(ByteStream& stream) const
@@ -10,7 +10,6 @@
 #include "Object.hpp"
 #include "MobileDisplayInfo.hpp"
 #include "MovementInfo.hpp"
-#include <ulib/Timer.hpp>
 #include <set>
 
 /// \brief mobile
@@ -28,7 +27,6 @@ public:
        m_uiHealthPoints(100),
        m_selection(Uuid::Null())
    {
-      m_timerMovement.Start();
    }
 
    /// dtor
@@ -83,9 +81,6 @@ public:
    /// updates object
    void UpdateMovementInfo(const MovementInfo& info);
 
-   /// moves mobile, according to movement info
-   virtual void Move();
-
    // serialize
 
    /// serialize message by putting bytes to stream
@@ -101,9 +96,6 @@ private:
    /// movement info
    MovementInfo m_movementInfo;
 
-   /// timer for movement
-   Timer m_timerMovement;
-
    /// movement angle
    unsigned int m_uiMovementAngle;
 
@@ -0,0 +1,62 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file MovementBaselineMap.hpp Map with movement snapshot baselines
+//
+#pragma once
+
+// includes
+#include <map>
+#include "Object.hpp"
+#include "MovementSnapshot.hpp"
+
+/// \brief map with movement snapshot baselines of objects
+/// \details Holds the last movement snapshot that was sent for each object,
+/// for one receiver. The server keeps one map per player, the client keeps one
+/// map for all received updates. Since messages are delivered in order, the
+/// last sent snapshot is also the one the receiver uses as baseline.
+class MovementBaselineMap
+{
+public:
+   /// ctor; takes zone origin that quantized positions are relative to
+   MovementBaselineMap(const Vector3d& vZoneOrigin = Vector3d())
+      :m_vZoneOrigin(vZoneOrigin)
+   {
+   }
+
+   /// returns zone origin
+   const Vector3d& ZoneOrigin() const { return m_vZoneOrigin; }
+
+   /// returns baseline for object; returns the initial baseline when nothing was sent yet
+   const MovementSnapshot& Baseline(const ObjectId& objId) const
+   {
+      T_mapBaselines::const_iterator iter = m_mapBaselines.find(objId);
+      return iter != m_mapBaselines.end() ? iter->second : m_initialBaseline;
+   }
+
+   /// sets new baseline for object
+   void Update(const ObjectId& objId, const MovementSnapshot& snapshot)
+   {
+      m_mapBaselines[objId] = snapshot;
+   }
+
+   /// removes baseline for object, e.g. when object was removed
+   void Remove(const ObjectId& objId)
+   {
+      m_mapBaselines.erase(objId);
+   }
+
+private:
+   /// map type
+   typedef std::map<ObjectId, MovementSnapshot> T_mapBaselines;
+
+   /// zone origin
+   Vector3d m_vZoneOrigin;
+
+   /// baselines of all objects
+   T_mapBaselines m_mapBaselines;
+
+   /// initial baseline
+   MovementSnapshot m_initialBaseline;
+};
@@ -170,110 +170,111 @@ Vector3d MovementInfo::PredictPosition(double dElapsedTime) const
    return m_vCurPos;
 }
 
-double MovementInfo::TimeToReachDestination() const
+Vector3d MovementInfo::Velocity() const
 {
    switch (m_enMovementMode)
    {
    case movementStand:
-      return 0.0;
+      return Vector3d();
 
    case movementTarget:
       {
          Vector3d vDir = m_vDestPos - m_vCurPos;
-         return vDir.Length() / m_dSpeedInUnitsPerSec;
+         if (vDir.Length() < 1e-3)
+            return Vector3d(); // already at destination
+
+         vDir.Normalize();
+         return vDir * m_dSpeedInUnitsPerSec;
       }
 
    case movementDirection:
-      return 1.0; // constant factor
-
-   default:
-      ATLASSERT(false);
-   }
+      {
+         Vector3d vDir(1.0, 0.0, 0.0);
+         vDir.RotateY(m_dDirection);
+         vDir.Normalize();
 
-   return 0.0;
-}
+         return vDir * m_dSpeedInUnitsPerSec;
+      }
 
-void MovementInfo::Serialize(ByteStream& stream) const
-{
-   ATLASSERT(m_enMovementMode <= 0xff);
+   case movementPlayer:
+      {
+         double dMoveSpeed = 0.0;
+         if (m_bForwardMovement)
+            dMoveSpeed = m_bMoveForward ? c_dMoveForwardSpeed : -c_dMoveBackwardSpeed;
 
-   stream.Write8(BYTE(m_enMovementMode & 0xff));
+         double dStrafeSpeed = 0.0;
+         if (m_bSidewaysMovement)
+            dStrafeSpeed = m_bSidewaysMoveLeft ? c_dStrafeSpeed : -c_dStrafeSpeed;
 
-   stream.WriteVector(m_vCurPos);
-   stream.Write8(static_cast<unsigned char>(m_dSpeedInUnitsPerSec * 10.0));
+         if (dMoveSpeed == 0.0 && dStrafeSpeed == 0.0)
+            return Vector3d();
 
-   switch (m_enMovementMode)
-   {
-   case movementStand:
-      break;
+         Vector3d vDir(dStrafeSpeed, 0.0, dMoveSpeed);
 
-   case movementTarget:
-      stream.WriteVector(m_vDestPos);
-      break;
+         // normalize to larger speed count
+         vDir.Normalize();
+         vDir *= std::max(fabs(dStrafeSpeed), fabs(dMoveSpeed));
 
-   case movementDirection:
-      stream.Write16(static_cast<unsigned short>(m_dDirection));
-      break;
+         vDir.RotateY(m_dDirection);
 
-   case movementPlayer:
-      stream.Write16(static_cast<unsigned short>(m_dDirection));
-      stream.Write8(
-         (m_bForwardMovement  ? 0x01 : 0) |
-         (m_bMoveForward      ? 0x02 : 0) |
-         (m_bSidewaysMovement ? 0x04 : 0) |
-         (m_bSidewaysMoveLeft ? 0x08 : 0));
-      break;
+         return vDir;
+      }
 
    default:
       ATLASSERT(false);
    }
+
+   return Vector3d();
 }
 
-void MovementInfo::Deserialize(ByteStream& stream)
+double MovementInfo::TimeToReachDestination() const
 {
-   m_enMovementMode = static_cast<T_enMovementMode>(stream.Read8());
-   if (m_enMovementMode > movementMax)
-      throw Exception(_T("invalid movement mode"), __FILE__, __LINE__);
-
-   m_vCurPos = stream.ReadVector();
-   m_dSpeedInUnitsPerSec = stream.Read8() * 0.1;
-
    switch (m_enMovementMode)
    {
    case movementStand:
-      break;
+      return 0.0;
 
    case movementTarget:
-      m_vDestPos = stream.ReadVector();
-      m_timerStartMovement.Restart();
-      break;
-
-   case movementDirection:
-      m_dDirection = stream.Read16();
-      if (m_dDirection >= 360.0)
-         throw Exception(_T("invalid movement direction"), __FILE__, __LINE__);
-      break;
-
-   case movementPlayer:
       {
-         m_dDirection = stream.Read16();
-         if (m_dDirection >= 360.0)
-            throw Exception(_T("invalid movement direction"), __FILE__, __LINE__);
-
-         unsigned char ucFlags = stream.Read8();
-         if ((ucFlags & 0x80) != 0)
-            throw Exception(_T("invalid movement flags"), __FILE__, __LINE__);
-
-         m_bForwardMovement  = (ucFlags & 0x01) != 0;
-         m_bMoveForward      = (ucFlags & 0x02) != 0;
-         m_bSidewaysMovement = (ucFlags & 0x04) != 0;
-         m_bSidewaysMoveLeft = (ucFlags & 0x08) != 0;
+         Vector3d vDir = m_vDestPos - m_vCurPos;
+         return vDir.Length() / m_dSpeedInUnitsPerSec;
       }
-      break;
+
+   case movementDirection:
+      return 1.0; // constant factor
 
    default:
       ATLASSERT(false);
    }
+
+   return 0.0;
+}
+
+unsigned char MovementInfo::MovementFlags() const
+{
+   return
+      (m_bForwardMovement  ? 0x01 : 0) |
+      (m_bMoveForward      ? 0x02 : 0) |
+      (m_bSidewaysMovement ? 0x04 : 0) |
+      (m_bSidewaysMoveLeft ? 0x08 : 0);
+}
+
+void MovementInfo::MovementFlags(unsigned char ucFlags)
+{
+   m_bForwardMovement  = (ucFlags & 0x01) != 0;
+   m_bMoveForward      = (ucFlags & 0x02) != 0;
+   m_bSidewaysMovement = (ucFlags & 0x04) != 0;
+   m_bSidewaysMoveLeft = (ucFlags & 0x08) != 0;
+}
+
+void MovementInfo::Serialize(ByteStream& stream) const
+{
+   Serialize<ByteStream>(stream);
+}
+
+void MovementInfo::Deserialize(ByteStream& stream)
+{
+   Deserialize<ByteStream>(stream);
 }
 
 bool MovementInfo::operator==(const MovementInfo& rhs) const
@@ -10,6 +10,7 @@
 #include "Common.hpp"
 #include "Vector3.hpp"
 #include <ulib/Timer.hpp>
+#include <ulib/Exception.hpp>
 
 // forward references
 class ByteStream;
@@ -61,6 +62,12 @@ public:
    /// returns speed
    double Speed() const { return m_dSpeedInUnitsPerSec; }
 
+   /// returns movement direction; for movementDirection and movementPlayer mode
+   double Direction() const { return m_dDirection; }
+
+   /// returns movement flags, as bit mask; for movementPlayer mode
+   unsigned char MovementFlags() const;
+
    /// returns view angle to destination
    double ViewAngle() const;
 
@@ -84,11 +91,19 @@ public:
    /// sets sideways movement (left or right)
    void SetSidewaysMovement(bool bMovement, bool bMoveLeft);
 
+   /// sets movement flags, as returned by MovementFlags()
+   void MovementFlags(unsigned char ucFlags);
+
    // actions
 
    /// calculates position based on movement info and elapsed time
    Vector3d PredictPosition(double dElapsedTime) const;
 
+   /// \brief returns velocity of movement, in units/s
+   /// \details for movementTarget mode, the velocity only applies until
+   /// TimeToReachDestination() has elapsed
+   Vector3d Velocity() const;
+
    /// calculates time to reach destination, in seconds
    double TimeToReachDestination() const;
 
@@ -100,6 +115,16 @@ public:
    /// deserialize message by reading bytes from stream
    void Deserialize(ByteStream& stream);
 
+   /// \brief serialize message by putting bytes to stream of given type
+   /// \details when called with a final stream class like SpanStream, all
+   /// stream accesses are non-virtual and can be inlined
+   template <typename TStream>
+   void Serialize(TStream& stream) const;
+
+   /// deserialize message by reading bytes from stream of given type
+   template <typename TStream>
+   void Deserialize(TStream& stream);
+
    // operators
 
    /// equality operator
@@ -135,3 +160,81 @@ private:
    bool m_bSidewaysMovement;  ///< sideways movement active?
    bool m_bSidewaysMoveLeft;  ///< true: left, false: right
 };
+
+template <typename TStream>
+inline void MovementInfo::Serialize(TStream& stream) const
+{
+   ATLASSERT(m_enMovementMode <= 0xff);
+
+   stream.Write8(static_cast<unsigned char>(m_enMovementMode & 0xff));
+
+   stream.WriteVector(m_vCurPos);
+   stream.Write8(static_cast<unsigned char>(m_dSpeedInUnitsPerSec * 10.0));
+
+   switch (m_enMovementMode)
+   {
+   case movementStand:
+      break;
+
+   case movementTarget:
+      stream.WriteVector(m_vDestPos);
+      break;
+
+   case movementDirection:
+      stream.Write16(static_cast<unsigned short>(m_dDirection));
+      break;
+
+   case movementPlayer:
+      stream.Write16(static_cast<unsigned short>(m_dDirection));
+      stream.Write8(MovementFlags());
+      break;
+
+   default:
+      ATLASSERT(false);
+   }
+}
+
+template <typename TStream>
+inline void MovementInfo::Deserialize(TStream& stream)
+{
+   m_enMovementMode = static_cast<T_enMovementMode>(stream.Read8());
+   if (m_enMovementMode > movementMax)
+      throw Exception(_T("invalid movement mode"), __FILE__, __LINE__);
+
+   m_vCurPos = stream.ReadVector();
+   m_dSpeedInUnitsPerSec = stream.Read8() * 0.1;
+
+   switch (m_enMovementMode)
+   {
+   case movementStand:
+      break;
+
+   case movementTarget:
+      m_vDestPos = stream.ReadVector();
+      m_timerStartMovement.Restart();
+      break;
+
+   case movementDirection:
+      m_dDirection = stream.Read16();
+      if (m_dDirection >= 360.0)
+         throw Exception(_T("invalid movement direction"), __FILE__, __LINE__);
+      break;
+
+   case movementPlayer:
+      {
+         m_dDirection = stream.Read16();
+         if (m_dDirection >= 360.0)
+            throw Exception(_T("invalid movement direction"), __FILE__, __LINE__);
+
+         unsigned char ucFlags = stream.Read8();
+         if ((ucFlags & 0x80) != 0)
+            throw Exception(_T("invalid movement flags"), __FILE__, __LINE__);
+
+         MovementFlags(ucFlags);
+      }
+      break;
+
+   default:
+      ATLASSERT(false);
+   }
+}
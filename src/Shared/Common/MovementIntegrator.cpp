@@ -0,0 +1,217 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file MovementIntegrator.cpp Batched movement of mobiles
+//
+
+// includes
+#include "stdafx.h"
+#include "MovementIntegrator.hpp"
+#include <limits>
+
+/// \details A mobile that is standing starts at its current position, since
+/// the movement info of a newly created mobile may not be initialized yet.
+void MovementIntegrator::Add(const MobilePtr& spMobile, const TimeIndex& startTime)
+{
+   size_t uiIndex = m_vecMobiles.size();
+
+   m_registryIndex.Add(spMobile->Id(), uiIndex);
+   m_vecMobiles.push_back(spMobile);
+   ResizeEntries(uiIndex + 1);
+
+   MovementInfo info;
+   {
+      Lockable::LockType lock = spMobile->Lock();
+
+      info = spMobile->GetMovementInfo();
+      if (info.MovementMode() == MovementInfo::movementStand)
+         info.Position(spMobile->Pos());
+   }
+
+   SetMovement(uiIndex, info, startTime);
+
+   m_vecPosX[uiIndex] = m_vecStartX[uiIndex];
+   m_vecPosY[uiIndex] = m_vecStartY[uiIndex];
+   m_vecPosZ[uiIndex] = m_vecStartZ[uiIndex];
+}
+
+void MovementIntegrator::UpdateMovement(const ObjectId& id, const MovementInfo& info, const TimeIndex& startTime)
+{
+   ObjectHandle handle = m_registryIndex.Find(id);
+   if (!handle.IsSet())
+      return;
+
+   SetMovement(m_registryIndex.Get(handle), info, startTime);
+}
+
+/// \details The last mobile is moved to the index of the removed mobile, so
+/// that the arrays stay dense.
+void MovementIntegrator::Remove(const ObjectId& id)
+{
+   ObjectHandle handle = m_registryIndex.Find(id);
+   if (!handle.IsSet())
+      return;
+
+   size_t uiIndex = m_registryIndex.Get(handle);
+   m_registryIndex.Remove(handle);
+
+   size_t uiLastIndex = m_vecMobiles.size() - 1;
+   if (uiIndex != uiLastIndex)
+   {
+      MoveEntry(uiLastIndex, uiIndex);
+      m_registryIndex.Get(m_vecMobiles[uiIndex]->Id()) = uiIndex;
+   }
+
+   m_vecMobiles.pop_back();
+   ResizeEntries(uiLastIndex);
+}
+
+void MovementIntegrator::Reserve(size_t uiNumMobiles)
+{
+   m_registryIndex.Reserve(uiNumMobiles);
+   m_vecMobiles.reserve(uiNumMobiles);
+
+   m_vecStartX.reserve(uiNumMobiles);
+   m_vecStartY.reserve(uiNumMobiles);
+   m_vecStartZ.reserve(uiNumMobiles);
+   m_vecVelocityX.reserve(uiNumMobiles);
+   m_vecVelocityY.reserve(uiNumMobiles);
+   m_vecVelocityZ.reserve(uiNumMobiles);
+   m_vecStartTime.reserve(uiNumMobiles);
+   m_vecMaxMoveTime.reserve(uiNumMobiles);
+   m_vecMoveTime.reserve(uiNumMobiles);
+   m_vecPosX.reserve(uiNumMobiles);
+   m_vecPosY.reserve(uiNumMobiles);
+   m_vecPosZ.reserve(uiNumMobiles);
+}
+
+void MovementIntegrator::Advance(const TimeIndex& timeIndex)
+{
+   Advance(timeIndex, 0, m_vecMobiles.size());
+}
+
+/// \details Each loop only reads a few arrays and writes one, so that the
+/// compiler can check the arrays for overlap and vectorize the loop.
+void MovementIntegrator::Advance(const TimeIndex& timeIndex, size_t uiStart, size_t uiEnd)
+{
+   ATLASSERT(uiStart <= uiEnd && uiEnd <= m_vecMobiles.size());
+
+   const double dNow = timeIndex.Get();
+   const size_t uiNumMobiles = uiEnd - uiStart;
+
+   // calculate time that each mobile moved
+   const double* pdStartTime = m_vecStartTime.data() + uiStart;
+   const double* pdMaxMoveTime = m_vecMaxMoveTime.data() + uiStart;
+   double* pdMoveTime = m_vecMoveTime.data() + uiStart;
+
+   for (size_t i=0; i<uiNumMobiles; i++)
+   {
+      double dMoveTime = dNow - pdStartTime[i];
+      dMoveTime = dMoveTime < 0.0 ? 0.0 : dMoveTime;
+      pdMoveTime[i] = dMoveTime > pdMaxMoveTime[i] ? pdMaxMoveTime[i] : dMoveTime;
+   }
+
+   AdvanceAxis(uiNumMobiles, m_vecStartX.data() + uiStart, m_vecVelocityX.data() + uiStart, pdMoveTime, m_vecPosX.data() + uiStart);
+   AdvanceAxis(uiNumMobiles, m_vecStartY.data() + uiStart, m_vecVelocityY.data() + uiStart, pdMoveTime, m_vecPosY.data() + uiStart);
+   AdvanceAxis(uiNumMobiles, m_vecStartZ.data() + uiStart, m_vecVelocityZ.data() + uiStart, pdMoveTime, m_vecPosZ.data() + uiStart);
+}
+
+void MovementIntegrator::AdvanceAxis(size_t uiNumMobiles, const double* pdStart, const double* pdVelocity,
+   const double* pdMoveTime, double* pdPos)
+{
+   for (size_t i=0; i<uiNumMobiles; i++)
+      pdPos[i] = pdStart[i] + pdVelocity[i] * pdMoveTime[i];
+}
+
+void MovementIntegrator::WritePositions() const
+{
+   WritePositions(0, m_vecMobiles.size());
+}
+
+/// \details Each mobile is locked while its position is written, so that
+/// actions and other threads that lock the mobile see a consistent position.
+void MovementIntegrator::WritePositions(size_t uiStart, size_t uiEnd) const
+{
+   ATLASSERT(uiStart <= uiEnd && uiEnd <= m_vecMobiles.size());
+
+   for (size_t i=uiStart; i<uiEnd; i++)
+   {
+      Lockable::LockType lock = m_vecMobiles[i]->Lock();
+      m_vecMobiles[i]->Pos(PositionAt(i));
+   }
+}
+
+/// \details Movement to a target is stored as movement to the destination that
+/// stops after the time to reach the destination; when the mobile is already
+/// at the destination, it starts there.
+void MovementIntegrator::SetMovement(size_t uiIndex, const MovementInfo& info, const TimeIndex& startTime)
+{
+   Vector3d vStart = info.Position();
+   Vector3d vVelocity = info.Velocity();
+   double dMaxMoveTime = std::numeric_limits<double>::max();
+
+   switch (info.MovementMode())
+   {
+   case MovementInfo::movementStand:
+      dMaxMoveTime = 0.0;
+      break;
+
+   case MovementInfo::movementTarget:
+      if (vVelocity.Length() == 0.0)
+      {
+         vStart = info.Destination();
+         dMaxMoveTime = 0.0;
+      }
+      else
+         dMaxMoveTime = info.TimeToReachDestination();
+      break;
+
+   default:
+      break;
+   }
+
+   m_vecStartX[uiIndex] = vStart.X();
+   m_vecStartY[uiIndex] = vStart.Y();
+   m_vecStartZ[uiIndex] = vStart.Z();
+
+   m_vecVelocityX[uiIndex] = vVelocity.X();
+   m_vecVelocityY[uiIndex] = vVelocity.Y();
+   m_vecVelocityZ[uiIndex] = vVelocity.Z();
+
+   m_vecStartTime[uiIndex] = startTime.Get();
+   m_vecMaxMoveTime[uiIndex] = dMaxMoveTime;
+}
+
+void MovementIntegrator::MoveEntry(size_t uiFrom, size_t uiTo)
+{
+   m_vecMobiles[uiTo] = m_vecMobiles[uiFrom];
+
+   m_vecStartX[uiTo] = m_vecStartX[uiFrom];
+   m_vecStartY[uiTo] = m_vecStartY[uiFrom];
+   m_vecStartZ[uiTo] = m_vecStartZ[uiFrom];
+   m_vecVelocityX[uiTo] = m_vecVelocityX[uiFrom];
+   m_vecVelocityY[uiTo] = m_vecVelocityY[uiFrom];
+   m_vecVelocityZ[uiTo] = m_vecVelocityZ[uiFrom];
+   m_vecStartTime[uiTo] = m_vecStartTime[uiFrom];
+   m_vecMaxMoveTime[uiTo] = m_vecMaxMoveTime[uiFrom];
+   m_vecPosX[uiTo] = m_vecPosX[uiFrom];
+   m_vecPosY[uiTo] = m_vecPosY[uiFrom];
+   m_vecPosZ[uiTo] = m_vecPosZ[uiFrom];
+}
+
+void MovementIntegrator::ResizeEntries(size_t uiNumMobiles)
+{
+   m_vecStartX.resize(uiNumMobiles);
+   m_vecStartY.resize(uiNumMobiles);
+   m_vecStartZ.resize(uiNumMobiles);
+   m_vecVelocityX.resize(uiNumMobiles);
+   m_vecVelocityY.resize(uiNumMobiles);
+   m_vecVelocityZ.resize(uiNumMobiles);
+   m_vecStartTime.resize(uiNumMobiles);
+   m_vecMaxMoveTime.resize(uiNumMobiles);
+   m_vecMoveTime.resize(uiNumMobiles);
+   m_vecPosX.resize(uiNumMobiles);
+   m_vecPosY.resize(uiNumMobiles);
+   m_vecPosZ.resize(uiNumMobiles);
+}
@@ -0,0 +1,127 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file MovementIntegrator.hpp Batched movement of mobiles
+//
+#pragma once
+
+// includes
+#include "Common.hpp"
+#include "Mobile.hpp"
+#include "ObjectRegistry.hpp"
+#include "TimeBase.hpp"
+#include <vector>
+
+/// \brief moves all mobiles of a model in one pass
+/// \details Every movement mode is reduced to a linear movement: a start
+/// position, a velocity and a maximum movement time, which is only limited
+/// for movementTarget mode. The values are stored as separate arrays, one
+/// entry per mobile, so that Advance() only consists of loops without
+/// branches that the compiler can vectorize. Start times are time indices of the time
+/// base that is also used to advance the mobiles.
+class COMMON_DECLSPEC MovementIntegrator
+{
+public:
+   /// ctor
+   MovementIntegrator() {}
+
+   /// adds mobile, starting its current movement at given time index
+   void Add(const MobilePtr& spMobile, const TimeIndex& startTime);
+
+   /// sets new movement info for mobile; ignored when mobile isn't contained
+   void UpdateMovement(const ObjectId& id, const MovementInfo& info, const TimeIndex& startTime);
+
+   /// removes mobile; ignored when mobile isn't contained
+   void Remove(const ObjectId& id);
+
+   /// checks if mobile with given id is contained
+   bool Contains(const ObjectId& id) const { return m_registryIndex.Contains(id); }
+
+   /// reserves space for given number of mobiles
+   void Reserve(size_t uiNumMobiles);
+
+   /// calculates positions of all mobiles at given time index
+   void Advance(const TimeIndex& timeIndex);
+
+   /// \brief calculates positions of mobiles with index in range [uiStart; uiEnd) at given time index
+   /// \details ranges that don't overlap can be advanced in parallel
+   void Advance(const TimeIndex& timeIndex, size_t uiStart, size_t uiEnd);
+
+   /// writes positions calculated by Advance() to the mobiles; locks each mobile while writing
+   void WritePositions() const;
+
+   /// writes positions of mobiles with index in range [uiStart; uiEnd) to the mobiles
+   void WritePositions(size_t uiStart, size_t uiEnd) const;
+
+   // views on calculated positions
+
+   /// returns number of mobiles
+   size_t Size() const { return m_vecMobiles.size(); }
+
+   /// returns mobile with given index
+   const MobilePtr& MobileAt(size_t uiIndex) const { return m_vecMobiles[uiIndex]; }
+
+   /// returns position of mobile with given index
+   Vector3d PositionAt(size_t uiIndex) const
+   {
+      return Vector3d(m_vecPosX[uiIndex], m_vecPosY[uiIndex], m_vecPosZ[uiIndex]);
+   }
+
+   /// returns x positions of all mobiles
+   const double* PositionX() const { return m_vecPosX.data(); }
+
+   /// returns y positions of all mobiles
+   const double* PositionY() const { return m_vecPosY.data(); }
+
+   /// returns z positions of all mobiles
+   const double* PositionZ() const { return m_vecPosZ.data(); }
+
+private:
+   /// sets movement values of mobile with given index
+   void SetMovement(size_t uiIndex, const MovementInfo& info, const TimeIndex& startTime);
+
+   /// calculates one position component of all mobiles
+   static void AdvanceAxis(size_t uiNumMobiles, const double* pdStart, const double* pdVelocity,
+      const double* pdMoveTime, double* pdPos);
+
+   /// copies all values of mobile from one index to another
+   void MoveEntry(size_t uiFrom, size_t uiTo);
+
+   /// resizes all value arrays
+   void ResizeEntries(size_t uiNumMobiles);
+
+private:
+   /// index of mobile in the value arrays, by object id
+   ObjectRegistry<size_t> m_registryIndex;
+
+   /// all mobiles
+   std::vector<MobilePtr> m_vecMobiles;
+
+   // movement start positions
+
+   std::vector<double> m_vecStartX; ///< start position x
+   std::vector<double> m_vecStartY; ///< start position y
+   std::vector<double> m_vecStartZ; ///< start position z
+
+   // movement velocities, in units/s
+
+   std::vector<double> m_vecVelocityX; ///< velocity x
+   std::vector<double> m_vecVelocityY; ///< velocity y
+   std::vector<double> m_vecVelocityZ; ///< velocity z
+
+   /// start time index of movement
+   std::vector<double> m_vecStartTime;
+
+   /// maximum time that the mobile moves, in seconds
+   std::vector<double> m_vecMaxMoveTime;
+
+   /// time that the mobile moved, in seconds; only used in Advance()
+   std::vector<double> m_vecMoveTime;
+
+   // positions calculated by Advance()
+
+   std::vector<double> m_vecPosX; ///< position x
+   std::vector<double> m_vecPosY; ///< position y
+   std::vector<double> m_vecPosZ; ///< position z
+};
@@ -0,0 +1,238 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file MovementSnapshot.cpp Quantized movement snapshot
+//
+
+// includes
+#include "stdafx.h"
+#include "MovementSnapshot.hpp"
+#include "BitStream.hpp"
+
+/// position resolution; positions are stored in 1/32 units
+const double c_dPositionScale = 32.0;
+
+/// number of bits for a full position component; range is +/- 262144 units
+const unsigned int c_uiPositionBits = 24;
+
+/// number of bits for a position component delta; range is +/- 16 units
+const unsigned int c_uiPositionDeltaBits = 10;
+
+/// number of bits for direction; gives a resolution of about 0.35 degrees
+const unsigned int c_uiDirectionBits = 10;
+
+/// number of bits for speed
+const unsigned int c_uiSpeedBits = 8;
+
+/// number of bits for movement mode
+const unsigned int c_uiMovementModeBits = 2;
+
+/// number of bits for movement flags
+const unsigned int c_uiMovementFlagsBits = 4;
+
+/// bit mask values for fields that changed
+enum T_enChangedFields
+{
+   changedMovementMode = 1 << 0,
+   changedPos = 1 << 1,
+   changedDestPos = 1 << 2,
+   changedDirection = 1 << 3,
+   changedSpeed = 1 << 4,
+   changedMovementFlags = 1 << 5,
+
+   changedNumBits = 6
+};
+
+static_assert(MovementInfo::movementMax < (1 << c_uiMovementModeBits), "movement mode must fit into bits");
+
+/// quantizes position component, clamped to the range of a full position
+static int QuantizePosition(double dValue)
+{
+   const double dMax = static_cast<double>((1 << (c_uiPositionBits - 1)) - 1);
+
+   double dQuantized = std::floor(dValue * c_dPositionScale + 0.5);
+   dQuantized = std::min(std::max(dQuantized, -dMax), dMax);
+
+   return static_cast<int>(dQuantized);
+}
+
+/// quantizes position vector, relative to zone origin
+static void QuantizePosition(const Vector3d& vPos, const Vector3d& vZoneOrigin, int aiPos[3])
+{
+   Vector3d vRelPos = vPos - vZoneOrigin;
+
+   aiPos[0] = QuantizePosition(vRelPos.X());
+   aiPos[1] = QuantizePosition(vRelPos.Y());
+   aiPos[2] = QuantizePosition(vRelPos.Z());
+}
+
+/// returns position from quantized position, relative to zone origin
+static Vector3d DequantizePosition(const int aiPos[3], const Vector3d& vZoneOrigin)
+{
+   return vZoneOrigin + Vector3d(
+      aiPos[0] / c_dPositionScale,
+      aiPos[1] / c_dPositionScale,
+      aiPos[2] / c_dPositionScale);
+}
+
+MovementSnapshot::MovementSnapshot()
+:m_uiMovementMode(MovementInfo::movementStand),
+ m_uiDirection(0),
+ m_uiSpeed(0),
+ m_uiMovementFlags(0)
+{
+   std::fill(std::begin(m_aiPos), std::end(m_aiPos), 0);
+   std::fill(std::begin(m_aiDestPos), std::end(m_aiDestPos), 0);
+}
+
+MovementSnapshot::MovementSnapshot(const MovementInfo& info, const Vector3d& vZoneOrigin)
+:m_uiMovementMode(info.MovementMode()),
+ m_uiMovementFlags(info.MovementFlags())
+{
+   QuantizePosition(info.Position(), vZoneOrigin, m_aiPos);
+
+   if (info.MovementMode() == MovementInfo::movementTarget)
+      QuantizePosition(info.Destination(), vZoneOrigin, m_aiDestPos);
+   else
+      std::fill(std::begin(m_aiDestPos), std::end(m_aiDestPos), 0);
+
+   const unsigned int uiNumDirections = 1 << c_uiDirectionBits;
+   double dDirection = AngleInRange(info.Direction()) * uiNumDirections / 360.0;
+   m_uiDirection = static_cast<unsigned int>(std::floor(dDirection + 0.5)) & (uiNumDirections - 1);
+
+   const double dMaxSpeed = (1 << c_uiSpeedBits) - 1;
+   double dSpeed = std::floor(info.Speed() * 10.0 + 0.5);
+   m_uiSpeed = static_cast<unsigned int>(std::min(std::max(dSpeed, 0.0), dMaxSpeed));
+}
+
+MovementInfo MovementSnapshot::ToMovementInfo(const Vector3d& vZoneOrigin) const
+{
+   MovementInfo info(static_cast<MovementInfo::T_enMovementMode>(m_uiMovementMode));
+
+   info.Position(DequantizePosition(m_aiPos, vZoneOrigin));
+
+   if (m_uiMovementMode == MovementInfo::movementTarget)
+      info.Destination(DequantizePosition(m_aiDestPos, vZoneOrigin));
+
+   info.Direction(m_uiDirection * 360.0 / (1 << c_uiDirectionBits));
+   info.Speed(m_uiSpeed * 0.1);
+   info.MovementFlags(static_cast<unsigned char>(m_uiMovementFlags));
+
+   return info;
+}
+
+void MovementSnapshot::WriteDelta(BitWriter& writer, const MovementSnapshot& baseline) const
+{
+   unsigned int uiChanged = 0;
+
+   if (m_uiMovementMode != baseline.m_uiMovementMode)
+      uiChanged |= changedMovementMode;
+
+   if (!std::equal(std::begin(m_aiPos), std::end(m_aiPos), std::begin(baseline.m_aiPos)))
+      uiChanged |= changedPos;
+
+   if (!std::equal(std::begin(m_aiDestPos), std::end(m_aiDestPos), std::begin(baseline.m_aiDestPos)))
+      uiChanged |= changedDestPos;
+
+   if (m_uiDirection != baseline.m_uiDirection)
+      uiChanged |= changedDirection;
+
+   if (m_uiSpeed != baseline.m_uiSpeed)
+      uiChanged |= changedSpeed;
+
+   if (m_uiMovementFlags != baseline.m_uiMovementFlags)
+      uiChanged |= changedMovementFlags;
+
+   writer.Write(uiChanged, changedNumBits);
+
+   if ((uiChanged & changedMovementMode) != 0)
+      writer.Write(m_uiMovementMode, c_uiMovementModeBits);
+
+   if ((uiChanged & changedPos) != 0)
+      WritePosition(writer, m_aiPos, baseline.m_aiPos);
+
+   if ((uiChanged & changedDestPos) != 0)
+      WritePosition(writer, m_aiDestPos, baseline.m_aiDestPos);
+
+   if ((uiChanged & changedDirection) != 0)
+      writer.Write(m_uiDirection, c_uiDirectionBits);
+
+   if ((uiChanged & changedSpeed) != 0)
+      writer.Write(m_uiSpeed, c_uiSpeedBits);
+
+   if ((uiChanged & changedMovementFlags) != 0)
+      writer.Write(m_uiMovementFlags, c_uiMovementFlagsBits);
+}
+
+void MovementSnapshot::ReadDelta(BitReader& reader, const MovementSnapshot& baseline)
+{
+   *this = baseline;
+
+   unsigned int uiChanged = reader.Read(changedNumBits);
+
+   if ((uiChanged & changedMovementMode) != 0)
+   {
+      m_uiMovementMode = reader.Read(c_uiMovementModeBits);
+      if (m_uiMovementMode > MovementInfo::movementMax)
+         throw Exception(_T("invalid movement mode"), __FILE__, __LINE__);
+   }
+
+   if ((uiChanged & changedPos) != 0)
+      ReadPosition(reader, m_aiPos, baseline.m_aiPos);
+
+   if ((uiChanged & changedDestPos) != 0)
+      ReadPosition(reader, m_aiDestPos, baseline.m_aiDestPos);
+
+   if ((uiChanged & changedDirection) != 0)
+      m_uiDirection = reader.Read(c_uiDirectionBits);
+
+   if ((uiChanged & changedSpeed) != 0)
+      m_uiSpeed = reader.Read(c_uiSpeedBits);
+
+   if ((uiChanged & changedMovementFlags) != 0)
+      m_uiMovementFlags = reader.Read(c_uiMovementFlagsBits);
+}
+
+bool MovementSnapshot::operator==(const MovementSnapshot& rhs) const
+{
+   return m_uiMovementMode == rhs.m_uiMovementMode &&
+      std::equal(std::begin(m_aiPos), std::end(m_aiPos), std::begin(rhs.m_aiPos)) &&
+      std::equal(std::begin(m_aiDestPos), std::end(m_aiDestPos), std::begin(rhs.m_aiDestPos)) &&
+      m_uiDirection == rhs.m_uiDirection &&
+      m_uiSpeed == rhs.m_uiSpeed &&
+      m_uiMovementFlags == rhs.m_uiMovementFlags;
+}
+
+/// \details A single bit decides if the position is written as delta to the
+/// baseline position (when all components fit into the delta bits) or as full
+/// value.
+void MovementSnapshot::WritePosition(BitWriter& writer, const int aiPos[3], const int aiBaselinePos[3])
+{
+   bool bDelta = true;
+   for (unsigned int i = 0; i < 3; i++)
+      bDelta = bDelta && BitWriter::FitsSigned(aiPos[i] - aiBaselinePos[i], c_uiPositionDeltaBits);
+
+   writer.WriteBit(bDelta);
+
+   for (unsigned int i = 0; i < 3; i++)
+   {
+      if (bDelta)
+         writer.WriteSigned(aiPos[i] - aiBaselinePos[i], c_uiPositionDeltaBits);
+      else
+         writer.WriteSigned(aiPos[i], c_uiPositionBits);
+   }
+}
+
+void MovementSnapshot::ReadPosition(BitReader& reader, int aiPos[3], const int aiBaselinePos[3])
+{
+   bool bDelta = reader.ReadBit();
+
+   for (unsigned int i = 0; i < 3; i++)
+   {
+      if (bDelta)
+         aiPos[i] = aiBaselinePos[i] + reader.ReadSigned(c_uiPositionDeltaBits);
+      else
+         aiPos[i] = reader.ReadSigned(c_uiPositionBits);
+   }
+}
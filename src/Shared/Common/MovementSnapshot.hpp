@@ -0,0 +1,77 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file MovementSnapshot.hpp Quantized movement snapshot
+//
+#pragma once
+
+// includes
+#include "Common.hpp"
+#include "MovementInfo.hpp"
+
+// forward references
+class BitWriter;
+class BitReader;
+
+/// \brief quantized movement info, for delta compressed movement updates
+/// \details Stores all values of a MovementInfo as integers: positions are
+/// relative to the zone origin, in 1/32 units, the direction is stored with
+/// 10 bits and the speed in 0.1 units/s. Sender and receiver both keep the
+/// last snapshot that was sent for an object as baseline, and only the fields
+/// that changed compared to the baseline are written. Since both sides
+/// work on the quantized values, the baselines never drift apart.
+/// A default constructed snapshot is the baseline for the first update.
+class COMMON_DECLSPEC MovementSnapshot
+{
+public:
+   /// ctor; creates initial baseline snapshot
+   MovementSnapshot();
+
+   /// ctor; quantizes movement info
+   MovementSnapshot(const MovementInfo& info, const Vector3d& vZoneOrigin);
+
+   /// returns movement info with dequantized values
+   MovementInfo ToMovementInfo(const Vector3d& vZoneOrigin) const;
+
+   /// writes all fields that differ from baseline snapshot
+   void WriteDelta(BitWriter& writer, const MovementSnapshot& baseline) const;
+
+   /// reads fields written by WriteDelta(); all other fields are taken from baseline
+   void ReadDelta(BitReader& reader, const MovementSnapshot& baseline);
+
+   /// equality operator
+   bool operator==(const MovementSnapshot& rhs) const;
+
+   /// inequality operator
+   bool operator!=(const MovementSnapshot& rhs) const
+   {
+      return !operator==(rhs);
+   }
+
+private:
+   /// writes position, either as delta to baseline position or as full value
+   static void WritePosition(BitWriter& writer, const int aiPos[3], const int aiBaselinePos[3]);
+
+   /// reads position written by WritePosition()
+   static void ReadPosition(BitReader& reader, int aiPos[3], const int aiBaselinePos[3]);
+
+private:
+   /// movement mode
+   unsigned int m_uiMovementMode;
+
+   /// current position
+   int m_aiPos[3];
+
+   /// destination position; only used in movementTarget mode
+   int m_aiDestPos[3];
+
+   /// direction, in 1/1024 of a full circle
+   unsigned int m_uiDirection;
+
+   /// speed, in 0.1 units/s
+   unsigned int m_uiSpeed;
+
+   /// movement flags, as returned by MovementInfo::MovementFlags()
+   unsigned int m_uiMovementFlags;
+};
@@ -7,70 +7,89 @@
 #pragma once
 
 // includes
-#include <map>
 #include <ulib/Exception.hpp>
 #include "Object.hpp"
+#include "ObjectRegistry.hpp"
 
 /// \brief object map
-/// \details contains Object class instances
+/// \details contains Object class instances; objects are stored densely, so
+/// iterating over all objects is done linearly, in no particular order.
+/// Objects can be found by id, or by the handle returned when adding them.
 class ObjectMap
 {
 public:
-   /// internal map type
-   typedef std::map<ObjectId, ObjectPtr> T_mapObjects;
+   /// object iterator type; iterates over ObjectPtr values
+   typedef ObjectRegistry<ObjectPtr>::iterator iterator;
 
-   /// internal map iterator type
-   typedef T_mapObjects::iterator iterator;
-
-   /// internal map const iterator type
-   typedef T_mapObjects::const_iterator const_iterator;
+   /// object const iterator type
+   typedef ObjectRegistry<ObjectPtr>::const_iterator const_iterator;
 
    /// adds new object; throws when object is already in map
-   void AddObject(ObjectPtr ptr)
+   ObjectHandle AddObject(ObjectPtr ptr)
    {
-      T_mapObjects::const_iterator iter = m_mapObjects.find(ptr->Id());
-      if (iter != m_mapObjects.end())
-         throw Exception(_T("object already in map"), __FILE__, __LINE__);
-
-      m_mapObjects.insert(std::make_pair(ptr->Id(), ptr));
+      return m_registry.Add(ptr->Id(), ptr);
    }
 
    /// checks if an object with given id is in map
    bool IsInMap(ObjectId id) const
    {
-      T_mapObjects::const_iterator iter = m_mapObjects.find(id);
-      return iter != m_mapObjects.end();
+      return m_registry.Contains(id);
+   }
+
+   /// returns handle of object with given id; handle isn't set when object isn't in map
+   ObjectHandle FindHandle(const ObjectId& id) const
+   {
+      return m_registry.Find(id);
+   }
+
+   /// returns if handle refers to an object in map
+   bool IsValid(ObjectHandle handle) const
+   {
+      return m_registry.IsValid(handle);
+   }
+
+   /// returns object with given handle; throws when object isn't in map anymore
+   const ObjectPtr& Get(ObjectHandle handle) const
+   {
+      return m_registry.Get(handle);
+   }
+
+   /// returns object with given id; throws when object isn't in map
+   const ObjectPtr& Get(const ObjectId& id) const
+   {
+      return m_registry.Get(id);
    }
 
    /// finds object with given id in map; throws when object isn't in map
    ObjectRef FindObject(ObjectId id) const
    {
-      T_mapObjects::const_iterator iter = m_mapObjects.find(id);
-      if (iter == m_mapObjects.end())
-         throw Exception(_T("couldn't locate object with id=") + id.ToString(), __FILE__, __LINE__);
-
-      ObjectRef ref(iter->second->Id());
-      ref.m_sp = iter->second;
+      ObjectRef ref(id);
+      ref.m_sp = m_registry.Get(id);
       return ref;
    }
 
    /// removes object with given id from map; throws when object isn't in map
    void RemoveObject(ObjectId id)
    {
-      T_mapObjects::iterator iter = m_mapObjects.find(id);
-      if (iter == m_mapObjects.end())
-         throw Exception(_T("couldn't remove object with id=") + id.ToString(), __FILE__, __LINE__);
-
-      m_mapObjects.erase(iter);
+      m_registry.Remove(id);
    }
 
-   /// returns internal map reference
-   T_mapObjects& GetMap() { return m_mapObjects; }
+   /// returns number of objects in map
+   size_t Size() const { return m_registry.Size(); }
+
+   /// returns iterator to first object
+   iterator begin() { return m_registry.begin(); }
+
+   /// returns iterator after last object
+   iterator end() { return m_registry.end(); }
+
+   /// returns iterator to first object; const version
+   const_iterator begin() const { return m_registry.begin(); }
 
-   /// returns internal map reference; const version
-   const T_mapObjects& GetMap() const { return m_mapObjects; }
+   /// returns iterator after last object; const version
+   const_iterator end() const { return m_registry.end(); }
 
 private:
-   /// object map
-   T_mapObjects m_mapObjects;
+   /// object registry
+   ObjectRegistry<ObjectPtr> m_registry;
 };
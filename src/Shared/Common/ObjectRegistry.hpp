@@ -0,0 +1,420 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file ObjectRegistry.hpp Object registry with dense storage
+//
+#pragma once
+
+// includes
+#include "Object.hpp"
+#include <ulib/Exception.hpp>
+#include <vector>
+#include <cstring>
+
+/// \brief handle to an object in an object registry
+/// \details A handle is a 32-bit value that contains the index of the slot
+/// the object was registered in, and the generation of that slot. When the
+/// object is removed, the slot's generation is increased, so that handles to
+/// removed objects are detected, even when the slot is used again.
+class ObjectHandle
+{
+public:
+   /// ctor; creates handle that isn't set
+   ObjectHandle()
+      :m_uiValue(c_uiInvalidValue)
+   {
+   }
+
+   /// returns if handle was set; the object may have been removed in the meantime
+   bool IsSet() const { return m_uiValue != c_uiInvalidValue; }
+
+   /// returns 32-bit value of handle
+   unsigned int Value() const { return m_uiValue; }
+
+   /// equality comparison
+   bool operator==(const ObjectHandle& rhs) const { return m_uiValue == rhs.m_uiValue; }
+
+   /// inequality comparison
+   bool operator!=(const ObjectHandle& rhs) const { return m_uiValue != rhs.m_uiValue; }
+
+private:
+   template <typename TValue> friend class ObjectRegistry;
+
+   /// ctor; takes slot index and generation
+   ObjectHandle(unsigned int uiSlot, unsigned int uiGeneration)
+      :m_uiValue((uiGeneration << c_uiSlotBits) | uiSlot)
+   {
+   }
+
+   /// returns slot index
+   unsigned int Slot() const { return m_uiValue & c_uiSlotMask; }
+
+   /// returns slot generation
+   unsigned int Generation() const { return m_uiValue >> c_uiSlotBits; }
+
+private:
+   /// number of bits for the slot index; allows about one million objects
+   static const unsigned int c_uiSlotBits = 20;
+
+   /// mask for slot index; the highest slot index is never used
+   static const unsigned int c_uiSlotMask = (1U << c_uiSlotBits) - 1;
+
+   /// mask for generation; handles of a slot repeat after this many removals
+   static const unsigned int c_uiGenerationMask = (1U << (32 - c_uiSlotBits)) - 1;
+
+   /// value of a handle that isn't set
+   static const unsigned int c_uiInvalidValue = 0xffffffff;
+
+   /// handle value
+   unsigned int m_uiValue;
+};
+
+/// \brief registry of values for objects, stored densely
+/// \details Values are stored in one contiguous array, in no particular
+/// order, so that iterating over all values doesn't chase pointers; removing
+/// an object moves the last value into its place. Objects are found by
+/// handle, through a slot array, or by object id, through an open addressing
+/// hash table of slot indices with linear probing, which is kept at most half
+/// full. Handles stay valid until their object is removed; iterators and
+/// references to values are invalidated by adding and removing objects.
+template <typename TValue>
+class ObjectRegistry
+{
+public:
+   /// value iterator type
+   typedef typename std::vector<TValue>::iterator iterator;
+
+   /// value const iterator type
+   typedef typename std::vector<TValue>::const_iterator const_iterator;
+
+   /// adds object with value; throws when object is already in registry
+   ObjectHandle Add(const ObjectId& id, TValue value)
+   {
+      if (FindIndexPos(id) != c_uiNotFound)
+         throw Exception(_T("object already in map"), __FILE__, __LINE__);
+
+      if ((m_vecIds.size() + 1) * 2 > m_vecIndex.size())
+         RebuildIndex(m_vecIndex.empty() ? c_uiMinIndexSize : m_vecIndex.size() * 2);
+
+      unsigned int uiSlot;
+      if (!m_vecFreeSlots.empty())
+      {
+         uiSlot = m_vecFreeSlots.back();
+         m_vecFreeSlots.pop_back();
+      }
+      else
+      {
+         if (m_vecSlots.size() >= ObjectHandle::c_uiSlotMask)
+            throw Exception(_T("too many objects in map"), __FILE__, __LINE__);
+
+         uiSlot = static_cast<unsigned int>(m_vecSlots.size());
+         m_vecSlots.push_back(Slot());
+      }
+
+      Slot& slot = m_vecSlots[uiSlot];
+      slot.m_uiDenseIndex = static_cast<unsigned int>(m_vecValues.size());
+
+      m_vecIds.push_back(id);
+      m_vecValues.push_back(std::move(value));
+      m_vecSlotIndices.push_back(uiSlot);
+
+      InsertIndexEntry(id, uiSlot);
+
+      return ObjectHandle(uiSlot, slot.m_uiGeneration);
+   }
+
+   /// returns if object with given id is in registry
+   bool Contains(const ObjectId& id) const
+   {
+      return FindIndexPos(id) != c_uiNotFound;
+   }
+
+   /// returns handle of object with given id; the handle isn't set when object isn't in registry
+   ObjectHandle Find(const ObjectId& id) const
+   {
+      size_t uiPos = FindIndexPos(id);
+      if (uiPos == c_uiNotFound)
+         return ObjectHandle();
+
+      unsigned int uiSlot = m_vecIndex[uiPos];
+      return ObjectHandle(uiSlot, m_vecSlots[uiSlot].m_uiGeneration);
+   }
+
+   /// returns if handle refers to an object that is in registry
+   bool IsValid(ObjectHandle handle) const
+   {
+      return handle.IsSet() &&
+         handle.Slot() < m_vecSlots.size() &&
+         m_vecSlots[handle.Slot()].m_uiGeneration == handle.Generation();
+   }
+
+   /// returns value of object with given handle; throws when handle isn't valid
+   TValue& Get(ObjectHandle handle)
+   {
+      return m_vecValues[DenseIndex(handle)];
+   }
+
+   /// returns value of object with given handle; throws when handle isn't valid; const version
+   const TValue& Get(ObjectHandle handle) const
+   {
+      return m_vecValues[DenseIndex(handle)];
+   }
+
+   /// returns value of object with given id; throws when object isn't in registry
+   TValue& Get(const ObjectId& id)
+   {
+      return m_vecValues[DenseIndex(id)];
+   }
+
+   /// returns value of object with given id; throws when object isn't in registry; const version
+   const TValue& Get(const ObjectId& id) const
+   {
+      return m_vecValues[DenseIndex(id)];
+   }
+
+   /// removes object with given id; throws when object isn't in registry
+   void Remove(const ObjectId& id)
+   {
+      size_t uiPos = FindIndexPos(id);
+      if (uiPos == c_uiNotFound)
+         throw Exception(_T("couldn't remove object with id=") + id.ToString(), __FILE__, __LINE__);
+
+      RemoveAt(uiPos);
+   }
+
+   /// removes object with given handle; throws when handle isn't valid
+   void Remove(ObjectHandle handle)
+   {
+      RemoveAt(FindIndexPos(m_vecIds[DenseIndex(handle)]));
+   }
+
+   /// reserves space for given number of objects
+   void Reserve(size_t uiNumObjects)
+   {
+      m_vecIds.reserve(uiNumObjects);
+      m_vecValues.reserve(uiNumObjects);
+      m_vecSlotIndices.reserve(uiNumObjects);
+      m_vecSlots.reserve(uiNumObjects);
+
+      size_t uiIndexSize = c_uiMinIndexSize;
+      while (uiIndexSize < uiNumObjects * 2)
+         uiIndexSize *= 2;
+
+      if (uiIndexSize > m_vecIndex.size())
+         RebuildIndex(uiIndexSize);
+   }
+
+   /// returns number of objects in registry
+   size_t Size() const { return m_vecValues.size(); }
+
+   /// returns if registry contains no objects
+   bool IsEmpty() const { return m_vecValues.empty(); }
+
+   // dense access; indices are in range [0; Size()) and change when objects are removed
+
+   /// returns object id at dense index
+   const ObjectId& IdAt(size_t uiIndex) const { return m_vecIds[uiIndex]; }
+
+   /// returns value at dense index
+   TValue& ValueAt(size_t uiIndex) { return m_vecValues[uiIndex]; }
+
+   /// returns value at dense index; const version
+   const TValue& ValueAt(size_t uiIndex) const { return m_vecValues[uiIndex]; }
+
+   /// returns handle of object at dense index
+   ObjectHandle HandleAt(size_t uiIndex) const
+   {
+      unsigned int uiSlot = m_vecSlotIndices[uiIndex];
+      return ObjectHandle(uiSlot, m_vecSlots[uiSlot].m_uiGeneration);
+   }
+
+   /// returns iterator to first value
+   iterator begin() { return m_vecValues.begin(); }
+
+   /// returns iterator after last value
+   iterator end() { return m_vecValues.end(); }
+
+   /// returns iterator to first value; const version
+   const_iterator begin() const { return m_vecValues.begin(); }
+
+   /// returns iterator after last value; const version
+   const_iterator end() const { return m_vecValues.end(); }
+
+private:
+   /// returns hash of object id; mixes both halves of the id, since not all bytes of an id are random
+   static size_t HashId(const ObjectId& id)
+   {
+      unsigned long long aullData[2];
+      memcpy(aullData, id.Raw(), sizeof(aullData));
+
+      unsigned long long ullHash = aullData[0] ^ (aullData[1] * 0x9e3779b97f4a7c15ULL);
+      ullHash ^= ullHash >> 32;
+      ullHash *= 0xbf58476d1ce4e5b9ULL;
+      ullHash ^= ullHash >> 29;
+
+      return static_cast<size_t>(ullHash);
+   }
+
+   /// compares object ids
+   static bool IdEquals(const ObjectId& id1, const ObjectId& id2)
+   {
+      return memcmp(id1.Raw(), id2.Raw(), sizeof(GUID)) == 0;
+   }
+
+   /// returns position of object's slot index in hash table, or c_uiNotFound
+   size_t FindIndexPos(const ObjectId& id) const
+   {
+      if (m_vecIndex.empty())
+         return c_uiNotFound;
+
+      size_t uiMask = m_vecIndex.size() - 1;
+      for (size_t uiPos = HashId(id) & uiMask; ; uiPos = (uiPos + 1) & uiMask)
+      {
+         unsigned int uiSlot = m_vecIndex[uiPos];
+         if (uiSlot == c_uiEmptyEntry)
+            return c_uiNotFound;
+
+         if (IdEquals(m_vecIds[m_vecSlots[uiSlot].m_uiDenseIndex], id))
+            return uiPos;
+      }
+   }
+
+   /// inserts slot index into hash table; object must not be in hash table
+   void InsertIndexEntry(const ObjectId& id, unsigned int uiSlot)
+   {
+      size_t uiMask = m_vecIndex.size() - 1;
+
+      size_t uiPos = HashId(id) & uiMask;
+      while (m_vecIndex[uiPos] != c_uiEmptyEntry)
+         uiPos = (uiPos + 1) & uiMask;
+
+      m_vecIndex[uiPos] = uiSlot;
+   }
+
+   /// \brief removes entry from hash table
+   /// \details Following entries of the same probe sequence are shifted back
+   /// into the hole, so that no tombstones are needed.
+   void RemoveIndexEntry(size_t uiPos)
+   {
+      size_t uiMask = m_vecIndex.size() - 1;
+      size_t uiHole = uiPos;
+
+      for (size_t uiNext = (uiHole + 1) & uiMask; m_vecIndex[uiNext] != c_uiEmptyEntry; uiNext = (uiNext + 1) & uiMask)
+      {
+         unsigned int uiSlot = m_vecIndex[uiNext];
+         size_t uiHome = HashId(m_vecIds[m_vecSlots[uiSlot].m_uiDenseIndex]) & uiMask;
+
+         // entry may only move when the hole lies between its home position and its position
+         if (((uiNext - uiHome) & uiMask) >= ((uiNext - uiHole) & uiMask))
+         {
+            m_vecIndex[uiHole] = uiSlot;
+            uiHole = uiNext;
+         }
+      }
+
+      m_vecIndex[uiHole] = c_uiEmptyEntry;
+   }
+
+   /// rebuilds hash table with new size; size must be a power of two
+   void RebuildIndex(size_t uiIndexSize)
+   {
+      m_vecIndex.assign(uiIndexSize, static_cast<unsigned int>(c_uiEmptyEntry));
+
+      for (size_t i=0, iMax=m_vecIds.size(); i<iMax; i++)
+         InsertIndexEntry(m_vecIds[i], m_vecSlotIndices[i]);
+   }
+
+   /// removes object whose slot index is at given hash table position
+   void RemoveAt(size_t uiPos)
+   {
+      unsigned int uiSlot = m_vecIndex[uiPos];
+      RemoveIndexEntry(uiPos);
+
+      Slot& slot = m_vecSlots[uiSlot];
+
+      // move last value into the place of the removed one
+      size_t uiIndex = slot.m_uiDenseIndex;
+      size_t uiLast = m_vecValues.size() - 1;
+      if (uiIndex != uiLast)
+      {
+         m_vecIds[uiIndex] = m_vecIds[uiLast];
+         m_vecValues[uiIndex] = std::move(m_vecValues[uiLast]);
+         m_vecSlotIndices[uiIndex] = m_vecSlotIndices[uiLast];
+
+         m_vecSlots[m_vecSlotIndices[uiIndex]].m_uiDenseIndex = static_cast<unsigned int>(uiIndex);
+      }
+
+      m_vecIds.pop_back();
+      m_vecValues.pop_back();
+      m_vecSlotIndices.pop_back();
+
+      // invalidates all handles to the slot
+      slot.m_uiGeneration = (slot.m_uiGeneration + 1) & ObjectHandle::c_uiGenerationMask;
+      m_vecFreeSlots.push_back(uiSlot);
+   }
+
+   /// returns dense index of object with given handle; throws when handle isn't valid
+   size_t DenseIndex(ObjectHandle handle) const
+   {
+      if (!IsValid(handle))
+         throw Exception(_T("couldn't locate object with invalid handle"), __FILE__, __LINE__);
+
+      return m_vecSlots[handle.Slot()].m_uiDenseIndex;
+   }
+
+   /// returns dense index of object with given id; throws when object isn't in registry
+   size_t DenseIndex(const ObjectId& id) const
+   {
+      size_t uiPos = FindIndexPos(id);
+      if (uiPos == c_uiNotFound)
+         throw Exception(_T("couldn't locate object with id=") + id.ToString(), __FILE__, __LINE__);
+
+      return m_vecSlots[m_vecIndex[uiPos]].m_uiDenseIndex;
+   }
+
+private:
+   /// slot that an object handle refers to
+   struct Slot
+   {
+      /// ctor
+      Slot()
+         :m_uiDenseIndex(0),
+          m_uiGeneration(0)
+      {
+      }
+
+      /// index of object in dense arrays
+      unsigned int m_uiDenseIndex;
+
+      /// generation; increased when object is removed
+      unsigned int m_uiGeneration;
+   };
+
+   /// value of an empty hash table entry
+   static const unsigned int c_uiEmptyEntry = 0xffffffff;
+
+   /// hash table position that is returned when object wasn't found
+   static const size_t c_uiNotFound = static_cast<size_t>(-1);
+
+   /// minimum size of hash table
+   static const size_t c_uiMinIndexSize = 16;
+
+   /// object ids; dense
+   std::vector<ObjectId> m_vecIds;
+
+   /// values; dense, in the same order as the object ids
+   std::vector<TValue> m_vecValues;
+
+   /// slot indices of objects; dense, in the same order as the object ids
+   std::vector<unsigned int> m_vecSlotIndices;
+
+   /// slots; indexed by handle
+   std::vector<Slot> m_vecSlots;
+
+   /// indices of slots that are free to be used again
+   std::vector<unsigned int> m_vecFreeSlots;
+
+   /// hash table with slot indices; size is a power of two
+   std::vector<unsigned int> m_vecIndex;
+};
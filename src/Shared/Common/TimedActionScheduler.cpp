@@ -0,0 +1,329 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file TimedActionScheduler.cpp Scheduler for timed actions
+//
+
+// includes
+#include "stdafx.h"
+#include "TimedActionScheduler.hpp"
+#include <cmath>
+
+/// tolerance when converting time indices to ticks, in ticks
+const double c_dTickTolerance = 1e-6;
+
+TimedActionScheduler::TimedActionScheduler(double dTickInterval)
+:m_dTickInterval(dTickInterval),
+ m_ullCurrentTick(0),
+ m_uiNumScheduled(0),
+ m_uiFreeHead(c_uiInvalidIndex)
+{
+   ATLASSERT(dTickInterval > 0.0);
+
+   const unsigned int uiInvalidIndex = c_uiInvalidIndex;
+   m_vecSlotHeads.resize(c_uiNumLevels * c_uiSlotsPerLevel, uiInvalidIndex);
+}
+
+TimedActionHandle TimedActionScheduler::Schedule(const TimeIndex& dueTime, ActionPtr spAction,
+   const ObjectId& ownerId)
+{
+   return ScheduleEntry(DueTick(dueTime), 0, 0, spAction, ownerId);
+}
+
+/// \details The interval is rounded to full ticks, but is at least one tick.
+TimedActionHandle TimedActionScheduler::SchedulePeriodic(const TimeIndex& firstDueTime, double dInterval,
+   unsigned int uiNumTimes, ActionPtr spAction, const ObjectId& ownerId)
+{
+   if (uiNumTimes == 0)
+      return TimedActionHandle();
+
+   double dIntervalTicks = std::floor(dInterval / m_dTickInterval + 0.5);
+   unsigned long long ullIntervalTicks = dIntervalTicks < 1.0 ? 1 : static_cast<unsigned long long>(dIntervalTicks);
+
+   return ScheduleEntry(DueTick(firstDueTime), ullIntervalTicks, uiNumTimes - 1, spAction, ownerId);
+}
+
+bool TimedActionScheduler::Cancel(const TimedActionHandle& handle)
+{
+   if (!IsScheduled(handle))
+      return false;
+
+   UnlinkSlot(handle.m_uiIndex);
+   UnlinkOwner(handle.m_uiIndex);
+   FreeEntry(handle.m_uiIndex);
+
+   return true;
+}
+
+void TimedActionScheduler::CancelAll(const ObjectId& ownerId)
+{
+   ObjectHandle handle = m_registryOwnerHeads.Find(ownerId);
+   if (!handle.IsSet())
+      return;
+
+   unsigned int uiIndex = m_registryOwnerHeads.Get(handle);
+   m_registryOwnerHeads.Remove(handle);
+
+   while (uiIndex != c_uiInvalidIndex)
+   {
+      unsigned int uiNext = m_vecEntries[uiIndex].m_uiOwnerNext;
+
+      UnlinkSlot(uiIndex);
+      FreeEntry(uiIndex);
+
+      uiIndex = uiNext;
+   }
+}
+
+bool TimedActionScheduler::IsScheduled(const TimedActionHandle& handle) const
+{
+   if (!handle.IsSet() || handle.m_uiIndex >= m_vecEntries.size())
+      return false;
+
+   const Entry& entry = m_vecEntries[handle.m_uiIndex];
+   return entry.m_uiGeneration == handle.m_uiGeneration && entry.m_spAction != NULL;
+}
+
+void TimedActionScheduler::Reserve(size_t uiNumActions)
+{
+   m_vecEntries.reserve(uiNumActions);
+}
+
+/// \details When no actions are scheduled, the wheels are empty and the
+/// current tick can be set directly, so that long idle times don't cost
+/// anything.
+void TimedActionScheduler::Advance(const TimeIndex& timeIndex, std::vector<ActionPtr>& vecExpiredActions)
+{
+   double dTargetTick = std::floor(timeIndex.Get() / m_dTickInterval + c_dTickTolerance);
+   if (dTargetTick <= 0.0)
+      return;
+
+   unsigned long long ullTargetTick = static_cast<unsigned long long>(dTargetTick);
+
+   while (m_ullCurrentTick < ullTargetTick)
+   {
+      if (m_uiNumScheduled == 0)
+      {
+         m_ullCurrentTick = ullTargetTick;
+         break;
+      }
+
+      m_ullCurrentTick++;
+
+      // when the lowest wheel completes a turn, cascade the next slot of each
+      // wheel that completes a turn, too
+      if ((m_ullCurrentTick & (c_uiSlotsPerLevel - 1)) == 0)
+      {
+         for (unsigned int uiLevel = 1; uiLevel < c_uiNumLevels; uiLevel++)
+         {
+            Cascade(uiLevel);
+
+            if (((m_ullCurrentTick >> (c_uiSlotBits * uiLevel)) & (c_uiSlotsPerLevel - 1)) != 0)
+               break;
+         }
+      }
+
+      ExpireCurrentSlot(vecExpiredActions);
+   }
+}
+
+/// \details Actions that are due at or before the current tick are scheduled
+/// for the next tick, since the current tick has already expired.
+TimedActionHandle TimedActionScheduler::ScheduleEntry(unsigned long long ullDueTick,
+   unsigned long long ullIntervalTicks, unsigned int uiRemainingRepeats, ActionPtr spAction,
+   const ObjectId& ownerId)
+{
+   ATLASSERT(spAction != NULL);
+
+   unsigned int uiIndex = m_uiFreeHead;
+   if (uiIndex != c_uiInvalidIndex)
+      m_uiFreeHead = m_vecEntries[uiIndex].m_uiNext;
+   else
+   {
+      if (m_vecEntries.size() >= c_uiInvalidIndex)
+         throw Exception(_T("too many timed actions scheduled"), __FILE__, __LINE__);
+
+      uiIndex = static_cast<unsigned int>(m_vecEntries.size());
+      m_vecEntries.push_back(Entry());
+   }
+
+   Entry& entry = m_vecEntries[uiIndex];
+   entry.m_spAction = spAction;
+   entry.m_ownerId = ownerId;
+   entry.m_ullDueTick = ullDueTick <= m_ullCurrentTick ? m_ullCurrentTick + 1 : ullDueTick;
+   entry.m_ullIntervalTicks = ullIntervalTicks;
+   entry.m_uiRemainingRepeats = uiRemainingRepeats;
+
+   // link at front of owner list
+   ObjectHandle handleOwner = m_registryOwnerHeads.Find(ownerId);
+   if (handleOwner.IsSet())
+   {
+      unsigned int& uiOwnerHead = m_registryOwnerHeads.Get(handleOwner);
+      m_vecEntries[uiOwnerHead].m_uiOwnerPrev = uiIndex;
+      entry.m_uiOwnerNext = uiOwnerHead;
+      uiOwnerHead = uiIndex;
+   }
+   else
+   {
+      entry.m_uiOwnerNext = c_uiInvalidIndex;
+      m_registryOwnerHeads.Add(ownerId, uiIndex);
+   }
+   entry.m_uiOwnerPrev = c_uiInvalidIndex;
+
+   LinkSlot(uiIndex);
+
+   m_uiNumScheduled++;
+
+   return TimedActionHandle(uiIndex, entry.m_uiGeneration);
+}
+
+unsigned long long TimedActionScheduler::DueTick(const TimeIndex& timeIndex) const
+{
+   double dTick = std::ceil(timeIndex.Get() / m_dTickInterval - c_dTickTolerance);
+   return dTick <= 0.0 ? 0 : static_cast<unsigned long long>(dTick);
+}
+
+/// \details The entry is put into the lowest wheel whose range covers the
+/// number of ticks until it is due; the slot is selected by the due tick's
+/// bits for that wheel. Entries that are due after the range of the highest
+/// wheel are put into its last slot in range, and are linked again with their
+/// real due tick when the slot is cascaded.
+void TimedActionScheduler::LinkSlot(unsigned int uiIndex)
+{
+   Entry& entry = m_vecEntries[uiIndex];
+   ATLASSERT(entry.m_ullDueTick >= m_ullCurrentTick);
+
+   const unsigned long long ullMaxDelta = (1ULL << (c_uiSlotBits * c_uiNumLevels)) - 1;
+
+   unsigned long long ullDueTick = entry.m_ullDueTick;
+   if (ullDueTick - m_ullCurrentTick > ullMaxDelta)
+      ullDueTick = m_ullCurrentTick + ullMaxDelta;
+
+   unsigned long long ullDelta = ullDueTick - m_ullCurrentTick;
+
+   unsigned int uiLevel = 0;
+   while (uiLevel + 1 < c_uiNumLevels && ullDelta >= (1ULL << (c_uiSlotBits * (uiLevel + 1))))
+      uiLevel++;
+
+   unsigned int uiSlot = uiLevel * c_uiSlotsPerLevel +
+      static_cast<unsigned int>((ullDueTick >> (c_uiSlotBits * uiLevel)) & (c_uiSlotsPerLevel - 1));
+
+   unsigned int& uiHead = m_vecSlotHeads[uiSlot];
+   if (uiHead != c_uiInvalidIndex)
+      m_vecEntries[uiHead].m_uiPrev = uiIndex;
+
+   entry.m_uiSlot = uiSlot;
+   entry.m_uiPrev = c_uiInvalidIndex;
+   entry.m_uiNext = uiHead;
+   uiHead = uiIndex;
+}
+
+void TimedActionScheduler::UnlinkSlot(unsigned int uiIndex)
+{
+   Entry& entry = m_vecEntries[uiIndex];
+   if (entry.m_uiSlot == c_uiInvalidIndex)
+      return;
+
+   if (entry.m_uiPrev != c_uiInvalidIndex)
+      m_vecEntries[entry.m_uiPrev].m_uiNext = entry.m_uiNext;
+   else
+      m_vecSlotHeads[entry.m_uiSlot] = entry.m_uiNext;
+
+   if (entry.m_uiNext != c_uiInvalidIndex)
+      m_vecEntries[entry.m_uiNext].m_uiPrev = entry.m_uiPrev;
+
+   entry.m_uiSlot = c_uiInvalidIndex;
+}
+
+void TimedActionScheduler::UnlinkOwner(unsigned int uiIndex)
+{
+   Entry& entry = m_vecEntries[uiIndex];
+
+   if (entry.m_uiOwnerPrev != c_uiInvalidIndex)
+      m_vecEntries[entry.m_uiOwnerPrev].m_uiOwnerNext = entry.m_uiOwnerNext;
+   else
+   {
+      // entry is owner list head
+      if (entry.m_uiOwnerNext != c_uiInvalidIndex)
+         m_registryOwnerHeads.Get(entry.m_ownerId) = entry.m_uiOwnerNext;
+      else
+         m_registryOwnerHeads.Remove(entry.m_ownerId);
+   }
+
+   if (entry.m_uiOwnerNext != c_uiInvalidIndex)
+      m_vecEntries[entry.m_uiOwnerNext].m_uiOwnerPrev = entry.m_uiOwnerPrev;
+}
+
+/// \details The generation is increased, so that existing handles to the
+/// entry become invalid.
+void TimedActionScheduler::FreeEntry(unsigned int uiIndex)
+{
+   Entry& entry = m_vecEntries[uiIndex];
+
+   entry.m_spAction.reset();
+   entry.m_uiGeneration++;
+   entry.m_uiSlot = c_uiInvalidIndex;
+   entry.m_uiPrev = c_uiInvalidIndex;
+   entry.m_uiOwnerPrev = c_uiInvalidIndex;
+   entry.m_uiOwnerNext = c_uiInvalidIndex;
+
+   entry.m_uiNext = m_uiFreeHead;
+   m_uiFreeHead = uiIndex;
+
+   ATLASSERT(m_uiNumScheduled > 0);
+   m_uiNumScheduled--;
+}
+
+/// \details All entries of the slot are due in the block of ticks that starts
+/// with the current tick, so they are linked into lower wheels, or into the
+/// slot of the current tick that is expired next.
+void TimedActionScheduler::Cascade(unsigned int uiLevel)
+{
+   unsigned int uiSlot = uiLevel * c_uiSlotsPerLevel +
+      static_cast<unsigned int>((m_ullCurrentTick >> (c_uiSlotBits * uiLevel)) & (c_uiSlotsPerLevel - 1));
+
+   unsigned int uiIndex = m_vecSlotHeads[uiSlot];
+   m_vecSlotHeads[uiSlot] = c_uiInvalidIndex;
+
+   while (uiIndex != c_uiInvalidIndex)
+   {
+      unsigned int uiNext = m_vecEntries[uiIndex].m_uiNext;
+      LinkSlot(uiIndex);
+      uiIndex = uiNext;
+   }
+}
+
+/// \details Periodic entries with remaining repetitions are linked again for
+/// their next due tick; all other entries are freed.
+void TimedActionScheduler::ExpireCurrentSlot(std::vector<ActionPtr>& vecExpiredActions)
+{
+   unsigned int uiSlot = static_cast<unsigned int>(m_ullCurrentTick & (c_uiSlotsPerLevel - 1));
+
+   unsigned int uiIndex = m_vecSlotHeads[uiSlot];
+   m_vecSlotHeads[uiSlot] = c_uiInvalidIndex;
+
+   while (uiIndex != c_uiInvalidIndex)
+   {
+      Entry& entry = m_vecEntries[uiIndex];
+      unsigned int uiNext = entry.m_uiNext;
+
+      ATLASSERT(entry.m_ullDueTick == m_ullCurrentTick);
+      vecExpiredActions.push_back(entry.m_spAction);
+
+      if (entry.m_uiRemainingRepeats > 0)
+      {
+         entry.m_uiRemainingRepeats--;
+         entry.m_ullDueTick += entry.m_ullIntervalTicks;
+         LinkSlot(uiIndex);
+      }
+      else
+      {
+         entry.m_uiSlot = c_uiInvalidIndex;
+         UnlinkOwner(uiIndex);
+         FreeEntry(uiIndex);
+      }
+
+      uiIndex = uiNext;
+   }
+}
@@ -0,0 +1,199 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file TimedActionScheduler.hpp Scheduler for timed actions
+//
+#pragma once
+
+// includes
+#include "Common.hpp"
+#include "Action.hpp"
+#include "ObjectRegistry.hpp"
+#include "TimeBase.hpp"
+#include <vector>
+
+/// \brief handle to an action scheduled in a timed action scheduler
+/// \details The handle contains the index of the timer entry and the
+/// generation of that entry, so that handles of expired or cancelled timers
+/// are detected, even when the entry is used again.
+class TimedActionHandle
+{
+public:
+   /// ctor; creates handle that isn't set
+   TimedActionHandle()
+      :m_uiIndex(c_uiInvalidIndex),
+       m_uiGeneration(0)
+   {
+   }
+
+   /// returns if handle was set; the action may have expired in the meantime
+   bool IsSet() const { return m_uiIndex != c_uiInvalidIndex; }
+
+   /// equality comparison
+   bool operator==(const TimedActionHandle& rhs) const
+   {
+      return m_uiIndex == rhs.m_uiIndex && m_uiGeneration == rhs.m_uiGeneration;
+   }
+
+   /// inequality comparison
+   bool operator!=(const TimedActionHandle& rhs) const { return !(*this == rhs); }
+
+private:
+   friend class TimedActionScheduler;
+
+   /// ctor; takes entry index and generation
+   TimedActionHandle(unsigned int uiIndex, unsigned int uiGeneration)
+      :m_uiIndex(uiIndex),
+       m_uiGeneration(uiGeneration)
+   {
+   }
+
+   /// index value of a handle that isn't set
+   static const unsigned int c_uiInvalidIndex = 0xffffffff;
+
+   /// entry index
+   unsigned int m_uiIndex;
+
+   /// entry generation
+   unsigned int m_uiGeneration;
+};
+
+/// \brief schedules actions to be carried out at a given time index
+/// \details The scheduler is a hierarchical timer wheel. Time is divided into
+/// ticks of fixed length; the lowest wheel has one slot per tick, and each
+/// higher wheel has one slot per full turn of the wheel below. An action is
+/// put into the slot of the lowest wheel that reaches its due tick; when a
+/// wheel completes a turn, the next slot of the wheel above is cascaded down.
+/// Scheduling and cancelling are O(1), and advancing only touches the slots
+/// of the passed ticks, regardless of how many actions are scheduled.
+/// Actions are never carried out before their due time, but up to one tick
+/// later. Each action is owned by an object, usually the mobile it affects,
+/// so that all actions of a mobile can be cancelled when it dies or leaves.
+/// Periodic actions, e.g. damage over time spells, are rescheduled after
+/// each expiry and keep their handle until the last repetition. The class is
+/// not thread-safe.
+class COMMON_DECLSPEC TimedActionScheduler
+{
+public:
+   /// ctor; takes length of a tick in seconds
+   explicit TimedActionScheduler(double dTickInterval = 0.1);
+
+   /// schedules action for given time index
+   TimedActionHandle Schedule(const TimeIndex& dueTime, ActionPtr spAction, const ObjectId& ownerId);
+
+   /// schedules action that is repeated in given interval, in seconds; in total, the action
+   /// expires uiNumTimes times
+   TimedActionHandle SchedulePeriodic(const TimeIndex& firstDueTime, double dInterval,
+      unsigned int uiNumTimes, ActionPtr spAction, const ObjectId& ownerId);
+
+   /// cancels scheduled action; returns false when the action already expired or was cancelled
+   bool Cancel(const TimedActionHandle& handle);
+
+   /// cancels all actions owned by given object
+   void CancelAll(const ObjectId& ownerId);
+
+   /// checks if the action of the handle is still scheduled
+   bool IsScheduled(const TimedActionHandle& handle) const;
+
+   /// returns number of scheduled actions
+   size_t Size() const { return m_uiNumScheduled; }
+
+   /// reserves space for given number of scheduled actions
+   void Reserve(size_t uiNumActions);
+
+   /// advances to given time index and appends all actions that expired, in order of
+   /// their due tick
+   void Advance(const TimeIndex& timeIndex, std::vector<ActionPtr>& vecExpiredActions);
+
+private:
+   /// timer entry
+   struct Entry
+   {
+      /// ctor
+      Entry()
+         :m_ownerId(ObjectId::Null()),
+          m_ullDueTick(0),
+          m_ullIntervalTicks(0),
+          m_uiRemainingRepeats(0),
+          m_uiGeneration(0),
+          m_uiSlot(c_uiInvalidIndex),
+          m_uiPrev(c_uiInvalidIndex),
+          m_uiNext(c_uiInvalidIndex),
+          m_uiOwnerPrev(c_uiInvalidIndex),
+          m_uiOwnerNext(c_uiInvalidIndex)
+      {
+      }
+
+      ActionPtr m_spAction;               ///< scheduled action; null when entry is free
+      ObjectId m_ownerId;                 ///< id of object owning the action
+      unsigned long long m_ullDueTick;    ///< tick the action is due
+      unsigned long long m_ullIntervalTicks; ///< ticks between repetitions
+      unsigned int m_uiRemainingRepeats;  ///< number of repetitions after the next expiry
+      unsigned int m_uiGeneration;        ///< generation; increased when entry is freed
+      unsigned int m_uiSlot;              ///< wheel slot the entry is linked into
+      unsigned int m_uiPrev;              ///< previous entry in slot list
+      unsigned int m_uiNext;              ///< next entry in slot list; also used for free list
+      unsigned int m_uiOwnerPrev;         ///< previous entry of the same owner
+      unsigned int m_uiOwnerNext;         ///< next entry of the same owner
+   };
+
+   /// allocates entry and schedules it
+   TimedActionHandle ScheduleEntry(unsigned long long ullDueTick, unsigned long long ullIntervalTicks,
+      unsigned int uiRemainingRepeats, ActionPtr spAction, const ObjectId& ownerId);
+
+   /// converts time index to the first tick that isn't earlier
+   unsigned long long DueTick(const TimeIndex& timeIndex) const;
+
+   /// links entry into the wheel slot for its due tick
+   void LinkSlot(unsigned int uiIndex);
+
+   /// unlinks entry from its wheel slot
+   void UnlinkSlot(unsigned int uiIndex);
+
+   /// unlinks entry from the list of its owner
+   void UnlinkOwner(unsigned int uiIndex);
+
+   /// unlinks entry from all lists and puts it to the free list
+   void FreeEntry(unsigned int uiIndex);
+
+   /// moves all entries of a slot of a higher wheel to lower wheels
+   void Cascade(unsigned int uiLevel);
+
+   /// expires all entries in the lowest wheel's slot of the current tick
+   void ExpireCurrentSlot(std::vector<ActionPtr>& vecExpiredActions);
+
+private:
+   /// number of bits of the tick that select the slot in one wheel
+   static const unsigned int c_uiSlotBits = 6;
+
+   /// number of slots per wheel
+   static const unsigned int c_uiSlotsPerLevel = 1U << c_uiSlotBits;
+
+   /// number of wheels; the wheels cover 2^24 ticks, which is about 19 days with 0.1s ticks
+   static const unsigned int c_uiNumLevels = 4;
+
+   /// invalid entry or slot index
+   static const unsigned int c_uiInvalidIndex = 0xffffffff;
+
+   /// length of a tick, in seconds
+   double m_dTickInterval;
+
+   /// current tick; all ticks up to and including this one have expired
+   unsigned long long m_ullCurrentTick;
+
+   /// number of scheduled actions
+   size_t m_uiNumScheduled;
+
+   /// all entries, scheduled and free
+   std::vector<Entry> m_vecEntries;
+
+   /// first free entry
+   unsigned int m_uiFreeHead;
+
+   /// first entry of each wheel slot; slot index is level * c_uiSlotsPerLevel + slot
+   std::vector<unsigned int> m_vecSlotHeads;
+
+   /// first entry of each owner
+   ObjectRegistry<unsigned int> m_registryOwnerHeads;
+};
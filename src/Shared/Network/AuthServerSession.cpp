@@ -21,6 +21,24 @@ void AuthServerSession::SetAuthenticationModule(std::shared_ptr<IServerAuthModul
 {
    m_spAuthModule = spAuthModule;
    m_spAuthModule->SetSession(shared_from_this());
+
+   // handlers only keep a weak reference, since the session owns the auth module
+   std::weak_ptr<AuthServerSession> wpSession =
+      std::static_pointer_cast<AuthServerSession>(shared_from_this());
+
+   boost::asio::io_service& ioService = IoService();
+
+   m_spAuthModule->SetSessionHandler(
+      [&ioService](std::function<void()> fn) { ioService.post(fn); },
+      [wpSession]()
+      {
+         std::shared_ptr<AuthServerSession> spSession = wpSession.lock();
+         if (spSession == NULL)
+            return;
+
+         spSession->Logout(LogoutMessage::logoutUserPassUnknown);
+         spSession->Close();
+      });
 }
 
 void AuthServerSession::Start()
@@ -9,11 +9,13 @@
 #include "stdafx.h"
 #include "ClientModel.hpp"
 #include "RawMessage.hpp"
+#include "SpanStream.hpp"
 #include "ByteStream.hpp"
 #include "ActionMessage.hpp"
 #include "AddRemoveObjectMessage.hpp"
 #include "ActionMessage.hpp"
 #include "UpdateObjectMovementMessage.hpp"
+#include "UpdateObjectMovementDeltaMessage.hpp"
 #include "SessionInitMessage.hpp"
 
 void ClientModel::Tick(const TimeIndex&)
@@ -37,6 +39,10 @@ bool ClientModel::OnReceiveMessage(RawMessage& msg)
       OnMessageUpdateObjectMovement(msg);
       break;
 
+   case msgUpdateObjectMovementDelta:
+      OnMessageUpdateObjectMovementDelta(msg);
+      break;
+
    case msgSessionInit:
       OnMessageSessionInit(msg);
       break;
@@ -51,7 +57,7 @@ bool ClientModel::OnReceiveMessage(RawMessage& msg)
 void ClientModel::OnMessageAction(RawMessage& rawMsg)
 {
    ActionMessage msg;
-   ConstVectorRefStream stream(rawMsg.Data());
+   ConstMemoryRefStream stream(rawMsg.Data(), rawMsg.Size());
    msg.Deserialize(stream);
 
    // apply action using local model
@@ -61,9 +67,13 @@ void ClientModel::OnMessageAction(RawMessage& rawMsg)
 void ClientModel::OnMessageAddRemoveObject(RawMessage& rawMsg)
 {
    AddRemoveObjectMessage msg;
-   ConstVectorRefStream stream(rawMsg.Data());
+   ConstMemoryRefStream stream(rawMsg.Data(), rawMsg.Size());
    msg.Deserialize(stream);
 
+   // baselines of removed objects are also dropped by the server
+   std::for_each(msg.GetObjectsToRemove().begin(), msg.GetObjectsToRemove().end(),
+      [&](const ObjectId& objId) { m_movementBaselines.Remove(objId); });
+
    // apply changes using local model
    this->AddRemoveObject(msg.GetObjectsToAdd(), msg.GetObjectsToRemove());
 }
@@ -71,16 +81,28 @@ void ClientModel::OnMessageAddRemoveObject(RawMessage& rawMsg)
 void ClientModel::OnMessageUpdateObjectMovement(RawMessage& rawMsg)
 {
    UpdateObjectMovementMessage msg;
-   ConstVectorRefStream stream(rawMsg.Data());
+   ConstMemoryRefStream stream(rawMsg.Data(), rawMsg.Size());
    msg.Deserialize(stream);
 
    this->UpdateObjectMovement(msg.Id(), msg.Info());
 }
 
+void ClientModel::OnMessageUpdateObjectMovementDelta(RawMessage& rawMsg)
+{
+   UpdateObjectMovementDeltaMessage msg;
+   ConstMemoryRefStream stream(rawMsg.Data(), rawMsg.Size());
+   msg.Deserialize(stream);
+
+   MovementSnapshot snapshot = msg.Snapshot(m_movementBaselines.Baseline(msg.Id()));
+   m_movementBaselines.Update(msg.Id(), snapshot);
+
+   this->UpdateObjectMovement(msg.Id(), snapshot.ToMovementInfo(m_movementBaselines.ZoneOrigin()));
+}
+
 void ClientModel::OnMessageSessionInit(RawMessage& rawMsg)
 {
    SessionInitMessage msg;
-   ConstVectorRefStream stream(rawMsg.Data());
+   ConstMemoryRefStream stream(rawMsg.Data(), rawMsg.Size());
    msg.Deserialize(stream);
 
    // apply action using local model
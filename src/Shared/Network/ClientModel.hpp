@@ -10,6 +10,7 @@
 #include "Network.hpp"
 #include "LocalModel.hpp"
 #include "IMessageSink.hpp"
+#include "MovementBaselineMap.hpp"
 
 /// model for client of a client/server app
 class NETWORK_DECLSPEC ClientModel:
@@ -38,6 +39,13 @@ private:
    /// called when UpdateObjectMovementMessage has been received
    void OnMessageUpdateObjectMovement(RawMessage& rawMsg);
 
+   /// called when UpdateObjectMovementDeltaMessage has been received
+   void OnMessageUpdateObjectMovementDelta(RawMessage& rawMsg);
+
    /// called when SessionInitMessage has been received
    void OnMessageSessionInit(RawMessage& rawMsg);
+
+private:
+   /// movement baselines of all objects, for delta compressed updates
+   MovementBaselineMap m_movementBaselines;
 };
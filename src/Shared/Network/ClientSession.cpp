@@ -9,6 +9,7 @@
 #include "stdafx.h"
 #include "ClientSession.hpp"
 #include "RawMessage.hpp"
+#include "SpanStream.hpp"
 #include "LogoutMessage.hpp"
 #include "PingMessages.hpp"
 #include "AsioHelper.hpp"
@@ -172,7 +173,7 @@ bool ClientSession::OnReceiveMessage(RawMessage& rawMessage)
    if (rawMessage.MessageId() == msgLogoutRequest)
    {
       LogoutMessage msg;
-      ConstVectorRefStream stream(rawMessage.Data());
+      ConstMemoryRefStream stream(rawMessage.Data(), rawMessage.Size());
       msg.Deserialize(stream);
 
       UpdateConnectState(connectStateLoggedOut);
@@ -29,4 +29,7 @@ public:
 
    /// returns authentication module for authentication manager
    virtual std::shared_ptr<IServerAuthModule> GetAuthenticationModule() = 0;
+
+   /// returns number of logons waiting to be processed
+   virtual size_t LogonQueueSize() const = 0;
 };
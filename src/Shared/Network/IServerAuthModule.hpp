@@ -8,6 +8,7 @@
 
 // includes
 #include "ISession.hpp"
+#include <functional>
 
 // forward references
 class RawMessage;
@@ -32,6 +33,12 @@ public:
    /// returns encrypt module (if any) when authenticated
    virtual std::shared_ptr<IEncryptModule> GetEncryptModule() { return std::shared_ptr<IEncryptModule>(); }
 
+   /// function type to run a function on the session's thread
+   typedef std::function<void (std::function<void()>)> T_fnPostToSession;
+
+   /// function type to report failed authentication outside of OnReceiveMessage()
+   typedef std::function<void ()> T_fnAuthFailed;
+
 protected:
    friend class AuthServerSession;
    friend class TestServerSession;
@@ -39,10 +46,42 @@ protected:
    /// sets session to send out messages
    void SetSession(std::shared_ptr<ISession> spSession){ m_spSession = spSession; }
 
+   /// \brief sets handler functions for modules that authenticate asynchronously
+   /// \details Modules that do work outside of the session's thread must use
+   /// PostToSession() to continue on the session's thread.
+   void SetSessionHandler(T_fnPostToSession fnPostToSession, T_fnAuthFailed fnAuthFailed)
+   {
+      m_fnPostToSession = fnPostToSession;
+      m_fnAuthFailed = fnAuthFailed;
+   }
+
    /// sends out message
    void SendMessage(Message& msg){ m_spSession->SendMessage(msg); }
 
+   /// returns if functions can be posted to the session's thread
+   bool CanPostToSession() const { return m_fnPostToSession != nullptr; }
+
+   /// runs function on the session's thread
+   void PostToSession(std::function<void()> fn)
+   {
+      ATLASSERT(CanPostToSession());
+      m_fnPostToSession(fn);
+   }
+
+   /// reports failed authentication; the session is closed
+   void AuthFailed()
+   {
+      if (m_fnAuthFailed != nullptr)
+         m_fnAuthFailed();
+   }
+
 private:
    /// session
    std::shared_ptr<ISession> m_spSession;
+
+   /// function to run a function on the session's thread
+   T_fnPostToSession m_fnPostToSession;
+
+   /// function to report failed authentication
+   T_fnAuthFailed m_fnAuthFailed;
 };
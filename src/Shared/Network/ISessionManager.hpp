@@ -27,4 +27,9 @@ public:
 
    /// returns session by object id
    virtual std::weak_ptr<Session> FindSession(const ObjectId& objId) = 0;
+
+   /// \brief called when all FindSession() calls started before have returned
+   /// \details sessions are looked up while flushing updates; resources used
+   /// by lookups may only be freed after that
+   virtual void OnLookupsFinished() = 0;
 };
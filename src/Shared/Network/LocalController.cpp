@@ -60,9 +60,7 @@ bool LocalController::CheckCommand(const Command& c)
          return false;
 
       // check if object is in range
-      ObjectRef objRef = objMap.FindObject(id);
-
-      Vector3d vPos = objRef.m_sp->Pos();
+      Vector3d vPos = objMap.Get(id)->Pos();
       vPos -= m_localModel.Player()->Pos();
 
       if (vPos.Length() > c_dMaxSelectionDistance)
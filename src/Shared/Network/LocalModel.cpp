@@ -22,8 +22,6 @@ void LocalModel::StopMobile(ObjectPtr spObject)
    MobilePtr spMobile = std::dynamic_pointer_cast<Mobile>(spObject);
    ATLASSERT(spMobile != NULL);
 
-   spMobile->Move();
-
    MovementInfo info;
    info.Position(spMobile->Pos());
    UpdateObjectMovement(spMobile->Id(), info);
@@ -31,16 +29,38 @@ void LocalModel::StopMobile(ObjectPtr spObject)
 
 void LocalModel::Stop()
 {
+   // stop all mobiles at their current position
+   UpdatePositions();
+
    ObjectMap& objMap = GetObjectMap();
-   ObjectMap::T_mapObjects& mapObjects = objMap.GetMap();
 
-   std::for_each(mapObjects.begin(), mapObjects.end(),
-      [&](const ObjectMap::T_mapObjects::value_type& value){ StopMobile(value.second); });
+   std::for_each(objMap.begin(), objMap.end(),
+      [&](const ObjectPtr& spObj){ StopMobile(spObj); });
+}
+
+void LocalModel::UpdatePlayerMovement(const MovementInfo& info)
+{
+   ATLASSERT(m_spPlayer != NULL);
+
+   m_spPlayer->UpdateMovementInfo(info);
+
+   m_movementIntegrator.UpdateMovement(m_spPlayer->Id(), info, m_timeBase.Now());
+}
+
+void LocalModel::UpdatePositions()
+{
+   ProcessMobiles(m_timeBase.Now());
 }
 
 void LocalModel::InitialUpdate(MobilePtr spPlayer)
 {
+   // the player isn't in the object map, but is moved along with all mobiles
+   if (m_spPlayer != NULL)
+      m_movementIntegrator.Remove(m_spPlayer->Id());
+
    m_spPlayer = spPlayer;
+
+   m_movementIntegrator.Add(m_spPlayer, m_timeBase.Now());
 }
 
 void LocalModel::ReceiveAction(ActionPtr spAction)
@@ -54,35 +74,34 @@ void LocalModel::ReceiveCommand(Command& c)
    m_commandTranslator.ReceiveCommand(c);
 }
 
-void LocalModel::Tick(const TimeIndex& /*timeIndex*/)
+void LocalModel::Tick(const TimeIndex& timeIndex)
 {
-   // call all mobiles and let them "think"
-   ProcessMobiles();
+   // move all mobiles
+   ProcessMobiles(timeIndex);
 
    // check timer queue and execute all timed actions
-   //ProcessTimedActions();
+   ProcessTimedActions(timeIndex);
 }
 
-/// processes a mobile
-void ProcessMobile(std::pair<const ObjectId, ObjectPtr>& obj)
+void LocalModel::ProcessMobiles(const TimeIndex& timeIndex)
 {
-   MobilePtr spMobile = std::dynamic_pointer_cast<Mobile>(obj.second);
-   ATLASSERT(spMobile != NULL);
+   m_movementIntegrator.Advance(timeIndex);
+   m_movementIntegrator.WritePositions();
 
-   spMobile->Move();
-
-   // also an actor? then let it think
-   //MobileActorPtr spMobileActor = std::dynamic_pointer_cast<MobileActor>(obj.second);
+   // TODO let actors "think"
+   //MobileActorPtr spMobileActor = std::dynamic_pointer_cast<MobileActor>(spObj);
    //if (spMobileActor != NULL)
    //   spMobileActor->Think(*this, m_actionQueue);
 }
 
-void LocalModel::ProcessMobiles()
+void LocalModel::ProcessTimedActions(const TimeIndex& timeIndex)
 {
-   ObjectMap& objMap = GetObjectMap();
-   ObjectMap::T_mapObjects& mapObjects = objMap.GetMap();
+   m_timedActionScheduler.Advance(timeIndex, m_vecExpiredActions);
 
-   std::for_each(mapObjects.begin(), mapObjects.end(), &ProcessMobile);
+   for (size_t i=0,iMax=m_vecExpiredActions.size(); i<iMax; i++)
+      DoAction(m_vecExpiredActions[i]);
+
+   m_vecExpiredActions.clear();
 }
 
 void LocalModel::AddRemoveObject(const std::vector<ObjectPtr>& vecObjectsToAdd,
@@ -96,6 +115,8 @@ void LocalModel::AddRemoveObject(const std::vector<ObjectPtr>& vecObjectsToAdd,
    {
       const ObjectId& objId = vecObjectsToRemove[i];
       objMap.RemoveObject(objId);
+      m_movementIntegrator.Remove(objId);
+      m_timedActionScheduler.CancelAll(objId);
       SubjectOnRemoveObject().Call(objId);
    }
 
@@ -103,6 +124,11 @@ void LocalModel::AddRemoveObject(const std::vector<ObjectPtr>& vecObjectsToAdd,
    {
       const ObjectPtr& spObj = vecObjectsToAdd[i];
       objMap.AddObject(spObj);
+
+      MobilePtr spMobile = std::dynamic_pointer_cast<Mobile>(spObj);
+      if (spMobile != NULL)
+         m_movementIntegrator.Add(spMobile, m_timeBase.Now());
+
       SubjectOnAddObject().Call(spObj);
    }
 }
@@ -110,14 +136,16 @@ void LocalModel::AddRemoveObject(const std::vector<ObjectPtr>& vecObjectsToAdd,
 void LocalModel::UpdateObjectMovement(const ObjectId& id, const MovementInfo& info)
 {
    ObjectMap& objMap = GetObjectMap();
-   ObjectRef objRef = objMap.FindObject(id);
+   const ObjectPtr& spObj = objMap.Get(id);
 
-   if (objRef.m_sp != NULL)
+   if (spObj != NULL)
    {
-      MobilePtr spMobile = std::dynamic_pointer_cast<Mobile>(objRef.m_sp);
+      MobilePtr spMobile = std::dynamic_pointer_cast<Mobile>(spObj);
       ATLASSERT(spMobile != NULL);
 
       spMobile->UpdateMovementInfo(info);
+
+      m_movementIntegrator.UpdateMovement(id, info, m_timeBase.Now());
    }
 
    // notify all observer
@@ -133,7 +161,7 @@ void LocalModel::DoAction(ActionPtr spAction)
       if (ref.m_id == m_spPlayer->Id())
          ref.m_sp = m_spPlayer;
       else
-         ref.m_sp = GetObjectMap().FindObject(ref.m_id).m_sp;
+         ref.m_sp = GetObjectMap().Get(ref.m_id);
    }
 
    // carry out action immediately, without locking
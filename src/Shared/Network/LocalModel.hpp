@@ -10,6 +10,8 @@
 #include "Network.hpp"
 #include "IModel.hpp"
 #include "ObjectMap.hpp"
+#include "MovementIntegrator.hpp"
+#include "TimedActionScheduler.hpp"
 #include <ulib/Observer.hpp>
 #include "CommandTranslator.hpp"
 
@@ -26,6 +28,14 @@ public:
    /// stops mobile movement (in case of disconnect)
    void Stop();
 
+   /// updates movement of player
+   void UpdatePlayerMovement(const MovementInfo& info);
+
+   /// \brief moves all mobiles, including the player, to their current position
+   /// \details The model is ticked less often than the view is updated; the
+   /// view calls this for every frame, so that movement is smooth.
+   void UpdatePositions();
+
    // events used by view
 
    typedef Subject<void(ObjectPtr ptr)> T_SubjectOnAddObject;
@@ -48,6 +58,12 @@ public:
    /// returns object map; const version
    const ObjectMap& GetObjectMap() const { return m_objectMap; }
 
+   /// returns time base that the model is ticked with
+   const TimeBase& GetTimeBase() const { return m_timeBase; }
+
+   /// returns scheduler for timed actions; actions are carried out when the model is ticked
+   TimedActionScheduler& GetTimedActionScheduler() { return m_timedActionScheduler; }
+
    // virtual functions from IModel
 
    virtual void InitialUpdate(MobilePtr spPlayer) override;
@@ -67,8 +83,11 @@ private:
    /// stops mobile movement
    void StopMobile(ObjectPtr spObject);
 
-   /// lets mobiles "think"
-   void ProcessMobiles();
+   /// moves all mobiles to their position at given time index
+   void ProcessMobiles(const TimeIndex& timeIndex);
+
+   /// carries out all timed actions that are due at given time index
+   void ProcessTimedActions(const TimeIndex& timeIndex);
 
    /// executes action
    void DoAction(ActionPtr spAction);
@@ -80,6 +99,18 @@ private:
    /// object map
    ObjectMap m_objectMap;
 
+   /// time base; movement start times and tick time indices are taken from it
+   TimeBase m_timeBase;
+
+   /// moves all mobiles in the object map, and the player
+   MovementIntegrator m_movementIntegrator;
+
+   /// timed actions, e.g. spell effect ticks
+   TimedActionScheduler m_timedActionScheduler;
+
+   /// timed actions that expired in the current tick; only used in Tick()
+   std::vector<ActionPtr> m_vecExpiredActions;
+
    /// player mobile object
    MobilePtr m_spPlayer;
 
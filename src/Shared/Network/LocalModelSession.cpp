@@ -9,9 +9,11 @@
 #include "StdAfx.h"
 #include "LocalModelSession.hpp"
 #include "RawMessage.hpp"
+#include "SpanStream.hpp"
 #include "ActionMessage.hpp"
 #include "AddRemoveObjectMessage.hpp"
 #include "UpdateObjectMovementMessage.hpp"
+#include "UpdateObjectMovementDeltaMessage.hpp"
 #include "SessionInitMessage.hpp"
 #include "LocalModel.hpp"
 
@@ -41,6 +43,10 @@ bool LocalModelSession::OnReceiveMessage(RawMessage& msg)
       OnMessageUpdateObjectMovement(msg);
       break;
 
+   case msgUpdateObjectMovementDelta:
+      OnMessageUpdateObjectMovementDelta(msg);
+      break;
+
    case msgSessionInit:
       OnMessageSessionInit(msg);
       break;
@@ -60,7 +66,7 @@ void LocalModelSession::SetupSession()
 void LocalModelSession::OnMessageAction(RawMessage& rawMsg)
 {
    ActionMessage msg;
-   ConstVectorRefStream stream(rawMsg.Data());
+   ConstMemoryRefStream stream(rawMsg.Data(), rawMsg.Size());
    msg.Deserialize(stream);
 
    // apply action using local model
@@ -70,9 +76,13 @@ void LocalModelSession::OnMessageAction(RawMessage& rawMsg)
 void LocalModelSession::OnMessageAddRemoveObject(RawMessage& rawMsg)
 {
    AddRemoveObjectMessage msg;
-   ConstVectorRefStream stream(rawMsg.Data());
+   ConstMemoryRefStream stream(rawMsg.Data(), rawMsg.Size());
    msg.Deserialize(stream);
 
+   // baselines of removed objects are also dropped by the server
+   std::for_each(msg.GetObjectsToRemove().begin(), msg.GetObjectsToRemove().end(),
+      [&](const ObjectId& objId) { m_movementBaselines.Remove(objId); });
+
    // apply changes using local model
    m_model.AddRemoveObject(msg.GetObjectsToAdd(), msg.GetObjectsToRemove());
 }
@@ -80,16 +90,28 @@ void LocalModelSession::OnMessageAddRemoveObject(RawMessage& rawMsg)
 void LocalModelSession::OnMessageUpdateObjectMovement(RawMessage& rawMsg)
 {
    UpdateObjectMovementMessage msg;
-   ConstVectorRefStream stream(rawMsg.Data());
+   ConstMemoryRefStream stream(rawMsg.Data(), rawMsg.Size());
    msg.Deserialize(stream);
 
    m_model.UpdateObjectMovement(msg.Id(), msg.Info());
 }
 
+void LocalModelSession::OnMessageUpdateObjectMovementDelta(RawMessage& rawMsg)
+{
+   UpdateObjectMovementDeltaMessage msg;
+   ConstMemoryRefStream stream(rawMsg.Data(), rawMsg.Size());
+   msg.Deserialize(stream);
+
+   MovementSnapshot snapshot = msg.Snapshot(m_movementBaselines.Baseline(msg.Id()));
+   m_movementBaselines.Update(msg.Id(), snapshot);
+
+   m_model.UpdateObjectMovement(msg.Id(), snapshot.ToMovementInfo(m_movementBaselines.ZoneOrigin()));
+}
+
 void LocalModelSession::OnMessageSessionInit(RawMessage& rawMsg)
 {
    SessionInitMessage msg;
-   ConstVectorRefStream stream(rawMsg.Data());
+   ConstMemoryRefStream stream(rawMsg.Data(), rawMsg.Size());
    msg.Deserialize(stream);
 
    // apply action using local model
@@ -9,6 +9,7 @@
 // includes
 #include "Network.hpp"
 #include "AuthClientSession.hpp"
+#include "MovementBaselineMap.hpp"
 
 // forward references
 class LocalModel;
@@ -43,10 +44,16 @@ private:
    /// called for update object movement message
    void OnMessageUpdateObjectMovement(RawMessage& rawMsg);
 
+   /// called for delta compressed update object movement message
+   void OnMessageUpdateObjectMovementDelta(RawMessage& rawMsg);
+
    /// called for session init message
    void OnMessageSessionInit(RawMessage& rawMsg);
 
 private:
    /// local model
    LocalModel& m_model;
+
+   /// movement baselines of all objects, for delta compressed updates
+   MovementBaselineMap m_movementBaselines;
 };
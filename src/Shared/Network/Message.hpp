@@ -35,6 +35,9 @@ enum T_enMessageId
 
    msgText,          ///< text message
 
+   // messages added later; new ids are appended, so that existing ids don't change
+   msgUpdateObjectMovementDelta, ///< message contains a delta compressed update for object movement
+
    // simple auth, challenge handshake
    msgAuthBase = 0x0100,
    msgAuthRequest       = msgAuthBase + 0, ///< authenticate request
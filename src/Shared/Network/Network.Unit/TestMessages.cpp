@@ -9,6 +9,11 @@
 #include "stdafx.h"
 #include "LogoutMessage.hpp"
 #include "ByteStream.hpp"
+#include "Session.hpp"
+#include "RawMessage.hpp"
+#include "UpdateObjectMovementMessage.hpp"
+#include "SpanStream.hpp"
+#include <ulib/HighResolutionTimer.hpp>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
@@ -25,6 +30,154 @@ namespace UnitTest
          TestMessage<LogoutMessage>();
       }
 
+      /// tests Session::SerializeMessage()
+      TEST_METHOD(TestSerializeMessage)
+      {
+         LogoutMessage msg(LogoutMessage::logoutServerShutdown);
+         SharedConstBuffer buffer = Session::SerializeMessage(msg);
+
+         const std::vector<unsigned char>& vecData = buffer.Data();
+         Assert::AreEqual<size_t>(5, vecData.size(), _T("message must contain header and one byte"));
+
+         ConstVectorRefStream stream(vecData);
+         Assert::AreEqual<unsigned short>(msgLogoutRequest, stream.Read16(), _T("message id must be stored"));
+         Assert::AreEqual<unsigned short>(1, stream.Read16(), _T("message length must be stored"));
+         Assert::AreEqual<unsigned char>(LogoutMessage::logoutServerShutdown, stream.Read8());
+      }
+
+      /// tests RawMessage referencing data, and copying it
+      TEST_METHOD(TestRawMessageReference)
+      {
+         std::vector<unsigned char> vecData(3, 42);
+
+         RawMessage msg(msgText, vecData.data(), vecData.size(), RawMessage::dataReference);
+         Assert::IsTrue(vecData.data() == msg.Data(), _T("message must reference data"));
+         Assert::AreEqual<size_t>(3, msg.Size());
+
+         RawMessage copy(msg);
+         Assert::IsTrue(vecData.data() != copy.Data(), _T("copied message must own its data"));
+
+         vecData[0] = 0;
+         Assert::AreEqual<unsigned char>(42, copy.Data()[0], _T("copied message must not change"));
+
+         ConstMemoryRefStream stream(copy.Data(), copy.Size());
+         Assert::AreEqual<unsigned short>(0x2a2a, stream.Read16());
+      }
+
+      /// tests serializing UpdateObjectMovementMessage to SpanStream
+      TEST_METHOD(TestSpanStreamMovementMessage)
+      {
+         UpdateObjectMovementMessage msg(ObjectId::New(), MovementInfoForTest());
+
+         VectorStream vectorStream;
+         msg.Serialize(vectorStream);
+
+         std::array<unsigned char, 128> aData;
+         SpanStream spanStream(aData.data(), aData.size());
+         msg.Serialize(spanStream);
+
+         Assert::AreEqual<size_t>(vectorStream.Size(), spanStream.Pos(), _T("both streams must contain same number of bytes"));
+         Assert::IsTrue(0 == memcmp(vectorStream.Data().data(), aData.data(), spanStream.Pos()), _T("both streams must contain same bytes"));
+
+         ConstMemoryRefStream readStream(aData.data(), spanStream.Pos());
+         UpdateObjectMovementMessage msg2;
+         msg2.Deserialize(readStream);
+
+         Assert::IsTrue(msg.Id() == msg2.Id(), _T("object id must be equal"));
+         Assert::AreEqual<size_t>(0, readStream.Remaining(), _T("all bytes must have been read"));
+      }
+
+      /// compares serializing UpdateObjectMovementMessage with VectorStream and SpanStream
+      TEST_METHOD(TestMovementMessagePerformance)
+      {
+         UpdateObjectMovementMessage msg(ObjectId::New(), MovementInfoForTest());
+
+         // virtual Serialize() and Deserialize(), as called by Session
+         const Message& baseMsg = msg;
+
+         const unsigned int c_uiNumMessages = 100000;
+
+         // VectorStream, through Message and ByteStream, as used when sending a message
+         HighResolutionTimer timerVectorStream;
+         timerVectorStream.Start();
+
+         for (unsigned int ui = 0; ui < c_uiNumMessages; ui++)
+         {
+            VectorStream stream;
+            baseMsg.Serialize(stream);
+
+            ConstVectorRefStream readStream(stream.Data());
+            UpdateObjectMovementMessage msg2;
+            static_cast<Message&>(msg2).Deserialize(readStream);
+         }
+
+         timerVectorStream.Stop();
+
+         // SpanStream on a buffer that is reused, still through Message and ByteStream
+         std::array<unsigned char, 128> aData;
+
+         HighResolutionTimer timerSpanStreamVirtual;
+         timerSpanStreamVirtual.Start();
+
+         for (unsigned int ui = 0; ui < c_uiNumMessages; ui++)
+         {
+            SpanStream stream(aData.data(), aData.size());
+            baseMsg.Serialize(stream);
+
+            ConstMemoryRefStream readStream(aData.data(), stream.Pos());
+            UpdateObjectMovementMessage msg2;
+            static_cast<Message&>(msg2).Deserialize(readStream);
+         }
+
+         timerSpanStreamVirtual.Stop();
+
+         // SpanStream with the serializers templated on the stream type; no virtual calls
+         HighResolutionTimer timerSpanStream;
+         timerSpanStream.Start();
+
+         for (unsigned int ui = 0; ui < c_uiNumMessages; ui++)
+         {
+            SpanStream stream(aData.data(), aData.size());
+            msg.Serialize(stream);
+
+            ConstMemoryRefStream readStream(aData.data(), stream.Pos());
+            UpdateObjectMovementMessage msg2;
+            msg2.Deserialize(readStream);
+         }
+
+         timerSpanStream.Stop();
+
+         // check that the fast path produces the same bytes as the virtual one
+         VectorStream checkStream;
+         baseMsg.Serialize(checkStream);
+
+         SpanStream spanStream(aData.data(), aData.size());
+         msg.Serialize(spanStream);
+
+         Assert::AreEqual(checkStream.Data().size(), spanStream.Pos(), _T("serialized sizes must match"));
+         Assert::IsTrue(memcmp(checkStream.Data().data(), aData.data(), spanStream.Pos()) == 0,
+            _T("serialized bytes must match"));
+
+         CString cszText;
+         cszText.Format(_T("UpdateObjectMovementMessage serialize/deserialize: VectorStream %.3f us, ")
+            _T("SpanStream via ByteStream %.3f us, SpanStream direct %.3f us per message\n"),
+            timerVectorStream.Elapsed() * 1e6 / c_uiNumMessages,
+            timerSpanStreamVirtual.Elapsed() * 1e6 / c_uiNumMessages,
+            timerSpanStream.Elapsed() * 1e6 / c_uiNumMessages);
+         Logger::WriteMessage(cszText);
+      }
+
+      /// returns typical movement info of a moving player
+      static MovementInfo MovementInfoForTest()
+      {
+         MovementInfo info(MovementInfo::movementPlayer);
+         info.Position(Vector3d(1234.5, 12.25, -987.75));
+         info.Direction(135.0);
+         info.Speed(4.5);
+         info.SetForwardMovement(true, true);
+         return info;
+      }
+
       /// tests a message type
       template<typename TMessage>
       void TestMessage()
@@ -0,0 +1,138 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file TestReceiveBuffer.cpp Unit tests for class ReceiveBuffer
+//
+
+// includes
+#include "stdafx.h"
+#include "ReceiveBuffer.hpp"
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+
+/// creates message bytes with given id and payload length
+std::vector<unsigned char> CreateMessageBytes(unsigned short usMessageId, unsigned short usLength)
+{
+   std::vector<unsigned char> vecData;
+   vecData.push_back(static_cast<unsigned char>(usMessageId & 0xff));
+   vecData.push_back(static_cast<unsigned char>(usMessageId >> 8));
+   vecData.push_back(static_cast<unsigned char>(usLength & 0xff));
+   vecData.push_back(static_cast<unsigned char>(usLength >> 8));
+
+   for (unsigned short us = 0; us < usLength; us++)
+      vecData.push_back(static_cast<unsigned char>(us & 0xff));
+
+   return vecData;
+}
+
+/// simulates receiving bytes from socket
+void Receive(ReceiveBuffer& buffer, const unsigned char* pData, size_t uiSize)
+{
+   boost::asio::mutable_buffers_1 readBuffer = buffer.PrepareRead();
+
+   size_t uiBufferSize = boost::asio::buffer_size(readBuffer);
+   Assert::IsTrue(uiBufferSize >= uiSize, _T("buffer must have enough room"));
+
+   memcpy(boost::asio::buffer_cast<unsigned char*>(readBuffer), pData, uiSize);
+   buffer.Commit(uiSize);
+}
+
+} // unnamed namespace
+
+namespace UnitTest
+{
+   /// tests class ReceiveBuffer
+   TEST_CLASS(TestReceiveBuffer)
+   {
+      /// tests receiving two messages in one read
+      TEST_METHOD(TestTwoMessagesInOneRead)
+      {
+         std::vector<unsigned char> vecData = CreateMessageBytes(0x0010, 3);
+         std::vector<unsigned char> vecData2 = CreateMessageBytes(0x0011, 0);
+         vecData.insert(vecData.end(), vecData2.begin(), vecData2.end());
+
+         ReceiveBuffer buffer;
+         Receive(buffer, vecData.data(), vecData.size());
+
+         unsigned short usMessageId = 0, usLength = 0;
+         const unsigned char* pData = NULL;
+
+         Assert::IsTrue(buffer.NextMessage(usMessageId, pData, usLength));
+         Assert::AreEqual<unsigned short>(0x0010, usMessageId);
+         Assert::AreEqual<unsigned short>(3, usLength);
+         Assert::AreEqual<unsigned char>(2, pData[2]);
+
+         Assert::IsTrue(buffer.NextMessage(usMessageId, pData, usLength));
+         Assert::AreEqual<unsigned short>(0x0011, usMessageId);
+         Assert::AreEqual<unsigned short>(0, usLength);
+
+         Assert::IsFalse(buffer.NextMessage(usMessageId, pData, usLength));
+         Assert::AreEqual<size_t>(0, buffer.PendingSize());
+      }
+
+      /// tests receiving a message split across several reads
+      TEST_METHOD(TestSplitMessage)
+      {
+         std::vector<unsigned char> vecData = CreateMessageBytes(0x0012, 100);
+
+         ReceiveBuffer buffer;
+
+         unsigned short usMessageId = 0, usLength = 0;
+         const unsigned char* pData = NULL;
+
+         // header only partially received
+         Receive(buffer, vecData.data(), 3);
+         Assert::IsFalse(buffer.NextMessage(usMessageId, pData, usLength));
+
+         // payload partially received
+         Receive(buffer, vecData.data() + 3, 50);
+         Assert::IsFalse(buffer.NextMessage(usMessageId, pData, usLength));
+
+         Receive(buffer, vecData.data() + 53, vecData.size() - 53);
+         Assert::IsTrue(buffer.NextMessage(usMessageId, pData, usLength));
+         Assert::AreEqual<unsigned short>(0x0012, usMessageId);
+         Assert::AreEqual<unsigned short>(100, usLength);
+         Assert::AreEqual<unsigned char>(99, pData[99]);
+      }
+
+      /// tests receiving a message with max. size, which needs growing the buffer
+      TEST_METHOD(TestMaxSizeMessage)
+      {
+         std::vector<unsigned char> vecData = CreateMessageBytes(0x0013, std::numeric_limits<unsigned short>::max());
+
+         ReceiveBuffer buffer;
+
+         unsigned short usMessageId = 0, usLength = 0;
+         const unsigned char* pData = NULL;
+
+         size_t uiPos = 0;
+         while (uiPos < vecData.size())
+         {
+            Assert::IsFalse(buffer.NextMessage(usMessageId, pData, usLength));
+
+            size_t uiChunkSize = std::min<size_t>(1000, vecData.size() - uiPos);
+            Receive(buffer, vecData.data() + uiPos, uiChunkSize);
+            uiPos += uiChunkSize;
+         }
+
+         Assert::IsTrue(buffer.NextMessage(usMessageId, pData, usLength));
+         Assert::AreEqual<unsigned short>(std::numeric_limits<unsigned short>::max(), usLength);
+         Assert::IsTrue(buffer.Capacity() >= ReceiveBuffer::c_uiMaxMessageSize);
+
+         // storage is reused for the next message
+         size_t uiCapacity = buffer.Capacity();
+
+         std::vector<unsigned char> vecData2 = CreateMessageBytes(0x0014, 10);
+         Receive(buffer, vecData2.data(), vecData2.size());
+
+         Assert::IsTrue(buffer.NextMessage(usMessageId, pData, usLength));
+         Assert::AreEqual<size_t>(uiCapacity, buffer.Capacity());
+      }
+   };
+
+} // namespace UnitTest
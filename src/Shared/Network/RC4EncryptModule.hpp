@@ -31,13 +31,15 @@ public:
    /// decrypts received data
    virtual void DecryptRead(TIterator itFirst, TIterator itLast) override
    {
-      m_rc4Read.Encrypt<TIterator>(itFirst, itLast);
+      if (itFirst != itLast)
+         m_rc4Read.Encrypt(&*itFirst, static_cast<size_t>(itLast - itFirst));
    }
 
    /// encrypts data to send
    virtual void EncryptWrite(TIterator itFirst, TIterator itLast) override
    {
-      m_rc4Write.Encrypt<TIterator>(itFirst, itLast);
+      if (itFirst != itLast)
+         m_rc4Write.Encrypt(&*itFirst, static_cast<size_t>(itLast - itFirst));
    }
 
 private:
@@ -11,43 +11,103 @@
 #include "Message.hpp"
 #include "ByteStream.hpp"
 
-/// raw message; used for deserializing
+/// \brief raw message; used for deserializing
+/// \details A raw message either owns a copy of its data, or only references
+/// data owned by someone else, e.g. the receive buffer of a session. A
+/// referencing message is only valid as long as the referenced data is; copying
+/// a raw message always creates a message that owns its data.
 class RawMessage: public Message
 {
 public:
+   /// data mode of message
+   enum T_enDataMode
+   {
+      dataCopy,      ///< message copies data and owns it
+      dataReference, ///< message only references data, without copying
+   };
+
    /// ctor
-   RawMessage(unsigned short usMessageId, const unsigned char* pData, size_t uiLength)
+   RawMessage(unsigned short usMessageId, const unsigned char* pData, size_t uiLength,
+      T_enDataMode enDataMode = dataCopy)
       :Message(usMessageId),
-       m_vecData(pData, pData + uiLength)
+       m_pData(pData),
+       m_uiLength(uiLength)
    {
+      if (enDataMode == dataCopy)
+         CopyData(pData, uiLength);
    }
 
    /// ctor
    RawMessage(unsigned short usMessageId, const std::vector<unsigned char>& vecData)
       :Message(usMessageId),
-       m_vecData(vecData)
+       m_pData(NULL),
+       m_uiLength(0)
+   {
+      CopyData(vecData.data(), vecData.size());
+   }
+
+   /// copy ctor; always copies data
+   RawMessage(const RawMessage& msg)
+      :Message(msg),
+       m_pData(NULL),
+       m_uiLength(0)
    {
+      CopyData(msg.m_pData, msg.m_uiLength);
    }
 
    /// dtor
    virtual ~RawMessage() {}
 
+   /// assignment operator; always copies data
+   RawMessage& operator=(const RawMessage& msg)
+   {
+      if (this != &msg)
+      {
+         Message::operator=(msg);
+         CopyData(msg.m_pData, msg.m_uiLength);
+      }
+
+      return *this;
+   }
+
    /// serialize message by putting bytes to stream
    virtual void Serialize(ByteStream& stream) const override
    {
-      stream.WriteBlock(m_vecData);
+      stream.WriteBlock(m_pData, m_uiLength);
    }
 
    /// deserialize message by reading bytes from stream
    virtual void Deserialize(ByteStream& stream) override
    {
-      stream.ReadBlock(&m_vecData[0], m_vecData.size());
+      m_vecData.resize(m_uiLength);
+      if (m_uiLength > 0)
+         stream.ReadBlock(&m_vecData[0], m_uiLength);
+
+      m_pData = m_vecData.data();
    }
 
    /// returns raw data
-   const std::vector<unsigned char>& Data() const { return m_vecData; }
+   const unsigned char* Data() const { return m_pData; }
+
+   /// returns length of raw data
+   size_t Size() const { return m_uiLength; }
+
+private:
+   /// copies data to own storage
+   void CopyData(const unsigned char* pData, size_t uiLength)
+   {
+      m_vecData.assign(pData, pData + uiLength);
+      m_pData = m_vecData.data();
+      m_uiLength = uiLength;
+   }
 
 private:
-   /// raw data
+   /// raw data; only used when message owns its data
    std::vector<unsigned char> m_vecData;
+
+   /// pointer to raw data; either points to m_vecData or to referenced data
+   const unsigned char* m_pData;
+
+   /// length of raw data
+   size_t m_uiLength;
 };
@@ -0,0 +1,147 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file ReceiveBuffer.hpp Receive buffer that reassembles messages
+//
+#pragma once
+
+// includes
+#include <ulib/config/BoostAsio.hpp>
+#include <vector>
+#include <limits>
+#include <cstring>
+
+/// \brief receive buffer that reassembles messages
+/// \details Stores bytes received from a socket and hands out complete
+/// messages, even when a message was split across several reads. The storage
+/// is reused for all reads; it only grows when a large message is received,
+/// up to the maximum message size. A message consists of a 16-bit message id,
+/// a 16-bit payload length and the payload bytes.
+class ReceiveBuffer
+{
+public:
+   /// size of message header; message id and length
+   static const size_t c_uiHeaderSize = 4;
+
+   /// max. size of a message, including header
+   static const size_t c_uiMaxMessageSize = c_uiHeaderSize + std::numeric_limits<unsigned short>::max();
+
+   /// ctor
+   ReceiveBuffer(size_t uiInitialSize = 1024)
+      :m_vecBuffer(uiInitialSize),
+       m_uiStart(0),
+       m_uiEnd(0)
+   {
+   }
+
+   /// \brief returns buffer to read the next bytes into
+   /// \details moves unprocessed bytes to the front of the buffer and grows
+   /// the buffer when there's not enough room to read into.
+   boost::asio::mutable_buffers_1 PrepareRead()
+   {
+      if (FreeSize() < c_uiMinReadSize)
+      {
+         Compact();
+
+         if (FreeSize() < c_uiMinReadSize)
+            Grow();
+      }
+
+      return boost::asio::buffer(&m_vecBuffer[m_uiEnd], FreeSize());
+   }
+
+   /// returns iterator to the start of the bytes that were just read
+   std::vector<unsigned char>::iterator ReadBegin() { return m_vecBuffer.begin() + m_uiEnd; }
+
+   /// marks bytes as received, after reading into buffer returned by PrepareRead()
+   void Commit(size_t uiBytesTransferred)
+   {
+      ATLASSERT(uiBytesTransferred <= FreeSize());
+      m_uiEnd += uiBytesTransferred;
+   }
+
+   /// \brief returns next complete message, if any
+   /// \param[out] usMessageId message id of message
+   /// \param[out] pData pointer to payload; only valid until next call to PrepareRead()
+   /// \param[out] usLength length of payload
+   /// \return true when a complete message was returned, false when more bytes are needed
+   bool NextMessage(unsigned short& usMessageId, const unsigned char*& pData, unsigned short& usLength)
+   {
+      size_t uiAvailable = m_uiEnd - m_uiStart;
+      if (uiAvailable < c_uiHeaderSize)
+         return false;
+
+      const unsigned char* pHeader = &m_vecBuffer[m_uiStart];
+
+      unsigned short usLengthInHeader =
+         static_cast<unsigned short>(pHeader[2] | (static_cast<unsigned short>(pHeader[3]) << 8));
+
+      if (uiAvailable < c_uiHeaderSize + usLengthInHeader)
+         return false;
+
+      usMessageId = static_cast<unsigned short>(pHeader[0] | (static_cast<unsigned short>(pHeader[1]) << 8));
+      usLength = usLengthInHeader;
+      pData = pHeader + c_uiHeaderSize;
+
+      m_uiStart += c_uiHeaderSize + usLengthInHeader;
+
+      // when all bytes are processed, start at the front again
+      if (m_uiStart == m_uiEnd)
+         m_uiStart = m_uiEnd = 0;
+
+      return true;
+   }
+
+   /// returns number of bytes received, but not processed yet
+   size_t PendingSize() const { return m_uiEnd - m_uiStart; }
+
+   /// returns current capacity of buffer
+   size_t Capacity() const { return m_vecBuffer.size(); }
+
+private:
+   /// min. number of bytes that should be read at once
+   static const size_t c_uiMinReadSize = 512;
+
+   /// max. capacity; fits a message of max. size, plus room for reading
+   static const size_t c_uiMaxCapacity = c_uiMaxMessageSize + 4 * c_uiMinReadSize;
+
+   /// returns number of bytes that can be read into buffer
+   size_t FreeSize() const { return m_vecBuffer.size() - m_uiEnd; }
+
+   /// moves unprocessed bytes to the front of the buffer
+   void Compact()
+   {
+      if (m_uiStart == 0)
+         return;
+
+      size_t uiPending = m_uiEnd - m_uiStart;
+      if (uiPending > 0)
+         memmove(&m_vecBuffer[0], &m_vecBuffer[m_uiStart], uiPending);
+
+      m_uiStart = 0;
+      m_uiEnd = uiPending;
+   }
+
+   /// grows buffer by doubling its size, up to max. capacity
+   void Grow()
+   {
+      size_t uiNewSize = m_vecBuffer.size() * 2;
+      if (uiNewSize > c_uiMaxCapacity)
+         uiNewSize = c_uiMaxCapacity;
+
+      ATLASSERT(uiNewSize > m_vecBuffer.size()); // pending bytes must never exceed a message
+
+      m_vecBuffer.resize(uiNewSize);
+   }
+
+private:
+   /// buffer storage
+   std::vector<unsigned char> m_vecBuffer;
+
+   /// start of unprocessed bytes
+   size_t m_uiStart;
+
+   /// end of received bytes
+   size_t m_uiEnd;
+};
@@ -10,6 +10,7 @@
 #include "SRPClientAuthModule.hpp"
 #include "AuthException.hpp"
 #include "RawMessage.hpp"
+#include "SpanStream.hpp"
 #include "SRPAuthMessages.hpp"
 #include "RC4EncryptModule.hpp"
 #include "SRPClient.hpp"
@@ -94,7 +95,7 @@ void ClientAuthModule::OnMessageAuthResponse(RawMessage& rawMessage)
       throw AuthException(AuthException::authInternalError, _T("client == NULL"), __FILE__, __LINE__);
 
    SRPAuthResponseMessage authResponseMessage;
-   ConstVectorRefStream stream(rawMessage.Data());
+   ConstMemoryRefStream stream(rawMessage.Data(), rawMessage.Size());
    authResponseMessage.Deserialize(stream);
 
    // now enter verify stage of login...
@@ -129,7 +130,7 @@ void ClientAuthModule::OnMessageVerifyServer(RawMessage& rawMessage)
       throw AuthException(AuthException::authInternalError, _T("client == NULL"), __FILE__, __LINE__);
 
    SRPAuthVerifyServerMessage verifyMessage;
-   ConstVectorRefStream stream(rawMessage.Data());
+   ConstMemoryRefStream stream(rawMessage.Data(), rawMessage.Size());
    verifyMessage.Deserialize(stream);
 
    HighResolutionTimer timer;
@@ -10,17 +10,43 @@
 #include "SRPServerAuthModule.hpp"
 #include "AuthException.hpp"
 #include "RawMessage.hpp"
+#include "SpanStream.hpp"
 #include "SRPAuthMessages.hpp"
 #include "RC4EncryptModule.hpp"
 #include "SRPServer.hpp"
 #include "SRPHelper.hpp"
 #include "LogCategories.hpp"
+#include "ThreadPool.hpp"
 #include <ulib/HighResolutionTimer.hpp>
 
 using SRP::ServerAuthModule;
 
-ServerAuthModule::ServerAuthModule(T_fnGetServerAuthInfo fnGetServerAuthInfo)
+/// result of processing an auth request
+struct ServerAuthModule::AuthResponse
+{
+   /// ctor
+   AuthResponse()
+      :m_iAccountId(0)
+   {
+   }
+
+   /// SRP server object, with calculated session key
+   std::shared_ptr<SRP::Server> m_spServer;
+
+   /// account id from database
+   int m_iAccountId;
+
+   /// salt of account
+   TByteArray m_vecSalt;
+
+   /// server public value B
+   TByteArray m_vecB;
+};
+
+ServerAuthModule::ServerAuthModule(T_fnGetServerAuthInfo fnGetServerAuthInfo, ThreadPool* pWorkerPool)
 :m_fnGetServerAuthInfo(fnGetServerAuthInfo),
+ m_pWorkerPool(pWorkerPool),
+ m_bAuthRequestPending(false),
  m_bIsVerifiedClient(false),
  m_iAccountId(0)
 {
@@ -71,18 +97,80 @@ void ServerAuthModule::OnMessageAuthRequest(RawMessage& rawMessage)
       throw AuthException(AuthException::authInternalError, _T("client already verified"), __FILE__, __LINE__);
    if (m_spServer != NULL)
       throw AuthException(AuthException::authInternalError, _T("server == NULL"), __FILE__, __LINE__);
+   if (m_bAuthRequestPending)
+      throw AuthException(AuthException::authInternalError, _T("auth request already pending"), __FILE__, __LINE__);
 
    AuthRequestMessage authMessage;
-   ConstVectorRefStream stream(rawMessage.Data());
+   ConstMemoryRefStream stream(rawMessage.Data(), rawMessage.Size());
    authMessage.Deserialize(stream);
 
+   if (m_pWorkerPool != NULL && CanPostToSession())
+   {
+      m_bAuthRequestPending = true;
+
+      std::shared_ptr<ServerAuthModule> spThis = shared_from_this();
+      CString cszUsername = authMessage.GetUsername();
+      TByteArray vecA = authMessage.GetA();
+
+      m_pWorkerPool->QueueWork([spThis, cszUsername, vecA]()
+      {
+         spThis->AsyncCalcAuthResponse(cszUsername, vecA);
+      });
+   }
+   else
+      SendAuthResponse(*CalcAuthResponse(authMessage.GetUsername(), authMessage.GetA()));
+}
+
+/// \details Runs on a worker thread; exceptions are reported to the session
+/// on the session's thread, since they can't be thrown to the message handler.
+void ServerAuthModule::AsyncCalcAuthResponse(const CString& cszUsername, const TByteArray& vecA)
+{
+   std::shared_ptr<ServerAuthModule> spThis = shared_from_this();
+
+   try
+   {
+      std::shared_ptr<AuthResponse> spResponse = CalcAuthResponse(cszUsername, vecA);
+
+      PostToSession([spThis, spResponse]()
+      {
+         spThis->m_bAuthRequestPending = false;
+         spThis->SendAuthResponse(*spResponse);
+      });
+   }
+   catch(const Exception& ex)
+   {
+      LOG_WARN(_T("authentication failed: ") + ex.Message(), Log::Server::AuthSRP);
+
+      PostToSession([spThis]()
+      {
+         spThis->m_bAuthRequestPending = false;
+         spThis->AuthFailed();
+      });
+   }
+   catch(...)
+   {
+      LOG_WARN(_T("authentication failed; caught unknown exception"), Log::Server::AuthSRP);
+
+      PostToSession([spThis]()
+      {
+         spThis->m_bAuthRequestPending = false;
+         spThis->AuthFailed();
+      });
+   }
+}
+
+std::shared_ptr<ServerAuthModule::AuthResponse> ServerAuthModule::CalcAuthResponse(
+   const CString& cszUsername, const TByteArray& vecA) const
+{
    // get server infos
    ATLASSERT(m_fnGetServerAuthInfo != NULL);
 
-   TByteArray vecPasswordKey, vecSalt;
+   std::shared_ptr<AuthResponse> spResponse = std::make_shared<AuthResponse>();
+
+   TByteArray vecPasswordKey;
    try
    {
-      m_fnGetServerAuthInfo(authMessage.GetUsername(), vecPasswordKey, vecSalt, m_iAccountId);
+      m_fnGetServerAuthInfo(cszUsername, vecPasswordKey, spResponse->m_vecSalt, spResponse->m_iAccountId);
    }
    catch(const Exception& ex)
    {
@@ -102,7 +190,7 @@ void ServerAuthModule::OnMessageAuthRequest(RawMessage& rawMessage)
    timer.Start();
 
    SRP::GroupParameter gp = SRP::Helper::GetPresetGroupParameter(c_uiDefaultPresetGroupParameter);
-   m_spServer.reset(new SRP::Server(gp));
+   spResponse->m_spServer.reset(new SRP::Server(gp));
 
    // generate b
    BigInteger b = SRP::Helper::GenerateRandomBits(1024);
@@ -110,28 +198,34 @@ void ServerAuthModule::OnMessageAuthRequest(RawMessage& rawMessage)
    BigInteger PassVerifier = SRP::Helper::ToInteger<BigInteger>(vecPasswordKey);
 
    // calculate B
-   BigInteger B = m_spServer->GetB(PassVerifier, b);
-   TByteArray Bbin;
-   SRP::Helper::ToBinaryData(B, Bbin);
+   BigInteger B = spResponse->m_spServer->GetB(PassVerifier, b);
+   SRP::Helper::ToBinaryData(B, spResponse->m_vecB);
 
    // calculate session key
-   TByteArray Abin = authMessage.GetA();
-   BigInteger A = SRP::Helper::ToInteger<BigInteger>(Abin);
+   BigInteger A = SRP::Helper::ToInteger<BigInteger>(vecA);
 
-   BigInteger s = SRP::Helper::ToInteger<BigInteger>(vecSalt);
+   BigInteger s = SRP::Helper::ToInteger<BigInteger>(spResponse->m_vecSalt);
 
    USES_CONVERSION;
-   std::string strUsername(T2CA(authMessage.GetUsername()));
+   std::string strUsername(T2CA(cszUsername));
 
-   m_spServer->CalcSessionKey(A, s, strUsername, PassVerifier);
+   spResponse->m_spServer->CalcSessionKey(A, s, strUsername, PassVerifier);
 
    // log
    CString cszText;
    cszText.Format(_T("calculating session key took %u ms"), unsigned(timer.Elapsed()*1000.0));
    LOG_INFO(cszText, Log::Server::AuthSRP);
 
+   return spResponse;
+}
+
+void ServerAuthModule::SendAuthResponse(const AuthResponse& response)
+{
+   m_spServer = response.m_spServer;
+   m_iAccountId = response.m_iAccountId;
+
    // send response
-   SRPAuthResponseMessage authResponseMessage(vecSalt, Bbin);
+   SRPAuthResponseMessage authResponseMessage(response.m_vecSalt, response.m_vecB);
    SendMessage(authResponseMessage);
 }
 
@@ -143,7 +237,7 @@ void ServerAuthModule::OnMessageVerifyClient(RawMessage& rawMessage)
       throw AuthException(AuthException::authInternalError, _T("server == NULL"), __FILE__, __LINE__);
 
    SRPAuthVerifyClientMessage verifyClientMessage;
-   ConstVectorRefStream stream(rawMessage.Data());
+   ConstMemoryRefStream stream(rawMessage.Data(), rawMessage.Size());
    verifyClientMessage.Deserialize(stream);
 
    HighResolutionTimer timer;
@@ -12,6 +12,8 @@
 #include <functional>
 
 // forward references
+class ThreadPool;
+
 namespace RC4
 {
    class EncryptModule;
@@ -21,16 +23,22 @@ namespace SRP
 {
 class Server;
 
-/// server authentication module for SRP auth
-class NETWORK_DECLSPEC ServerAuthModule: public IServerAuthModule
+/// \brief server authentication module for SRP auth
+/// \details When a worker pool is passed, the account lookup and the
+/// calculation of the server values are done on the worker pool, and the
+/// response is sent from the session's thread. This way, logins don't block
+/// other sessions running on the same thread.
+class NETWORK_DECLSPEC ServerAuthModule:
+   public IServerAuthModule,
+   public std::enable_shared_from_this<ServerAuthModule>
 {
 public:
    /// callback function to get auth info from server
    typedef std::function<void (const CString& cszUsername, std::vector<unsigned char>& vecPasswordKey,
       std::vector<unsigned char>& vecSalt, int& iAccountId)> T_fnGetServerAuthInfo;
 
-   /// ctor
-   ServerAuthModule(T_fnGetServerAuthInfo fnGetServerAuthInfo);
+   /// ctor; when no worker pool is passed, authentication is done synchronously
+   ServerAuthModule(T_fnGetServerAuthInfo fnGetServerAuthInfo, ThreadPool* pWorkerPool = nullptr);
    /// dtor
    virtual ~ServerAuthModule() {}
 
@@ -45,15 +53,35 @@ public:
    virtual std::shared_ptr<IEncryptModule> GetEncryptModule() override;
 
 private:
+   /// result of processing an auth request
+   struct AuthResponse;
+
    /// called when auth request message is received
    void OnMessageAuthRequest(RawMessage& msg);
+
+   /// looks up account and calculates server values; may run on a worker thread
+   std::shared_ptr<AuthResponse> CalcAuthResponse(const CString& cszUsername,
+      const std::vector<unsigned char>& vecA) const;
+
+   /// calculates auth response on worker thread and sends it on the session's thread
+   void AsyncCalcAuthResponse(const CString& cszUsername, const std::vector<unsigned char>& vecA);
+
+   /// stores auth response and sends it to the client
+   void SendAuthResponse(const AuthResponse& response);
+
    /// called when verify client message is received
    void OnMessageVerifyClient(RawMessage& rawMessage);
 
 private:
-   /// callback function to get auth info
+   /// callback function to get auth info; must be callable from worker threads
    T_fnGetServerAuthInfo m_fnGetServerAuthInfo;
 
+   /// worker pool to authenticate on; may be null
+   ThreadPool* m_pWorkerPool;
+
+   /// indicates that an auth request is being processed on the worker pool
+   bool m_bAuthRequestPending;
+
    /// flag if client is already verified
    bool m_bIsVerifiedClient;
 
@@ -10,6 +10,7 @@
 #include "ServerController.hpp"
 #include "ServerModel.hpp"
 #include "RawMessage.hpp"
+#include "SpanStream.hpp"
 #include "CommandMessage.hpp"
 #include "MovePlayerMessage.hpp"
 #include "Mobile.hpp"
@@ -67,7 +68,7 @@ bool ServerController::OnReceiveMessage(RawMessage& msg)
 void ServerController::OnMessageCommand(RawMessage& rawMsg)
 {
    CommandMessage msg;
-   ConstVectorRefStream stream(rawMsg.Data());
+   ConstMemoryRefStream stream(rawMsg.Data(), rawMsg.Size());
    msg.Deserialize(stream);
 
    Command& cmd = msg.GetCommand();
@@ -82,7 +83,7 @@ void ServerController::OnMessageCommand(RawMessage& rawMsg)
 void ServerController::OnMessageMovePlayer(RawMessage& rawMsg)
 {
    MovePlayerMessage msg;
-   ConstVectorRefStream stream(rawMsg.Data());
+   ConstMemoryRefStream stream(rawMsg.Data(), rawMsg.Size());
    msg.Deserialize(stream);
 
    this->MovePlayer(msg.Info());
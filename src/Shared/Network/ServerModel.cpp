@@ -30,14 +30,12 @@ void ServerModel::InitialUpdate(MobilePtr spPlayer)
    {
       ObjectId playerId = spPlayer->Id();
 
-      ObjectMap::T_mapObjects objMap = m_objectMap.GetMap();
-
       std::vector<ObjectPtr> vecObjectsToAdd;
-      ObjectMap::T_mapObjects::const_iterator iter = objMap.begin(), stop = objMap.end();
+      ObjectMap::const_iterator iter = m_objectMap.begin(), stop = m_objectMap.end();
       for (; iter != stop; ++iter)
       {
-         if (iter->first != playerId)
-            vecObjectsToAdd.push_back(iter->second);
+         if ((*iter)->Id() != playerId)
+            vecObjectsToAdd.push_back(*iter);
       }
 
       if (!vecObjectsToAdd.empty())
@@ -135,7 +133,7 @@ void ServerModel::QueueAction(ActionPtr spAction)
    // resolve argument
    ObjectRef& ref = spAction->ArgumentRef();
    if (ref.m_sp == NULL)
-      ref.m_sp = m_objectMap.FindObject(ref.m_id).m_sp;
+      ref.m_sp = m_objectMap.Get(ref.m_id);
 
    spAction->Do(*this);
 }
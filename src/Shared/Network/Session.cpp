@@ -18,6 +18,18 @@
 #include <ulib/Exception.hpp>
 #include <boost/bind.hpp>
 
+/// returns number of messages in serialized buffer; a buffer may contain more than one message
+static unsigned int CountMessages(const std::vector<unsigned char>& vecData)
+{
+   unsigned int uiNumMessages = 0;
+
+   // see SerializeMessage(); a message has a 4 byte header with message id and length
+   for (size_t uiPos = 0; uiPos + 4 <= vecData.size(); uiNumMessages++)
+      uiPos += 4 + (vecData[uiPos + 2] | (vecData[uiPos + 3] << 8));
+
+   return uiNumMessages;
+}
+
 Session::~Session()
 {
    Close();
@@ -40,13 +52,7 @@ void Session::Start()
    }
 #endif
 
-   SharedMutableBuffer buffer(1024);
-
-   m_socket.async_read_some(buffer,
-      boost::bind(&Session::HandleRead, shared_from_this(),
-         boost::asio::placeholders::error,
-         buffer,
-         boost::asio::placeholders::bytes_transferred));
+   StartRead();
 }
 
 void Session::Close()
@@ -58,6 +64,11 @@ void Session::Close()
 }
 
 void Session::SendMessage(const Message& msg)
+{
+   SendBuffer(SerializeMessage(msg));
+}
+
+SharedConstBuffer Session::SerializeMessage(const Message& msg)
 {
    // serialize message
    VectorStream s;
@@ -65,67 +76,151 @@ void Session::SendMessage(const Message& msg)
    s.Write16(0); // write size 0 here, since we don't know yet
    msg.Serialize(s);
 
-   if (s.Size() - 4 > static_cast<size_t>(std::numeric_limits<unsigned short>::max()))
+   size_t uiLength = s.Size() - 4;
+   if (uiLength > static_cast<size_t>(std::numeric_limits<unsigned short>::max()))
       throw Exception(_T("Session: size too short to send"), __FILE__, __LINE__);
 
    // add length
-   {
-      VectorStream strLength;
-      strLength.Write16(static_cast<unsigned short>(s.Size() - 4));
+   std::vector<unsigned char>& vecData = s.Data();
+   vecData[2] = static_cast<unsigned char>(uiLength & 0x00ff); // low byte
+   vecData[3] = static_cast<unsigned char>((uiLength >> 8) & 0x00ff); // high byte
 
-      std::copy(strLength.Data().begin(), strLength.Data().end(), s.Data().begin()+2);
-   }
+   return SharedConstBuffer(std::move(vecData));
+}
 
-   SharedConstBuffer buffer(s.Data().begin(), s.Data().end());
+void Session::SendBuffer(const SharedConstBuffer& buffer)
+{
+   if (m_bClosing)
+      return; // session is closing
 
-   // when an encryption module is set, call it
-   if (m_spEncryptModule != NULL)
-      m_spEncryptModule->EncryptWrite(buffer.Data().begin(), buffer.Data().end());
+   size_t uiSize = buffer.Data().size();
+   size_t uiQueuedBytes = m_uiQueuedBytes.fetch_add(uiSize) + uiSize;
 
-   // try sending buffer
+   if (m_uiSendHardLimit != 0 && uiQueuedBytes > m_uiSendHardLimit)
    {
-      boost::recursive_mutex::scoped_lock lock(m_mtxWriteQueue);
-
-      bool bWriteInProgress = !m_deqWriteQueue.empty();
-      m_deqWriteQueue.push_back(buffer);
+      m_uiQueuedBytes -= uiSize;
 
-      if (!bWriteInProgress)
+      // the client doesn't receive fast enough; close the session, only once
+      if (!m_bClosing.exchange(true))
       {
-         /// add message to queue; will be sent on next HandleWrite call
-         boost::asio::async_write(m_socket, m_deqWriteQueue.front(),
-            boost::bind(&Session::HandleWrite, shared_from_this(), boost::asio::placeholders::error));
+         CString cszText;
+         cszText.Format(_T("Session closing; send queue exceeded hard limit of %u bytes"),
+            static_cast<unsigned int>(m_uiSendHardLimit));
+         LOG_WARN(cszText, Log::Session);
+
+         m_ioService.post(boost::bind(&Session::Close, shared_from_this()));
       }
+
+      return;
    }
+
+   // the encryption module is taken when the buffer is queued, not when it's
+   // written, so that messages sent before the module is set go out unencrypted
+   m_writeQueue.Push(QueuedBuffer(buffer, m_pEncryptModule.load(std::memory_order_acquire)));
+
+   // when no write is in progress, start one on the session's io service; the
+   // flag is only reset by StartWrite() when it found the queue empty, or when a write failed
+   if (!m_bWriteInProgress.exchange(true))
+      m_ioService.post(boost::bind(&Session::StartWrite, shared_from_this()));
 }
 
-void Session::HandleRead(const boost::system::error_code& error, SharedMutableBuffer recvBuffer, size_t uiBytesTransferred)
+/// \details Takes all buffers that were queued since the last write and sends
+/// them using a single scatter/gather write. Only one write is in progress at
+/// any time, so buffers are sent in the order of SendBuffer() calls.
+void Session::StartWrite()
 {
-   if (!error)
+   m_vecQueuedBuffers.clear();
+   m_writeQueue.PopAll(m_vecQueuedBuffers);
+
+   // buffers queued just before the session started closing are dropped
+   if (m_bClosing)
    {
-      // must be at least 4 bytes long
-      if (uiBytesTransferred < 4)
+      std::for_each(m_vecQueuedBuffers.begin(), m_vecQueuedBuffers.end(), [&](const QueuedBuffer& queuedBuffer)
       {
-         LOG_ERROR(_T("Session received too few bytes for complete message"), Log::Session);
+         m_uiQueuedBytes -= queuedBuffer.m_buffer.Data().size();
+      });
 
-         OnConnectionClosing();
-         return; // note: with this return, the session is closed
+      m_vecQueuedBuffers.clear();
+      m_bWriteInProgress = false;
+      return;
+   }
+
+   if (m_vecQueuedBuffers.empty())
+   {
+      m_bWriteInProgress = false;
+
+      // a buffer may have been pushed after the queue was checked, but before
+      // the flag was reset; in that case, continue writing
+      if (m_writeQueue.IsEmpty() || m_bWriteInProgress.exchange(true))
+         return;
+
+      m_writeQueue.PopAll(m_vecQueuedBuffers);
+   }
+
+   m_vecWriteBuffers.clear();
+   m_uiWriteBytes = 0;
+   m_uiWriteMessages = 0;
+
+   // when a buffer was queued with an encryption module, encrypt a copy of the
+   // buffer, since the same buffer may be sent to other sessions, too; this
+   // must be done in the order the buffers are sent
+   std::for_each(m_vecQueuedBuffers.begin(), m_vecQueuedBuffers.end(), [&](const QueuedBuffer& queuedBuffer)
+   {
+      const SharedConstBuffer& buffer = queuedBuffer.m_buffer;
+
+      m_uiWriteBytes += buffer.Data().size();
+      m_uiWriteMessages += CountMessages(buffer.Data());
+
+      if (queuedBuffer.m_pEncryptModule != NULL)
+      {
+         SharedConstBuffer encryptedBuffer(buffer.Data().begin(), buffer.Data().end());
+         queuedBuffer.m_pEncryptModule->EncryptWrite(encryptedBuffer.Data().begin(), encryptedBuffer.Data().end());
+
+         m_vecWriteBuffers.push_back(encryptedBuffer);
       }
+      else
+         m_vecWriteBuffers.push_back(buffer);
+   });
+
+   m_vecQueuedBuffers.clear();
 
-      // when an encryption module is set, call it
+   std::vector<boost::asio::const_buffer> vecBuffers;
+   vecBuffers.reserve(m_vecWriteBuffers.size());
+
+   std::for_each(m_vecWriteBuffers.begin(), m_vecWriteBuffers.end(), [&](const SharedConstBuffer& buffer)
+   {
+      vecBuffers.push_back(*buffer.begin());
+   });
+
+   boost::asio::async_write(m_socket, vecBuffers,
+      boost::bind(&Session::HandleWrite, shared_from_this(), boost::asio::placeholders::error));
+}
+
+void Session::StartRead()
+{
+   // note: there's only one read operation at a time, so the receive buffer
+   // doesn't need to be protected
+   m_socket.async_read_some(m_receiveBuffer.PrepareRead(),
+      boost::bind(&Session::HandleRead, shared_from_this(),
+         boost::asio::placeholders::error,
+         boost::asio::placeholders::bytes_transferred));
+}
+
+void Session::HandleRead(const boost::system::error_code& error, size_t uiBytesTransferred)
+{
+   if (!error)
+   {
+      // when an encryption module is set, call it; only decrypt newly received bytes
       if (m_spEncryptModule != NULL)
-         m_spEncryptModule->DecryptRead(recvBuffer.Data().begin(), recvBuffer.Data().begin() + uiBytesTransferred);
+         m_spEncryptModule->DecryptRead(m_receiveBuffer.ReadBegin(), m_receiveBuffer.ReadBegin() + uiBytesTransferred);
 
-      if (!ProcessMessageBuffer(recvBuffer.Data(), uiBytesTransferred))
-         return; // close session
+      m_receiveBuffer.Commit(uiBytesTransferred);
 
-      // set up new read handler, using new buffer
-      SharedMutableBuffer buffer(1024);
+      if (!ProcessMessageBuffer())
+         return; // close session
 
-      m_socket.async_read_some(buffer,
-         boost::bind(&Session::HandleRead, shared_from_this(),
-            boost::asio::placeholders::error,
-            buffer,
-            boost::asio::placeholders::bytes_transferred));
+      // set up new read handler; incomplete messages stay in the receive buffer
+      StartRead();
    }
    else
    {
@@ -153,27 +248,17 @@ void Session::HandleRead(const boost::system::error_code& error, SharedMutableBu
    }
 }
 
-bool Session::ProcessMessageBuffer(const std::vector<unsigned char>& vecRecvBuffer, size_t uiBytesTransferred)
+bool Session::ProcessMessageBuffer()
 {
-   // try to read messages
-   ConstVectorRefStream inStream(vecRecvBuffer);
+   // loop to read all complete messages
+   unsigned short usMessageId = 0;
+   const unsigned char* pData = NULL;
+   unsigned short usLength = 0;
 
-   // loop to read all messages
-   size_t uiOffset = 0;
-   do
+   while (m_receiveBuffer.NextMessage(usMessageId, pData, usLength))
    {
-      unsigned short usMessageId = inStream.Read16();
-      unsigned short usLength = inStream.Read16();
-      if (static_cast<size_t>(usLength) + 4 > uiBytesTransferred)
-      {
-         LOG_ERROR(_T("Session received incomplete message"), Log::Session);
-         return false; // note: with this return, the session is closed
-      }
-
-      uiBytesTransferred -= static_cast<size_t>(usLength) + 4;
-
-      // deserialize message
-      RawMessage rawMessage(usMessageId, &vecRecvBuffer[uiOffset + 4], usLength);
+      // message only references the receive buffer; it's valid until the next read
+      RawMessage rawMessage(usMessageId, pData, usLength, RawMessage::dataReference);
 
       try
       {
@@ -204,10 +289,7 @@ bool Session::ProcessMessageBuffer(const std::vector<unsigned char>& vecRecvBuff
          OnConnectionClosing();
          return false;
       }
-
-      uiOffset += usLength + 4;
-
-   } while(uiBytesTransferred > 0);
+   }
 
    return true;
 }
@@ -216,16 +298,13 @@ void Session::HandleWrite(const boost::system::error_code& error)
 {
    if (!error)
    {
-      boost::recursive_mutex::scoped_lock lock(m_mtxWriteQueue);
+      m_uiQueuedBytes -= m_uiWriteBytes;
 
-      m_deqWriteQueue.pop_front();
-      if (!m_deqWriteQueue.empty())
-      {
-         // as queue is still filled, send another write request
-         // this ensures that packets are sent in order of SendMessage() calls
-         boost::asio::async_write(m_socket, m_deqWriteQueue.front(),
-            boost::bind(&Session::HandleWrite, shared_from_this(), boost::asio::placeholders::error));
-      }
+      m_uiBytesSent += static_cast<unsigned int>(m_uiWriteBytes);
+      m_uiMessagesSent += m_uiWriteMessages;
+
+      // send all buffers that were queued during the last write
+      StartWrite();
    }
    else
    {
@@ -241,6 +320,13 @@ void Session::HandleWrite(const boost::system::error_code& error)
          LOG_INFO(cszMessage, Log::Session);
       }
 
+      // the socket is broken; mark the session as closing, so that no more
+      // buffers are queued and no more writes are started
+      m_bClosing = true;
+
+      m_uiQueuedBytes -= m_uiWriteBytes;
+      m_bWriteInProgress = false;
+
       OnConnectionClosing();
 
       // just don't register any async operation here, and the session goes out of scope
@@ -261,6 +347,10 @@ CString Session::GetSessionLogCategory(const CString& cszBaseLogCategory)
 void Session::SetEncryptModule(std::shared_ptr<IEncryptModule> spEncryptModule)
 {
    ATLASSERT(spEncryptModule != NULL);
+   ATLASSERT(m_spEncryptModule == NULL); // queued buffers may still use the module
 
    m_spEncryptModule = spEncryptModule;
+
+   // publish after the module is set; SendBuffer() only stores the pointer
+   m_pEncryptModule.store(m_spEncryptModule.get(), std::memory_order_release);
 }
@@ -8,10 +8,11 @@
 
 // includes
 #include "Network.hpp"
-#include <boost/thread/recursive_mutex.hpp>
 #include "SharedBuffer.hpp"
+#include "ReceiveBuffer.hpp"
 #include "ISession.hpp"
-#include <deque>
+#include "MpscQueue.hpp"
+#include <atomic>
 #include <vector>
 
 // forward references
@@ -26,7 +27,18 @@ class NETWORK_DECLSPEC Session:
 public:
    /// ctor
    Session(boost::asio::io_service& ioService)
-      :m_socket(ioService)
+      :m_ioService(ioService),
+       m_socket(ioService),
+       m_pEncryptModule(nullptr),
+       m_uiSendHighWaterMark(0),
+       m_uiSendHardLimit(0),
+       m_uiQueuedBytes(0),
+       m_bClosing(false),
+       m_bWriteInProgress(false),
+       m_uiWriteBytes(0),
+       m_uiWriteMessages(0),
+       m_uiBytesSent(0),
+       m_uiMessagesSent(0)
    {
    }
 
@@ -50,11 +62,58 @@ public:
    /// sends message to recipient
    virtual void SendMessage(const Message& msg) override;
 
+   /// \brief serializes message to a buffer that can be sent using SendBuffer()
+   /// \details Use this when sending the same message to many sessions, in
+   /// order to serialize the message only once.
+   static SharedConstBuffer SerializeMessage(const Message& msg);
+
+   /// \brief sends already serialized message; the buffer is not modified; may be called from any thread
+   /// \details When the send hard limit would be exceeded, the buffer is
+   /// dropped and the session is closed. Buffers sent after the session
+   /// started closing are dropped.
+   virtual void SendBuffer(const SharedConstBuffer& buffer);
+
+   /// \brief sets limits for bytes queued for sending; 0 means no limit
+   /// \details Above the high-water mark, senders should postpone or coalesce
+   /// low-priority updates; see IsSendQueueAboveHighWaterMark(). Above the
+   /// hard limit, the session is closed. Call before starting the session.
+   void SetSendLimits(size_t uiHighWaterMark, size_t uiHardLimit)
+   {
+      m_uiSendHighWaterMark = uiHighWaterMark;
+      m_uiSendHardLimit = uiHardLimit;
+   }
+
+   /// returns number of bytes queued for sending that weren't sent yet
+   size_t QueuedBytes() const
+   {
+      return m_uiQueuedBytes;
+   }
+
+   /// returns if queued bytes exceed the send high-water mark
+   bool IsSendQueueAboveHighWaterMark() const
+   {
+      return m_uiSendHighWaterMark != 0 && m_uiQueuedBytes > m_uiSendHighWaterMark;
+   }
+
+   /// returns number of bytes sent since last call, and resets the count
+   unsigned int TakeBytesSent()
+   {
+      return m_uiBytesSent.exchange(0);
+   }
+
+   /// returns number of messages sent since last call, and resets the count
+   unsigned int TakeMessagesSent()
+   {
+      return m_uiMessagesSent.exchange(0);
+   }
+
 protected:
-   /// processes incoming message buffer
-   bool ProcessMessageBuffer(const std::vector<unsigned char>& vecRecvBuffer, size_t uiBytesTransferred);
+   /// processes all complete messages in receive buffer
+   bool ProcessMessageBuffer();
 
-   /// called when receiving message
+   /// \brief called when receiving message
+   /// \details the message references the receive buffer and is only valid
+   /// during the call; copy the message to keep it.
    virtual bool OnReceiveMessage(RawMessage& msg) = 0;
 
    /// called when connection is about to be closed
@@ -63,26 +122,96 @@ protected:
    /// returns log category for session
    CString GetSessionLogCategory(const CString& cszBaseLogCategory);
 
-   /// sets encryption module
+   /// sets encryption module; may only be set once, on the session's io service
    void SetEncryptModule(std::shared_ptr<IEncryptModule> spEncryptModule);
 
+   /// returns io service the session runs on; all handlers are called on its thread
+   boost::asio::io_service& IoService()
+   {
+      return m_ioService;
+   }
+
 private:
+   /// starts writing all queued buffers, when there are any; runs on the session's io service
+   void StartWrite();
+
+   /// starts reading into receive buffer
+   void StartRead();
+
    /// called when a read command was completed
-   void HandleRead(const boost::system::error_code& error, SharedMutableBuffer recvBuffer, size_t uiBytesTransferred);
+   void HandleRead(const boost::system::error_code& error, size_t uiBytesTransferred);
 
    /// called when a write command was completed
    void HandleWrite(const boost::system::error_code& error);
 
 private:
+   /// io service the session runs on
+   boost::asio::io_service& m_ioService;
+
    /// session socket
    boost::asio::ip::tcp::socket m_socket;
 
-   /// encryption module
+   /// encryption module; only set and used on the session's io service
    std::shared_ptr<IEncryptModule> m_spEncryptModule;
 
-   /// mutex to protect m_deqWriteQueue access
-   boost::recursive_mutex m_mtxWriteQueue;
+   /// encryption module, as published for SendBuffer() calls from any thread;
+   /// owned by m_spEncryptModule, which is never reset
+   std::atomic<IEncryptModule*> m_pEncryptModule;
+
+   /// receive buffer; reassembles messages split across reads
+   ReceiveBuffer m_receiveBuffer;
+
+   /// high-water mark for queued bytes; 0 means no limit
+   size_t m_uiSendHighWaterMark;
+
+   /// hard limit for queued bytes; 0 means no limit
+   size_t m_uiSendHardLimit;
+
+   /// number of bytes queued, including the write in progress
+   std::atomic<size_t> m_uiQueuedBytes;
+
+   /// indicates if the session is closing, since the hard limit was exceeded or
+   /// a write failed; no more buffers are queued or written then
+   std::atomic<bool> m_bClosing;
+
+   /// buffer in write queue
+   struct QueuedBuffer
+   {
+      /// ctor
+      QueuedBuffer(const SharedConstBuffer& buffer, IEncryptModule* pEncryptModule)
+         :m_buffer(buffer),
+          m_pEncryptModule(pEncryptModule)
+      {
+      }
+
+      /// buffer to send
+      SharedConstBuffer m_buffer;
+
+      /// encryption module that was set when the buffer was queued; null when not encrypted
+      IEncryptModule* m_pEncryptModule;
+   };
+
+   /// write queue; filled by SendBuffer() from any thread
+   MpscQueue<QueuedBuffer> m_writeQueue;
+
+   /// queued buffers taken from the write queue by StartWrite()
+   std::vector<QueuedBuffer> m_vecQueuedBuffers;
+
+   /// indicates if a write is in progress or posted; only then buffers are taken from the queue
+   std::atomic<bool> m_bWriteInProgress;
+
+   /// buffers of the write in progress; must be kept alive until HandleWrite() is called
+   std::vector<SharedConstBuffer> m_vecWriteBuffers;
+
+   /// number of bytes of the write in progress
+   size_t m_uiWriteBytes;
+
+   /// number of messages of the write in progress
+   unsigned int m_uiWriteMessages;
+
+   /// number of bytes sent since last TakeBytesSent() call
+   std::atomic<unsigned int> m_uiBytesSent;
 
-   /// write queue
-   std::deque<SharedConstBuffer> m_deqWriteQueue;
+   /// number of messages sent since last TakeMessagesSent() call
+   std::atomic<unsigned int> m_uiMessagesSent;
 };
@@ -24,9 +24,19 @@ public:
    {
    }
 
+   /// construct by taking over the given vector
+   explicit SharedConstBuffer(std::vector<unsigned char>&& vecData)
+      :m_spData(new std::vector<unsigned char>(std::move(vecData))),
+       m_buffer(boost::asio::buffer(*m_spData))
+   {
+   }
+
    /// returns data
    std::vector<unsigned char>& Data(){ return *m_spData; }
 
+   /// returns data; const version
+   const std::vector<unsigned char>& Data() const { return *m_spData; }
+
    // implement the ConstBufferSequence requirements
    typedef boost::asio::const_buffer value_type;                           ///< buffer value type
    typedef const boost::asio::const_buffer* const_iterator;                ///< const interator type
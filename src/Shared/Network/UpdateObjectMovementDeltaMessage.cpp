@@ -0,0 +1,52 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file UpdateObjectMovementDeltaMessage.cpp Object movement update message, delta compressed
+//
+
+// includes
+#include "StdAfx.h"
+#include "UpdateObjectMovementDeltaMessage.hpp"
+#include "ByteStream.hpp"
+#include "BitStream.hpp"
+
+UpdateObjectMovementDeltaMessage::UpdateObjectMovementDeltaMessage(const ObjectId& objId,
+   const MovementSnapshot& snapshot, const MovementSnapshot& baseline)
+:Message(msgUpdateObjectMovementDelta),
+ m_objId(objId)
+{
+   BitWriter writer(m_vecDeltaData);
+   snapshot.WriteDelta(writer, baseline);
+
+   ATLASSERT(m_vecDeltaData.size() <= 0xff);
+}
+
+MovementSnapshot UpdateObjectMovementDeltaMessage::Snapshot(const MovementSnapshot& baseline) const
+{
+   BitReader reader(m_vecDeltaData.data(), m_vecDeltaData.size());
+
+   MovementSnapshot snapshot;
+   snapshot.ReadDelta(reader, baseline);
+
+   return snapshot;
+}
+
+void UpdateObjectMovementDeltaMessage::Serialize(ByteStream& stream) const
+{
+   stream.WriteUuid(m_objId);
+
+   stream.Write8(static_cast<unsigned char>(m_vecDeltaData.size()));
+   stream.WriteBlock(m_vecDeltaData);
+}
+
+void UpdateObjectMovementDeltaMessage::Deserialize(ByteStream& stream)
+{
+   m_objId = stream.ReadUuid();
+
+   unsigned char ucSize = stream.Read8();
+   if (ucSize == 0)
+      throw Exception(_T("invalid movement delta size"), __FILE__, __LINE__);
+
+   stream.ReadBlock(m_vecDeltaData, ucSize);
+}
@@ -0,0 +1,57 @@
+//
+// MultiplayerOnlineGame - multiplayer game project
+// Copyright (C) 2008-2014 Michael Fink
+//
+/// \file UpdateObjectMovementDeltaMessage.hpp Message to update object movement, delta compressed
+//
+#pragma once
+
+// includes
+#include "Network.hpp"
+#include "Message.hpp"
+#include "Object.hpp"
+#include "MovementSnapshot.hpp"
+#include <vector>
+
+/// \brief message for updating object movement info; sent to the client
+/// \details Contains only the fields of the movement snapshot that changed
+/// compared to the last snapshot that was sent to the same client, bit packed.
+class NETWORK_DECLSPEC UpdateObjectMovementDeltaMessage : public Message
+{
+public:
+   /// ctor; use for sending
+   UpdateObjectMovementDeltaMessage(const ObjectId& objId,
+      const MovementSnapshot& snapshot, const MovementSnapshot& baseline);
+
+   /// ctor; use for receiving
+   UpdateObjectMovementDeltaMessage()
+      :Message(msgUpdateObjectMovementDelta),
+       m_objId(ObjectId::Null())
+   {
+   }
+
+   /// dtor
+   virtual ~UpdateObjectMovementDeltaMessage() {}
+
+   // get methods
+
+   /// returns object id
+   const ObjectId& Id() const { return m_objId; }
+
+   /// returns movement snapshot, applying the delta to the given baseline
+   MovementSnapshot Snapshot(const MovementSnapshot& baseline) const;
+
+
+   /// serialize message by putting bytes to stream
+   virtual void Serialize(ByteStream& stream) const override;
+
+   /// deserialize message by reading bytes from stream
+   virtual void Deserialize(ByteStream& stream) override;
+
+private:
+   /// object id
+   ObjectId m_objId;
+
+   /// bit packed movement delta
+   std::vector<unsigned char> m_vecDeltaData;
+};
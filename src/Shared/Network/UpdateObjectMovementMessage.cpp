@@ -12,14 +12,10 @@
 
 void UpdateObjectMovementMessage::Serialize(ByteStream& stream) const
 {
-   stream.WriteUuid(m_objId);
-
-   m_movementInfo.Serialize(stream);
+   Serialize<ByteStream>(stream);
 }
 
 void UpdateObjectMovementMessage::Deserialize(ByteStream& stream)
 {
-   m_objId = stream.ReadUuid();
-
-   m_movementInfo.Deserialize(stream);
+   Deserialize<ByteStream>(stream);
 }
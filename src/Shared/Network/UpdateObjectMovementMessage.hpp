@@ -49,6 +49,24 @@ public:
    /// deserialize message by reading bytes from stream
    virtual void Deserialize(ByteStream& stream) override;
 
+   /// serialize message by putting bytes to stream of given type; see MovementInfo::Serialize()
+   template <typename TStream>
+   void Serialize(TStream& stream) const
+   {
+      stream.WriteUuid(m_objId);
+
+      m_movementInfo.Serialize(stream);
+   }
+
+   /// deserialize message by reading bytes from stream of given type
+   template <typename TStream>
+   void Deserialize(TStream& stream)
+   {
+      m_objId = stream.ReadUuid();
+
+      m_movementInfo.Deserialize(stream);
+   }
+
 private:
    /// object id
    ObjectId m_objId;
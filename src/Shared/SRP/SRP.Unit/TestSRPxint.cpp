@@ -11,6 +11,7 @@
 #include "SRPClient.hpp"
 #include "SRPHelper.hpp"
 //#include "HighResolutionTimer.hpp"
+#include <chrono>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace SRP;
@@ -557,6 +558,64 @@ public:
       }
    }
 
+   /// tests that PowMod() gives the same results as boost::xint::powmod() for all preset groups
+   TEST_METHOD(TestPowMod)
+   {
+      boost::xint::default_random_generator rg;
+
+      for (unsigned int uiIndex = 0; uiIndex < Helper::GetMaxCountPresetGroupParameter(); uiIndex++)
+      {
+         GroupParameter gp = Helper::GetPresetGroupParameter(uiIndex);
+
+         for (unsigned int i = 0; i < 10; i++)
+         {
+            BigInteger base = BigInteger::random_by_size(rg, gp.uiNumBits, false, false, false) % gp.N;
+            BigInteger exp = BigInteger::random_by_size(rg, i % 2 == 0 ? 256 : gp.uiNumBits, false, false, false);
+
+            Assert::IsTrue(boost::xint::powmod(base, exp, gp.N) == Helper::PowMod(base, exp, gp.N));
+         }
+
+         // edge cases
+         Assert::IsTrue(Helper::PowMod(gp.g, 0, gp.N) == 1);
+         Assert::IsTrue(Helper::PowMod(0, 5, gp.N) == 0);
+         Assert::IsTrue(Helper::PowMod(gp.N - 1, 2, gp.N) == 1);
+      }
+   }
+
+   /// measures number of complete client/server handshakes per second
+   TEST_METHOD(TestHandshakesPerSecond)
+   {
+      GroupParameter gp = Helper::GetPresetGroupParameter(c_uiPresetIndex);
+
+      std::string strUsername(c_pszaUsername);
+      std::string strPassword(c_pszaPassword);
+
+      const unsigned int c_uiNumHandshakes = 20;
+
+      std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+      for (unsigned int i = 0; i < c_uiNumHandshakes; i++)
+      {
+         Client client(gp);
+         Server server(gp);
+
+         TestClient tc(client);
+         tc.EnableRandom(true);
+
+         TestServer ts(server, strUsername, strPassword);
+         ts.EnableRandom(true);
+
+         tc.SendMessage1(ts, strUsername, strPassword);
+      }
+
+      double dElapsed = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+      CString cszText;
+      cszText.Format(_T("SRP %u-bit group: %.1f handshakes per second\n"),
+         gp.uiNumBits, c_uiNumHandshakes / dElapsed);
+      Logger::WriteMessage(cszText);
+   }
+
    /// test function to generate password verifier; doesn't contain test
 #if 0
    // note that this test would need HighResolutionTimer and so would link to Base.dll, but
@@ -17,7 +17,7 @@ const BigInteger& Client::GetA(const BigInteger& a)
    m_a = a;
 
    // A = g^a % N
-   m_A = boost::xint::powmod(m_gp.g, a, m_gp.N);
+   m_A = Helper::PowMod(m_gp.g, a, m_gp.N);
 
    return m_A;
 }
@@ -53,13 +53,13 @@ const BinaryData& Client::CalcM(const std::string& strUsername, const std::strin
    {
       BigInteger k = Helper::CalcLowerK(m_gp);
 
-      BigInteger v = boost::xint::powmod(m_gp.g, x, m_gp.N);
+      BigInteger v = Helper::PowMod(m_gp.g, x, m_gp.N);
       BigInteger temp1 = (- k * v) % m_gp.N;
       temp1 = B + temp1;
 
       BigInteger temp2 = m_a + (u * x);
 
-      S = boost::xint::powmod(temp1, temp2, m_gp.N);
+      S = Helper::PowMod(temp1, temp2, m_gp.N);
    }
 
    // K = H(S)
@@ -8,11 +8,41 @@
 // includes
 #include "stdafx.h"
 #include "SRPHelper.hpp"
+#include "SRPMontgomery.hpp"
+#include <mutex>
 
 using namespace SRP;
 
+/// calculates base^exp % N using Montgomery exponentiation with given number of bits
+template <unsigned int t_uiNumBits>
+static BigInteger MontgomeryPowMod(const BigInteger& base, const BigInteger& exp, const BigInteger& N)
+{
+   return Montgomery<t_uiNumBits>(N).PowMod(base, exp);
+}
+
+BigInteger Helper::PowMod(const BigInteger& base, const BigInteger& exp, const BigInteger& N)
+{
+   // Montgomery multiplication needs an odd modulus, and a base in the range [0; N)
+   if (N.is_even() || base.sign() < 0 || base >= N || exp.sign() < 0)
+      return boost::xint::powmod(base, exp, N);
+
+   // modulus must have exactly the number of bits of the fixed-width type
+   switch (boost::xint::integer_log2(N))
+   {
+   case 1024: return MontgomeryPowMod<1024>(base, exp, N);
+   case 1536: return MontgomeryPowMod<1536>(base, exp, N);
+   case 2048: return MontgomeryPowMod<2048>(base, exp, N);
+   default:
+      return boost::xint::powmod(base, exp, N);
+   }
+}
+
 BigInteger Helper::GenerateRandomBits(unsigned int uiNumBits)
 {
+   // may be called from more than one thread, e.g. from the server's auth worker threads
+   static std::mutex s_mtxRandomGenerator;
+   std::lock_guard<std::mutex> lock(s_mtxRandomGenerator);
+
    static boost::xint::strong_random_generator srg;
    return boost::xint::integer::random_by_size(srg,
       uiNumBits,
@@ -31,7 +61,7 @@ BigInteger Helper::GeneratePassword(
    BigInteger x = Helper::CalcLowerX(strUsername, strPassword, s);
 
    // v = g^x % N
-   return boost::xint::powmod(gp.g, x, gp.N);
+   return Helper::PowMod(gp.g, x, gp.N);
 }
 
 BigInteger Helper::CalcLowerX(const std::string& strUsername, const std::string& strPassword,
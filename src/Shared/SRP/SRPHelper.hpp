@@ -73,6 +73,11 @@ namespace Helper
          0 == memcmp(&data1[0], &data2[0], data1.size());
    }
 
+   /// \brief calculates base^exp % N
+   /// \details Uses fixed-width Montgomery exponentiation when N has the size of
+   /// one of the preset group parameters, and boost::xint::powmod() otherwise.
+   BigInteger PowMod(const BigInteger& base, const BigInteger& exp, const BigInteger& N);
+
    /// generates random integer with given bit count
    BigInteger GenerateRandomBits(unsigned int uiNumBits);
 
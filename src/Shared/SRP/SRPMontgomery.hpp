@@ -0,0 +1,228 @@
+//
+// SRP xint - SRP implementation using boost::xint
+// Copyright (C) 2011-2014 Michael Fink
+//
+/// \file SRPMontgomery.hpp Fixed-width Montgomery modular exponentiation
+//
+#pragma once
+
+// includes
+#include "SRPCommon.hpp"
+#include <array>
+#include <cstdint>
+
+namespace SRP
+{
+
+/// \brief modular exponentiation with fixed-width integers, using Montgomery multiplication
+/// \details All values are stored in arrays of 32-bit limbs, with the lowest
+/// limb first; the number of limbs is fixed at compile time, so that all
+/// loops have a fixed trip count and no memory is allocated during the
+/// calculation. The modulus must be odd and have exactly t_uiNumBits bits.
+/// Exponentiation uses a sliding window over the exponent bits.
+/// \tparam t_uiNumBits number of bits of the modulus; must be a multiple of 32
+template <unsigned int t_uiNumBits>
+class Montgomery
+{
+public:
+   static_assert(t_uiNumBits % 32 == 0, "number of bits must be a multiple of 32");
+
+   /// number of limbs
+   static const unsigned int c_uiNumLimbs = t_uiNumBits / 32;
+
+   /// sliding window size, in bits
+   static const unsigned int c_uiWindowBits = 5;
+
+   /// fixed-width integer type
+   typedef std::array<uint32_t, c_uiNumLimbs> Limbs;
+
+   /// ctor; prepares constants for given modulus
+   explicit Montgomery(const BigInteger& N)
+   {
+      ATLASSERT(N.is_odd());
+
+      ToLimbs(N, m_N);
+
+      // Newton iteration for N^-1 mod 2^32; each step doubles the number of correct bits
+      uint32_t uiInverse = m_N[0];
+      for (unsigned int i = 0; i < 5; i++)
+         uiInverse *= 2 - m_N[0] * uiInverse;
+
+      m_uiNegInverse = 0 - uiInverse;
+
+      // R^2 mod N, with R = 2^t_uiNumBits; used to convert into Montgomery form
+      BigInteger R2 = (BigInteger(1) << (2 * t_uiNumBits)) % N;
+      ToLimbs(R2, m_R2);
+   }
+
+   /// calculates base^exp % N; base must be in the range [0; N)
+   BigInteger PowMod(const BigInteger& base, const BigInteger& exp) const
+   {
+      Limbs one = {};
+      one[0] = 1;
+
+      Limbs baseLimbs;
+      ToLimbs(base, baseLimbs);
+
+      // precompute odd powers base^1, base^3, ..., base^(2^w - 1), in Montgomery form
+      std::array<Limbs, 1 << (c_uiWindowBits - 1)> aOddPowers;
+      Multiply(baseLimbs, m_R2, aOddPowers[0]);
+
+      Limbs baseSquared;
+      Multiply(aOddPowers[0], aOddPowers[0], baseSquared);
+
+      for (size_t i = 1; i < aOddPowers.size(); i++)
+         Multiply(aOddPowers[i - 1], baseSquared, aOddPowers[i]);
+
+      // result starts with 1 in Montgomery form, which is R mod N
+      Limbs result;
+      Multiply(one, m_R2, result);
+
+      BinaryData expBytes = boost::xint::to_binary(exp);
+      int iBit = static_cast<int>(expBytes.size() * 8) - 1;
+
+      Limbs temp;
+      while (iBit >= 0)
+      {
+         if (!ExpBit(expBytes, iBit))
+         {
+            Multiply(result, result, temp);
+            result = temp;
+            iBit--;
+            continue;
+         }
+
+         // find longest window that ends with a set bit
+         int iWindowEnd = std::max(iBit - static_cast<int>(c_uiWindowBits) + 1, 0);
+         while (!ExpBit(expBytes, iWindowEnd))
+            iWindowEnd++;
+
+         unsigned int uiWindow = 0;
+         for (int i = iBit; i >= iWindowEnd; i--)
+         {
+            uiWindow = (uiWindow << 1) | (ExpBit(expBytes, i) ? 1 : 0);
+
+            Multiply(result, result, temp);
+            result = temp;
+         }
+
+         Multiply(result, aOddPowers[uiWindow >> 1], temp);
+         result = temp;
+
+         iBit = iWindowEnd - 1;
+      }
+
+      // convert back from Montgomery form
+      Multiply(result, one, temp);
+
+      return FromLimbs(temp);
+   }
+
+private:
+   /// returns bit of exponent; bytes are stored lowest byte first
+   static bool ExpBit(const BinaryData& expBytes, int iBit)
+   {
+      return ((expBytes[iBit / 8] >> (iBit % 8)) & 1) != 0;
+   }
+
+   /// converts integer to limbs; integer must fit into the limbs
+   static void ToLimbs(const BigInteger& n, Limbs& limbs)
+   {
+      BinaryData data = boost::xint::to_binary(n);
+      ATLASSERT(data.size() <= c_uiNumLimbs * 4);
+
+      limbs.fill(0);
+      for (size_t i = 0; i < data.size(); i++)
+         limbs[i / 4] |= static_cast<uint32_t>(data[i]) << (8 * (i % 4));
+   }
+
+   /// converts limbs to integer
+   static BigInteger FromLimbs(const Limbs& limbs)
+   {
+      BinaryData data(c_uiNumLimbs * 4);
+      for (size_t i = 0; i < data.size(); i++)
+         data[i] = static_cast<unsigned char>(limbs[i / 4] >> (8 * (i % 4)));
+
+      return BigInteger(data);
+   }
+
+   /// \brief calculates a * b * R^-1 mod N
+   /// \details uses the coarsely integrated operand scanning (CIOS) method
+   void Multiply(const Limbs& a, const Limbs& b, Limbs& result) const
+   {
+      uint32_t t[c_uiNumLimbs + 2] = {};
+
+      for (unsigned int i = 0; i < c_uiNumLimbs; i++)
+      {
+         // t += a * b[i]
+         uint64_t carry = 0;
+         for (unsigned int j = 0; j < c_uiNumLimbs; j++)
+         {
+            uint64_t sum = t[j] + static_cast<uint64_t>(a[j]) * b[i] + carry;
+            t[j] = static_cast<uint32_t>(sum);
+            carry = sum >> 32;
+         }
+
+         uint64_t sum = t[c_uiNumLimbs] + carry;
+         t[c_uiNumLimbs] = static_cast<uint32_t>(sum);
+         t[c_uiNumLimbs + 1] = static_cast<uint32_t>(sum >> 32);
+
+         // t = (t + m * N) / 2^32; m is chosen so that the lowest limb becomes 0
+         uint32_t m = t[0] * m_uiNegInverse;
+
+         sum = t[0] + static_cast<uint64_t>(m) * m_N[0];
+         carry = sum >> 32;
+
+         for (unsigned int j = 1; j < c_uiNumLimbs; j++)
+         {
+            sum = t[j] + static_cast<uint64_t>(m) * m_N[j] + carry;
+            t[j - 1] = static_cast<uint32_t>(sum);
+            carry = sum >> 32;
+         }
+
+         sum = t[c_uiNumLimbs] + carry;
+         t[c_uiNumLimbs - 1] = static_cast<uint32_t>(sum);
+         t[c_uiNumLimbs] = t[c_uiNumLimbs + 1] + static_cast<uint32_t>(sum >> 32);
+      }
+
+      // t is now less than 2 * N; subtract N once when t >= N
+      bool bSubtract = t[c_uiNumLimbs] != 0;
+      if (!bSubtract)
+      {
+         bSubtract = true; // t == N
+         for (int i = c_uiNumLimbs - 1; i >= 0; i--)
+         {
+            if (t[i] != m_N[i])
+            {
+               bSubtract = t[i] > m_N[i];
+               break;
+            }
+         }
+      }
+
+      if (bSubtract)
+      {
+         uint64_t borrow = 0;
+         for (unsigned int j = 0; j < c_uiNumLimbs; j++)
+         {
+            uint64_t diff = static_cast<uint64_t>(t[j]) - m_N[j] - borrow;
+            result[j] = static_cast<uint32_t>(diff);
+            borrow = (diff >> 32) & 1;
+         }
+      }
+      else
+         std::copy(t, t + c_uiNumLimbs, result.begin());
+   }
+
+private:
+   /// modulus
+   Limbs m_N;
+
+   /// R^2 mod N
+   Limbs m_R2;
+
+   /// -N^-1 mod 2^32
+   uint32_t m_uiNegInverse;
+};
+
+} // namespace SRP
@@ -39,7 +39,7 @@ const BigInteger& Server::GetB(const BigInteger& PassVerifier, const BigInteger&
    // formula in RFC: B = k*v + g^b % N
    // we actually want: B = ((k*v) % N) + ((g^b) % N) % N
    BigInteger temp1 = (k * PassVerifier) % m_gp.N;
-   BigInteger temp2 = boost::xint::powmod(m_gp.g, b, m_gp.N);
+   BigInteger temp2 = Helper::PowMod(m_gp.g, b, m_gp.N);
 
    //m_B = (temp1 + temp2) % m_gp.N;
    // the previous operation can also be written as:
@@ -71,7 +71,7 @@ void Server::CalcSessionKey(const BigInteger& A, const BigInteger& s, const std:
    // S = (t2 ^ b) % N
    BigInteger S;
    {
-      BigInteger temp1 = boost::xint::powmod(PassVerifier, u, m_gp.N);
+      BigInteger temp1 = Helper::PowMod(PassVerifier, u, m_gp.N);
       BigInteger temp2 = boost::xint::mulmod(A, temp1, m_gp.N);
 
       // reject t2 == {0, 1}
@@ -82,7 +82,7 @@ void Server::CalcSessionKey(const BigInteger& A, const BigInteger& s, const std:
       if (temp2 % m_gp.N == -1)
          throw std::runtime_error("A*v^u % N == -1");
 
-      S = boost::xint::powmod(temp2, m_b, m_gp.N);
+      S = Helper::PowMod(temp2, m_b, m_gp.N);
    }
 
    // calculate K